@@ -2,6 +2,9 @@
 #include <vector>
 #include "gb.h"
 #include "TGBDualRenderer.hpp"
+#include "movie.h"
+#include "../common/linkcable/include/link_scheduler.hpp"
+#include "../common/infrared/include/ir_async_link.hpp"
 #include <memory>
 
 
@@ -12,9 +15,30 @@ public:
 	TGBDualCore() = default;
 	~TGBDualCore() = default;  
     
-    std::vector<std::unique_ptr<gb>> gameboyInstances;
+    // not owned: the gbs live in instancePool's arenas and go away with it
+    std::vector<gb*> gameboyInstances;
     std::vector<std::unique_ptr<TGBDualRenderer>> gameboyRenderers;
 
+    // input movie recording/playback, begin_frame()/end_frame() wrap every run()
+    gb_movie movie;
+
+    // owns the gbs created in init() (v_gb), their hot state is contiguous;
+    // deinit() drops every pointer into it before releasing it
+    std::unique_ptr<gb_pool> instancePool;
+
+    // declared link wiring (cables, DMG-07s, IR, printer, bridge); run() gives
+    // every connected component its own thread, call rewireLinks() after changing it
+    link_topology linkTopology;
+    link_scheduler linkScheduler;
+    void rewireLinks();
+
+    // IR pairs whose ends run on their own threads, at most max_skew_cycles apart
+    std::vector<std::unique_ptr<ir_async_link>> asyncIrLinks;
+    void connectAsyncIr(int a, int b, int max_skew_cycles);
+    // rewireLinks() turns two instances that are only IR linked to each other into
+    // an ir_async_link with this skew; <= 0 keeps such pairs in lockstep
+    int asyncIrSkewCycles = 456 * 8;
+
     // Get the number of emulated systems
    int getActiveSystemsCount() override {
         return gameboyInstances.size();
@@ -50,7 +74,22 @@ public:
     // Run the core's main loop (e.g., for one frame)
     void run() override;
 
+    // reads the TGBDual core options (src/libretro/core_options.h)
+    void checkOptions(bool loading);
+
+    // a link-device hotkey (see I_dcgb_hotkey_target); applied at the next
+    // frame start through the movie, which records it. run() presses 0x10
+    // when L goes down on port 1.
+    void pressHotkey(int key);
+
 private:
+    void pollHotkeys();
+    void dispatchHotkey(int key);
+    // writes the recording to the save directory and stops it
+    void saveMovie();
+    bool hotkeyHeld = false;
+    bool addAsyncIr(int a, int b, int max_skew_cycles);
+
     const int kmaxGameboyInstancesCount_ = 16; // Maximum number of GameBoys supported by this core
 	ScreenSize screenSize_ = ScreenSize::GB; // Default screen size
 
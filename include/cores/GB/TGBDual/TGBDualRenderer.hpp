@@ -60,15 +60,15 @@ public:
 	 void refresh();
 	 byte get_time(int type);
 	 void set_time(int type, byte dat);
+	 void sync_time(dword now) override { clock.fixed_time = now; }
 
 
 	
-	dword fixed_time;
 private:
+	rtc_clock clock;
 	VideoRenderer& video_renderer = VideoRenderer::getInstance();
 	//ColorCorrectionManager& colorCorrectionManager = ColorCorrectionManager::getInstance();
 	int id_;
-	int cur_time;
 	int which_gb;
 	bool rgb565;
 
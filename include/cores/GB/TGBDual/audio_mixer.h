@@ -0,0 +1,68 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Multi instance audio mixer
+   Copyright (C) 2023  Tim Oelrichs
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#pragma once
+
+#include <cstdint>
+
+#define MIXER_MAX_PLAYERS 16
+#define MIXER_SAMPLE_RATE 44100
+#define MIXER_SAMPLES_PER_FRAME (MIXER_SAMPLE_RATE/60)
+
+// Gains are Q14: 1.0 == 16384
+#define MIXER_GAIN_BITS 14
+#define MIXER_GAIN_ONE (1 << MIXER_GAIN_BITS)
+
+// Sums the interleaved stereo output of several gb instances into one
+// stream. TGBDual's apu already synthesises at the host rate, so each
+// player is only scaled by a 2x2 gain matrix (gain, balance, dual mono)
+// and accumulated; there is no per-instance resampling to pay for.
+class audio_mixer
+{
+public:
+	audio_mixer();
+
+	void reset();
+
+	// pan: -1.0 hard left .. 1.0 hard right; mono folds L+R first
+	void set_player(int player, float gain, float pan, bool mono = false);
+	void mute_player(int player);
+	bool is_audible(int player) const { return audible[player]; }
+
+	// derives the per player matrices from the audio_2p_mode option:
+	// a player index plays that player only, anything else mixes everyone
+	// (two players are split into dual mono left/right)
+	void apply_mode(int mode, int players);
+
+	void add(int player, const int16_t* stream, int samples);
+	// writes the mix to out and clears the accumulators, returns samples written
+	int flush(int16_t* out, int samples);
+
+private:
+	int16_t matrix[MIXER_MAX_PLAYERS][4]; // LL RL LR RR
+	bool audible[MIXER_MAX_PLAYERS];
+	int32_t acc_l[MIXER_SAMPLES_PER_FRAME];
+	int32_t acc_r[MIXER_SAMPLES_PER_FRAME];
+	int applied_mode;
+	int applied_players;
+};
+
+extern audio_mixer gb_audio_mixer;
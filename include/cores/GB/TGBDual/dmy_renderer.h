@@ -34,6 +34,12 @@ constexpr std::array<uint32_t, 4> DMG_PALETTE = {
 
 constexpr int GRADIENT_STEPS = 64;
 extern std::array<uint16_t, GRADIENT_STEPS> blended_palette;
+// RGB565 pixel -> blended_palette index, so the ghosting pass is a table lookup per pixel
+extern std::array<uint8_t, 0x10000> blended_palette_index;
+
+// LCD を入れ直すと 1 回の run で 2 フレーム終わることがある
+// toggling the LCD can end two frames within one run of the instances
+#define DMY_PENDING_FRAMES 2
 
 enum class GhostingMode {
 	RGB565_BLEND,
@@ -56,9 +62,22 @@ public:
 	virtual word unmap_color(word gb_col);
 	virtual void add_gbc_interlacing_effect(byte* buf, int width, int height, int depth);
 	virtual int check_pad();
+	// refresh() と render_screen() はスケジューラのワーカーで呼ばれることがあるので、出力を貯めるだけ
+	// refresh() and render_screen() may run on a link_scheduler worker, they only keep the output
 	virtual void refresh();
 	virtual byte get_time(int type);
 	virtual void set_time(int type,byte dat);
+	virtual void sync_time(dword now) { clock.fixed_time=now; }
+	virtual bool frame_wanted();
+	// retro_run のスレッドで、インスタンスを走らせる前に呼ぶ。ランアヘッドで捨てられるフレームは描かない
+	// call once per retro_run on the frontend thread before any instance runs;
+	// frames the frontend throws away (run-ahead) are then not wanted, and the
+	// audio mode is applied to the mixer
+	static void begin_frame();
+	// 全インスタンスが走り終えてから番号順に呼ぶ: ミックス、画面合成、コールバック
+	// call on the frontend thread for every instance in order once they all ran:
+	// mixes, composes and calls the frontend, the last instance presents
+	virtual void flush_output();
 
 	float hue2rgb(float p, float q, float t) {
 		if (t < 0.0f) t += 1.0f;
@@ -187,6 +206,14 @@ public:
 
 			blended_palette[i] = rgb888_to_rgb565(r, g, b);
 		}
+
+		for (int pixel = 0; pixel < 0x10000; ++pixel) {
+			uint8_t r = ((pixel >> 11) & 0x1F) << 3;
+			uint8_t g = ((pixel >> 5) & 0x3F) << 2;
+			uint8_t b = (pixel & 0x1F) << 3;
+			uint8_t grayscale = static_cast<uint8_t>((0.299f * r) + (0.587f * g) + (0.114f * b));
+			blended_palette_index[pixel] = static_cast<uint8_t>((255 - grayscale) * (GRADIENT_STEPS - 1) / 255);
+		}
 	}
 
 	uint16_t blendPixels(uint16_t pixel1, uint16_t pixel2) {
@@ -209,30 +236,17 @@ public:
 		else {
 			// Blended Palette verwenden
 			// 16bit Pixel -> Grauwert -> blended_palette
-			uint8_t r = ((pixel1 >> 11) & 0x1F) << 3;
-			uint8_t g = ((pixel1 >> 5) & 0x3F) << 2;
-			uint8_t b = (pixel1 & 0x1F) << 3;
-			uint8_t grayscale1 = static_cast<uint8_t>((0.299f * r) + (0.587f * g) + (0.114f * b));
-
-			r = ((pixel2 >> 11) & 0x1F) << 3;
-			g = ((pixel2 >> 5) & 0x3F) << 2;
-			b = (pixel2 & 0x1F) << 3;
-			uint8_t grayscale2 = static_cast<uint8_t>((0.299f * r) + (0.587f * g) + (0.114f * b));
-
-			int index1 = (255 - grayscale1) * (GRADIENT_STEPS - 1) / 255;
-			int index2 = (255 - grayscale2) * (GRADIENT_STEPS - 1) / 255;
-
-			int blended_index = (index1 + index2) / 2;
-
+			int blended_index = (blended_palette_index[pixel1] + blended_palette_index[pixel2]) >> 1;
 			return blended_palette[blended_index];
 		}
 	}
 
+	// blends count pixels of frame against last into out and stores the unblended pixels in last
+	void blendFrame(const word* frame, word* out, word* last, int count);
+
 
-	dword fixed_time;
 private:
-	
-	int cur_time;
+	rtc_clock clock;
 	int which_gb;
 	bool rgb565;
 	byte is_odd_frame = 0;
@@ -240,6 +254,27 @@ private:
 	word last_frame[160*144];
 	word current_frame[160*144];
 
+	// 変化したラインの検出: 表示が変わったラインだけを後処理・合成し、全く変わらなければ前のフレームを使い回させる
+	// Per line change tracking: only lines whose output changed are post-processed and
+	// composited, and a frame without changes is sent to the frontend as a dupe
+	void track_lines(word* frame, int width, int height);
+	void copy_lines(byte* dst, int dst_pitch, const byte* src, int pitch, int height);
+	void present_frame(const void* data, unsigned width, unsigned height, size_t pitch);
+	void compose_screen(byte* buf, int width, int height, int depth);
+
+	byte line_age[144];   // 生の画素が最後に変わってから何フレームか // frames since the raw line last changed
+	bool line_dirty[144]; // 表示する内容が変わった // the presented line changed this frame
+	bool ghosting;
+	word ghost_frame[160*144];
+	int composed_layout;
+
+	// flush_output() を待つ出力 // output waiting for flush_output()
+	int16_t stream[(44100/60)*2*DMY_PENDING_FRAMES];
+	int pending_audio; // stream に入っているフレーム数 // frames held in stream
+	word pending_frame[160*144];
+	bool pending_screen;
+	int pending_width, pending_height, pending_depth;
+
 	GhostingMode ghosting_mode = GhostingMode::PALETTE_BLEND;
 
 
@@ -36,11 +36,15 @@
 
 
 #include <ctime>
+#include <new>
+#include <atomic>
 #include <stdint.h>
 
 #include "gb_types.h"
 #include "renderer.h"
 #include "serializer.h"
+#include "stats.h"
+#include "gb_pool.h"
 
 
 #define INT_VBLANK 1
@@ -57,6 +61,8 @@ class apu_snd;
 class rom;
 class mbc;
 class cheat;
+class gb_profiler;
+class frame_capture;
 
 enum color_correction_mode {
 	OFF,
@@ -75,6 +81,9 @@ union rp_bitfield {
 	} bits;
 };
 
+// キューに入っている側が持ち主。送ると受け手のキューへ移り、受け手が使い終わったら delete する
+// The queue holding a signal owns it: sending hands it to the receiver, which deletes it once consumed.
+// new/delete use a per-thread free list, so steady IR traffic does not touch the heap.
 struct ir_signal {
 	bool light_on;
 	int duration;
@@ -82,6 +91,13 @@ struct ir_signal {
 		light_on = light;
 		duration = clocks; 
 	}
+
+	static void *operator new(size_t size);
+	static void operator delete(void *p);
+	// ロード時に確保しておく // make sure the shared free list holds count signals, at load time
+	static void reserve(size_t count);
+	// キューの信号をすべて delete して空にする // deletes every signal in the queue and empties it
+	static void release(std::vector<ir_signal*> &que);
 };
 
 class I_ir_sender {
@@ -213,6 +229,60 @@ struct rom_info {
 	int gb_type;
 };
 
+// セーブステートの固定長ブロック。メンバーの順番と大きさがそのままステートの形式になる
+// Fixed size savestate blocks. Field order and size are the state format, so the
+// sizes are pinned below; a block is filled from (or scattered back into) the
+// members of the same name and copied with one memcpy, see s_BLOCK.
+#pragma pack(push, 1)
+struct cpu_state {
+	int que_cur;
+	int total_clock, rest_clock, sys_clock, div_clock, seri_occer;
+	bool halt, speed, speed_change, dma_executing;
+	int dma_src, dma_dest, dma_rest, gdma_rest;
+	bool b_dma_first;
+	byte _ff6c, _ff72, _ff73, _ff74, _ff75;
+};
+
+struct mbc_state {
+	int rom_bank, sram_bank, state;
+	bool ext_is_ram;
+	bool mbc1_16_8;
+	byte mbc1_dat;
+	byte mbc3_latch, mbc3_sec, mbc3_min, mbc3_hour, mbc3_dayl, mbc3_dayh, mbc3_timer;
+	int mbc5_dat;
+	bool mbc7_write_enable, mbc7_idle;
+	byte mbc7_cs, mbc7_sk, mbc7_op_code, mbc7_adr;
+	word mbc7_dat;
+	byte mbc7_ret, mbc7_state;
+	word mbc7_buf;
+	byte mbc7_count;
+	bool huc1_16_8;
+	byte huc1_dat;
+};
+
+struct apu_state {
+	apu_stat stat, stat_cpy;
+	byte mem[0x100];
+	int bef_clock;
+	bool b_echo, b_lowpass;
+};
+
+// エミュレーション RTC の時だけステートの最後に付く (ホスト時計では付かない)
+// Appended only while the RTC is emulated, a host clock state has no RTC block
+#define RTC_STATE_TAG 0x31435452 // "RTC1"
+struct rtc_state {
+	uint32_t tag;
+	uint32_t rtc_base;
+	uint64_t rtc_cycles;
+	uint32_t rtc_last_clock;
+};
+#pragma pack(pop)
+
+static_assert(sizeof(cpu_state) == 50, "cpu_state is part of the savestate format");
+static_assert(sizeof(mbc_state) == 41, "mbc_state is part of the savestate format");
+static_assert(sizeof(apu_state) == 2 * sizeof(apu_stat) + 0x106, "apu_state is part of the savestate format");
+static_assert(sizeof(rtc_state) == 20, "rtc_state is part of the savestate format");
+
 
 class I_savestate{
 public:
@@ -223,11 +293,45 @@ public:
 	virtual void reset() = 0;
 };
 
+// リンクマスター用: 各ポートの SC/IF/IE の状態を gb 側がビットで公開する
+// Serial state of a link master's ports, published by the gbs themselves.
+// armed: SC == 0x80 (waiting for an external clock), pending: an unhandled
+// serial interrupt (IF & IE & INT_SERIAL), clocking: SC == 0x81 (a transfer
+// on the internal clock). A master tests its ports in O(1) instead of reading
+// every instance's registers after each scanline.
+// ポートの gb は互いに相手を外すので、どちらが先に消えてもよい
+// a gb and the readiness it is attached to detach each other, so either may be destroyed first
+class link_readiness {
+	friend class gb;
+public:
+	link_readiness() : armed(0), pending(0), clocking(0) { for (int i=0;i<32;i++) port_gb[i]=NULL; }
+	~link_readiness();
+
+	void publish(int port, bool is_armed, bool is_pending, bool is_clocking) {
+		uint32_t bit = 1u << port;
+		if (is_armed) armed.fetch_or(bit, std::memory_order_release); else armed.fetch_and(~bit, std::memory_order_release);
+		if (is_pending) pending.fetch_or(bit, std::memory_order_release); else pending.fetch_and(~bit, std::memory_order_release);
+		if (is_clocking) clocking.fetch_or(bit, std::memory_order_release); else clocking.fetch_and(~bit, std::memory_order_release);
+	}
+	uint32_t get_armed() const { return armed.load(std::memory_order_acquire); }
+	uint32_t get_pending() const { return pending.load(std::memory_order_acquire); }
+	uint32_t get_clocking() const { return clocking.load(std::memory_order_acquire); }
+	// every port in 'ports' is armed and none has a serial interrupt pending
+	bool all_ready(uint32_t ports) const { return (get_armed() & ports) == ports && !(get_pending() & ports); }
+
+private:
+	std::atomic<uint32_t> armed, pending, clocking;
+	gb *port_gb[32];
+};
+
 class I_linkcable_target {
 	
 public:
 	virtual byte receive_from_linkcable(byte) = 0;	
 
+	// receive_from_linkcable() がフロントエンドを呼ぶ (メッセージ、入力) なら true: link_scheduler は呼び出し側のスレッドで動かす
+	// true when receive_from_linkcable() calls the frontend (messages, input): link_scheduler keeps it on the calling thread
+	virtual bool calls_frontend() const { return false; }
 };
 
 class I_linkcable_sender{
@@ -267,9 +371,20 @@ friend class cpu;
 friend class I_linkcable_target; 
 
 public:
-	gb(renderer *ref,bool b_lcd,bool b_apu);
+	// pool: 部品と大きなバッファをプールのアリーナから取る (gb_pool::create() 用)
+	// pool: carve the parts and large buffers from the pool's arenas (used by gb_pool::create())
+	gb(renderer *ref,bool b_lcd,bool b_apu,gb_pool *pool=NULL);
 	~gb();
 
+	// 部品の確保: プールがあれば hot アリーナ、無ければヒープ // parts: the pool's hot arena, or the heap without a pool
+	template <class T,class... A> T *create_part(A... args) { return new (alloc_part(sizeof(T))) T(args...); }
+	template <class T> void destroy_part(T *p) { if (!p) return; p->~T(); free_part(p); }
+	void *alloc_part(size_t size);
+	void free_part(void *p);
+	// 大きなバッファ (0 クリア済み): プールがあれば cold アリーナ // large zeroed buffers: the pool's cold arena, or the heap
+	void *alloc_cold(size_t size);
+	void free_cold(void *p);
+
 	/*
 	byte receive_from_linkcable(byte data) {
 		return this->get_cpu()->receive_from_linkcable(data);
@@ -304,19 +419,60 @@ public:
 	gb_regs *get_regs() { return &regs; }
 	gbc_regs *get_cregs() { return &c_regs; }
 
+	// リンクマスターのポートとしてつなぐ (NULL で外す) // attach as port 'port' of a master's readiness mask, NULL detaches
+	void set_link_readiness(link_readiness *ready,int port);
+	// SC/IF/IE が変わったら呼ぶ。変化した時だけアトミック操作をする // call after SC, IF or IE change; only a change touches the atomics
+	void publish_link_state() {
+		if (!link_ready) return;
+		byte state=(regs.SC==0x80?1:0)|((regs.IF&regs.IE&INT_SERIAL)?2:0)|(regs.SC==0x81?4:0);
+		if (state==link_published) return;
+		link_published=state;
+		link_ready->publish(link_port,state&1,(state&2)!=0,(state&4)!=0);
+	}
+
 	void run();
 	void reset();
 	void set_skip(int frame);
+	// 次のフレームを描くかを決め直す (フレームの終わりに自動で呼ばれる)
+	// re-decides whether the frame being drawn is kept; run() calls it at every frame end,
+	// call it again when the renderer's frame_wanted() changed in between
+	void update_frame_wanted();
+	// フレーム中のパッド入力を固定する (gb_movie が毎フレーム行う) // hold the pad value for the whole frame, gb_movie does this every frame
+	void latch_pad(int pad) { pad_latch=pad; pad_latched=true; }
+	void release_pad() { pad_latched=false; }
+	int check_pad() { return pad_latched?pad_latch:m_renderer->check_pad(); }
+	word *get_vframe() { return vframe; }
+	// 描画したフレームを capture にも渡す (NULL で停止) // also hand every rendered frame to 'capture', NULL stops
+	void set_capture(frame_capture *capture,int instance,int format) { m_capture=capture; capture_id=instance; capture_fmt=format; }
+#ifdef TGB_STATS
+	gb_stats *get_stats() { return &stats; }
+#endif
+	// period クロックごとに PC をサンプリングする (0 で停止、結果は破棄)
+	// samples the PC every 'period' clocks, 0 stops and drops the profile
+	void set_profiler(int period);
+	gb_profiler *get_profiler() { return m_profiler; }
 	void set_use_gba(bool use);
+	// RTC の時刻源: ホスト時計、または cpu::total_clock から進めるエミュレーション時計
+	// RTC time source: the host clock, or an emulated clock advanced from cpu::total_clock.
+	// host_sync seeds the emulated clock from the host at ROM and state load only.
+	// An emulated clock adds an rtc_state block to the savestate.
+	void set_rtc_mode(bool emulated,bool host_sync);
+	dword get_rtc_time();
 	bool load_rom(byte *buf,int size,byte *ram,int ram_size, bool persistent);
 
-	void serialize(serializer &s);
+	// ステートの大きさは ROM と RTC の設定だけで決まる // the state size only depends on the ROM and the RTC mode
+	static constexpr size_t state_size(bool gbc,size_t sram_size,bool rtc);
+	template <class S> void serialize(S &s);
 	void serialize_firstrev(serializer &s);
 	void serialize_legacy(serializer &s);
 
 	size_t get_state_size(void);
 	void save_state_mem(void *buf);
 	void restore_state_mem(void *buf);
+	// size は buf の実際の大きさ。時計のブロックが無いステートも読める
+	// size is what buf really holds: a state without the RTC block loads
+	// without reading past its end. false when even the rest does not fit.
+	bool restore_state_mem(void *buf,size_t size);
 
 	void refresh_pal();
 
@@ -343,6 +499,7 @@ private:
 	apu *m_apu;
 	rom *m_rom;
 	mbc *m_mbc;
+	gb_profiler *m_profiler;
 	
 	renderer *m_renderer;
 
@@ -352,11 +509,22 @@ private:
 	I_linkcable_target* linked_cable_device;
 	I_ir_target* linked_ir_device;
 
+	link_readiness *link_ready;
+	int link_port;
+	byte link_published;
+
+	frame_capture *m_capture;
+	int capture_id;
+	int capture_fmt;
+
 	gb_regs regs;
 	gbc_regs c_regs;
 
-	word dmy[160*5]; // vframe はみ出した時用
-	word vframe[160*(144+100)];
+	gb_pool *pool;
+
+	// cold バッファ: dmy[160*5] (vframe はみ出した時用), vframe[160*(144+100)] の順
+	// cold buffer laid out as dmy[160*5] (vframe underrun guard), vframe[160*(144+100)]
+	word *vframe;
 
 	ext_hook hook_proc;
 
@@ -366,6 +534,20 @@ private:
 
 	bool hook_ext;
 	bool use_gba;
+	bool pad_latched;
+	int pad_latch;
+
+#ifdef TGB_STATS
+	gb_stats stats;
+#endif
+
+	void reset_rtc();
+	template <bool load> void transfer_state(rtc_state &st);
+
+	bool rtc_emulated,rtc_host_sync;
+	uint32_t rtc_base;
+	uint64_t rtc_cycles; // 等倍速換算のクロック // clocks at normal speed
+	uint32_t rtc_last_clock;
 
 	std::map<std::string, byte> undo_cheat_map; 
 
@@ -399,7 +581,7 @@ public:
 
 private:
 	std::list<cheat_dat> cheat_list;
-	int cheat_map[0x10000];
+	int *cheat_map; // [0x10000]
 
 	gb *ref_gb;
 };
@@ -412,7 +594,7 @@ public:
 
 	void render(void *buf,int scanline);
 	void reset();
-	void clear_win_count() { now_win_line=9; }
+	void clear_win_count() { sync(); now_win_line=9; }
 	word *get_pal(int num) { return col_pal[num]; }
 	word *get_mapped_pal(int num) { return mapped_pal[num]; }
 
@@ -423,8 +605,35 @@ public:
 
 	int get_sprite_count() { return sprite_count; };
 
-	void serialize(serializer &s);
+	// 遅延モード: defer() はラインのレジスタだけを記録し、
+	// VRAM/OAM/パレットが書き換えられる時かフレームの終わりにまとめて描画する
+	// Deferred mode: defer() only records the line's registers; the lines are
+	// rasterised when VRAM/OAM/palettes are about to change or the frame is consumed
+	void set_deferred(bool enable);
+	bool get_deferred() { return deferred; }
+	void set_frame_wanted(bool wanted) { frame_wanted=wanted; }
+	void defer(void *buf,int scanline);
+	void flush();
+	void sync() { if (pend_count) flush(); }
+
+	// OAM が書き換えられた (書き込み/DMA) // OAM changed by a write or DMA
+	void invalidate_sprites() { sprite_dirty=true; }
+	// VRAM のタイルデータ (0x8000-0x97FF) が書き換えられた。adr はバンク内のオフセット
+	// Tile data (0x8000-0x97FF) changed; adr is the offset inside the bank
+	void invalidate_tile(int bank,int adr) { if (adr<0x1800) tile_dirty[bank*384+(adr>>4)]=1; }
+	void invalidate_tiles(int bank,int adr,int len);
+	void invalidate_all_tiles();
+
+	template <class S> void serialize(S &s);
+	static constexpr size_t state_size() {
+		return sizeof(m_pal16)+sizeof(m_pal32)+sizeof(col_pal)+sizeof(mapped_pal)+sizeof(trans_count)+sizeof(trans_tbl)+
+			sizeof(priority_tbl)+sizeof(now_win_line)+sizeof(mul)+sizeof(sprite_count)+sizeof(layer_enable);
+	}
 private:
+	struct line_regs {
+		byte LCDC,SCX,SCY,WX,WY,BGP,OBP1,OBP2;
+	};
+
 	void bg_render(void *buf,int scanline);
 	void win_render(void *buf,int scanline);
 	void sprite_render(void *buf,int scanline);
@@ -432,6 +641,11 @@ private:
 	void win_render_color(void *buf,int scanline);
 	void sprite_render_color(void *buf,int scanline);
 
+	void render_pending();
+	void build_sprite_buckets(bool tall);
+	void decode_tile(int tile);
+	const byte *tile_row(int tile,int row);
+
 	word m_pal16[4];
 	dword m_pal32[4];
 	word col_pal[16][4];
@@ -446,6 +660,25 @@ private:
 
 	bool layer_enable[3];
 
+	// 描画待ちのライン // Lines waiting to be rasterised
+	bool deferred;
+	bool frame_wanted;
+	void *pend_buf;
+	int pend_first,pend_count;
+	line_regs pend_regs[144];
+
+	// ライン毎のスプライト一覧 (OAM 変更時に作り直す) // Per-line sprite lists, rebuilt after OAM changes
+	bool sprite_dirty;
+	bool sprite_tall;
+	byte sprite_line_count[144];
+	byte (*sprite_line)[40]; // [144][40]
+
+	// 展開済みタイル: 2 バンク x 384 タイル x 8 行、1 ドット 1 バイトの色番号。書き込みで無効化し、次に使う時に展開する
+	// Decoded tiles: 2 banks x 384 tiles x 8 rows, one colour index per dot.
+	// VRAM writes mark a tile dirty and it is decoded again on its next use
+	byte tile_dirty[2*384];
+	byte (*tile_cache)[8][8]; // [2*384][8][8]
+
 	gb *ref_gb;
 };
 
@@ -467,10 +700,14 @@ public:
 	void update();
 	void reset();
 
-	void serialize(serializer &s);
+	template <class S> void serialize(S &s);
+	static constexpr size_t state_size() { return sizeof(apu_state); }
 private:
 	gb *ref_gb;
 	apu_snd *snd;
+
+	int bef_clock;
+	int clocks;
 };
 
 class apu_snd : public sound_renderer
@@ -489,20 +726,23 @@ public:
 
 
 	void render(short *buf,int sample);
+	void skip();
 	void reset();
 
-	void serialize(serializer &s);
+	template <class S> void serialize(S &s);
 private:
+	template <bool load> void transfer_state(apu_state &st);
 	void process(word adr,byte dat);
 	void update();
 	short sq1_produce(int freq);
 	short sq2_produce(int freq);
 	short wav_produce(int freq,bool interpolation);
 	short noi_produce(int freq);
+	unsigned int _mrand(dword degree);
 
 	apu_stat stat;
 	apu_stat stat_cpy,stat_tmp;
-	apu_que write_que[0x10000];
+	apu_que *write_que; // [0x10000]
 	int que_count;
 	int bef_clock;
 	apu *ref_apu;
@@ -512,6 +752,18 @@ private:
 
 	byte mem[0x100];
 	bool b_enable[4];
+
+	// 波形生成/フィルタの状態 // waveform generator and filter state
+	dword sq1_cur_pos,sq2_cur_pos,wav_cur_pos,noi_cur_pos;
+	dword sq1_cur_sample,sq2_cur_sample;
+	dword wav_cur_pos2;
+	byte wav_bef_sample,wav_cur_sample;
+	int noi_cur_sample;
+	int noi_shift_reg,noi_bef_degree;
+	int update_counter;
+	short *echo_filter; // [8820*2]
+	int echo_counter;
+	int bef_sample_l[5],bef_sample_r[5];
 };
 
 class mbc {
@@ -529,25 +781,41 @@ public:
 	void set_page(int rom, int sram);
 
 	byte read(word adr);
-	void write(word adr, byte dat);
-	byte ext_read(word adr);
-	void ext_write(word adr, byte dat);
+	void write(word adr, byte dat) {
+		STAT_ONLY(byte *r=rom_page; byte *s=sram_page;)
+		(this->*write_proc)(adr,dat);
+		STAT_ONLY(if (rom_page!=r||sram_page!=s) STAT_INC(ref_gb,STAT_BANK_SWITCHES);)
+	}
+	byte ext_read(word adr) { return (this->*ext_read_proc)(adr); }
+	void ext_write(word adr, byte dat) { (this->*ext_write_proc)(adr,dat); }
 	void reset();
 
-	void serialize(serializer& s);
+	template <class S> void serialize(S& s);
+	static constexpr size_t state_size() { return sizeof(mbc_state); }
 
 	unsigned long huc3_baseTime;
 
 private:
+	void bind_handlers();
+	template <bool load> void transfer_state(mbc_state& st);
+
+	void nop_write(word adr, byte dat);
+	byte nop_ext_read(word adr);
 	void mbc1_write(word adr, byte dat);
 	void mbc2_write(word adr, byte dat);
 	void mbc3_write(word adr, byte dat);
+	byte mbc3_ext_read(word adr);
+	void mbc3_ext_write(word adr, byte dat);
 	void mbc5_write(word adr, byte dat);
+	void mbc5_rumble_write(word adr, byte dat);
 	void mbc7_write(word adr, byte dat);
+	byte mbc7_ext_read(word adr);
+	void mbc7_ext_write(word adr, byte dat);
 	void huc1_write(word adr, byte dat);
 	void huc3_write(word adr, byte dat);
 	byte huc3_read(word adr);
 	void tama5_write(word adr, byte dat);
+	byte tama5_ext_read(word adr);
 	void mmm01_write(word adr, byte dat);
 
 	void huc3_doLatch();
@@ -560,6 +828,15 @@ private:
 	byte* rom_page;
 	byte* sram_page;
 
+	// ロード時に決まるハンドラとバンク計算用の値 // handlers and bank constants bound at load time
+	void (mbc::*write_proc)(word adr, byte dat);
+	byte (mbc::*ext_read_proc)(word adr);
+	void (mbc::*ext_write_proc)(word adr, byte dat);
+	byte* rom_base;
+	byte* sram_base;
+	int rom_mask;
+	int ram_mask;
+
 	bool mbc1_16_8;
 	byte mbc1_dat;
 
@@ -601,7 +878,7 @@ private:
 	byte huc3_ramValue, huc3_shift, huc3_current_mem_control_reg, huc3_modeflag;
 	bool huc3_halted;
 	byte huc3_command, huc3_access_adress;
-	byte* huc3_rtc_register;
+	byte huc3_rtc_register[0x100];
 
 	uint64_t last_rtc_second;
 	uint16_t minutes;
@@ -630,7 +907,8 @@ public:
 
 	bool load_rom(byte *buf,int size,byte *ram,int ram_size, bool persistent);
 
-	void serialize(serializer &s);
+	template <class S> void serialize(S &s);
+	static constexpr size_t state_size(size_t sram_size) { return sizeof(rom_info)+sram_size; }
 	void log_info(char* info);
 private:
 	rom_info info;
@@ -682,12 +960,18 @@ public:
 
 	bool *get_halt() { return &halt; }
 
+	void set_profiler(gb_profiler *prof);
+
 	void save_state(int *dat);
 	void restore_state(int *dat);
 	void save_state_ex(int *dat);
 	void restore_state_ex(int *dat);
 
-	void serialize(serializer &s);
+	template <class S> void serialize(S &s);
+	static constexpr size_t state_size(bool gbc) {
+		return 2*sizeof(int)+sizeof(cpu_regs)+(gbc?0x2000*4+0x2000*2:0x2000*2)+
+			sizeof(stack)+sizeof(oam)+sizeof(spare_oam)+sizeof(ext_mem)+sizeof(rp_que)+sizeof(cpu_state);
+	}
 
 	//void set_is_seri_master(bool enable);
 
@@ -705,13 +989,14 @@ private:
 
 	int dasm(char *S,byte *A);
 	void log();
+	template <bool load> void transfer_state(cpu_state &st);
 
 	gb *ref_gb;
 	I_linkcable_target* linked_device;
 	cpu_regs regs;
 
-	byte ram[0x2000*4];
-	byte vram[0x2000*2];
+	byte *ram;  // [0x2000*4]
+	byte *vram; // [0x2000*2]
 	byte stack[0x80];
 	byte oam[0xA0];
 	byte spare_oam[0x18];
@@ -743,8 +1028,19 @@ private:
 	byte _ff6c,_ff72,_ff73,_ff74,_ff75;
 
 	int clocks_since_last_serial;
+
+	template <bool profile> void exec_loop(int clocks);
+	void profile_sample(int pc);
+	gb_profiler *profiler;
+	int prof_next;
 	
 	byte last_rp_write = 0xC0;
 
 
 };
+
+constexpr size_t gb::state_size(bool gbc,size_t sram_size,bool rtc)
+{
+	return sizeof(gb_regs)+sizeof(gbc_regs)+rom::state_size(sram_size)+cpu::state_size(gbc)+mbc::state_size()+
+		lcd::state_size()+apu::state_size()+(rtc?sizeof(rtc_state):0);
+}
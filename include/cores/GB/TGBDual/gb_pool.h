@@ -0,0 +1,80 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Instance pool with hot and cold arenas
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+class gb;
+class renderer;
+
+// Bump allocator handing out zeroed, cache line aligned blocks. Nothing is
+// freed on its own; every block goes away with the arena.
+class gb_arena
+{
+public:
+	gb_arena(size_t chunk_size);
+	~gb_arena();
+
+	void* alloc(size_t size);
+	size_t get_used() const { return used; }
+
+private:
+	gb_arena(const gb_arena&);
+	gb_arena& operator=(const gb_arena&);
+
+	std::vector<char*> chunks;
+	size_t chunk_size;
+	char* cur;
+	size_t left;
+	size_t used;
+};
+
+// Owns a set of gb instances. The small per-instance objects (gb, cpu, lcd,
+// apu, apu_snd, mbc, rom, cheat) are packed back to back in the hot arena,
+// one instance after the other, so stepping every instance for a scanline
+// walks one contiguous block. The large buffers those objects point to
+// (WRAM/VRAM, frame buffers, the cheat map, the APU write queue, LCD
+// snapshots) are carved from a separate cold arena.
+class gb_pool
+{
+public:
+	// count only sizes the first hot chunk, more instances still fit
+	gb_pool(int count);
+	~gb_pool();
+
+	gb* create(renderer* ref, bool b_lcd, bool b_apu);
+	const std::vector<gb*>& get_instances() const { return instances; }
+
+	void* hot(size_t size) { return hot_arena.alloc(size); }
+	void* cold(size_t size) { return cold_arena.alloc(size); }
+
+	size_t get_hot_size() const { return hot_arena.get_used(); }
+	size_t get_cold_size() const { return cold_arena.get_used(); }
+
+	// bytes of hot state per instance
+	static size_t instance_size();
+
+private:
+	gb_arena hot_arena;
+	gb_arena cold_arena;
+	std::vector<gb*> instances;
+};
@@ -0,0 +1,154 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Input movie recording and verification playback
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#pragma once
+
+#include <cores/GB/TGBDual/gb.h>
+#include <cores/GB/TGBDual/renderer.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#define MOVIE_MAGIC "DCGBMOV"
+#define MOVIE_VERSION 1
+
+class link_master_device;
+
+// A movie is a savestate anchor for every instance (and the link device,
+// if any) followed by one record per frame: each player's pad byte, the
+// link-device hotkeys pressed before that frame, and a hash of each
+// player's WRAM and vframe after it.
+//
+// The pads are latched once per frame through gb::latch_pad(), so the
+// instances read the same value on every FF00 access whether the frame
+// is recorded, played back or played live. Live pads are read from the
+// renderers in begin_frame(), on the caller's thread, so instances that
+// run on scheduler threads never call into the frontend.
+// The vframe hash covers the lines drawn so far in the current frame, so
+// while a movie hashes video the instances render eagerly (not deferred).
+// Integers are stored in host byte order, like the savestates they carry.
+// Carts with an RTC only replay exactly with gb::set_rtc_mode(true,false).
+class gb_movie
+{
+public:
+	enum mode_t { IDLE, RECORD, PLAYBACK };
+
+	gb_movie();
+
+	// the instances whose live pads begin_frame() latches while no movie runs;
+	// stops any movie, pass an empty list before the instances go away
+	void attach(const std::vector<gb*>& gbs);
+	// saves the anchor from the current state of gbs/link and starts recording
+	// without hash_video only WRAM is hashed, so playback can skip the LCD entirely
+	void start_record(const std::vector<gb*>& gbs, I_savestate* link = NULL, bool hash_video = true);
+	// restores the anchor into gbs/link and starts playback, false if data is not a movie for them
+	bool start_playback(const byte* data, size_t size, const std::vector<gb*>& gbs, I_savestate* link = NULL);
+	void stop();
+
+	// around every emulated frame: begin_frame() latches the pads
+	// (and replays hotkeys), end_frame() hashes the instances
+	void begin_frame();
+	void end_frame();
+
+	// a link-device hotkey was pressed: begin_frame() hands it to the handler
+	// (and records it). Ignored while a movie plays, which replays its own.
+	void add_hotkey(int key);
+	// applies a hotkey to the link devices, live, recorded or replayed alike
+	void set_hotkey_handler(std::function<void(int)> handler) { hotkey_handler = handler; }
+
+	void save(std::vector<byte>& out) const;
+
+	// 描画・音声を出さずに最後まで再生し、記録と違う最初のフレームを返す (一致なら -1)
+	// Plays back to the end with nothing sent to the frontend, link is processed every line.
+	// The instances should use headless_renderer(get_hash_video()) for full speed.
+	// Returns the first frame whose hash differs from the recording, or -1.
+	// hash_log gets "frame player hash" lines for every frame when given.
+	int play_headless(link_master_device* link = NULL, FILE* hash_log = NULL);
+
+	mode_t get_mode() const { return mode; }
+	bool is_finished() const { return mode == PLAYBACK && cur_frame >= frames; }
+	int get_frame() const { return cur_frame; }
+	int get_frames() const { return frames; }
+	int get_players() const { return players; }
+	int get_first_mismatch() const { return first_mismatch; }
+	bool get_hash_video() const { return hash_video; }
+	uint64_t get_hash(int frame, int player) const { return hashes[frame * players + player]; }
+
+	static uint64_t hash_instance(gb* g, bool video);
+	// number of players a movie was recorded with, -1 if data is not a movie
+	static int read_players(const byte* data, size_t size);
+
+private:
+	struct hotkey_event { int frame; int key; };
+
+	void hold_deferred();
+	void restore_deferred();
+	void deliver_hotkeys();
+
+	mode_t mode;
+	std::vector<gb*> v_gb;
+	int players;
+	int frames;
+	int cur_frame;
+	int first_mismatch;
+	bool hash_video;
+
+	std::vector<byte> anchor;        // player states then the link state
+	std::vector<uint32_t> anchor_size; // one per player, link last
+	std::vector<byte> pads;          // frames * players
+	std::vector<uint64_t> hashes;    // frames * players
+	std::vector<hotkey_event> hotkeys;
+	std::vector<int> pending_hotkeys;
+	std::vector<bool> was_deferred; // lcd deferred mode of each instance before the movie
+	size_t next_hotkey;
+	FILE* hash_log;
+
+	std::function<void(int)> hotkey_handler;
+};
+
+// 何も出力しないレンダラ。ムービー検証用の gb に渡す
+// Renderer that outputs nothing, for gb instances that only verify movies.
+// Input comes from the movie, sound is skipped; LCD rendering can be culled
+// too when the vframe is not part of the hash.
+class headless_renderer : public renderer
+{
+public:
+	headless_renderer(bool render_lcd = true) { lcd = render_lcd; snd_render = NULL; }
+
+	void reset() {}
+	void refresh() { if (snd_render) snd_render->skip(); }
+	void render_screen(byte*, int, int, int) {}
+	int check_pad() { return 0; }
+	word map_color(word gb_col) { return gb_col; }
+	word unmap_color(word gb_col) { return gb_col; }
+	byte get_time(int type);
+	void set_time(int type, byte dat);
+	void sync_time(dword now) { clock.fixed_time = now; }
+	word get_sensor(bool) { return 0; }
+	void set_bibrate(bool) {}
+	bool frame_wanted() { return lcd; }
+	void set_render_lcd(bool render_lcd) { lcd = render_lcd; }
+
+private:
+	bool lcd;
+	rtc_clock clock;
+};
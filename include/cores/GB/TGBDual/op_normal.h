@@ -418,6 +418,7 @@ case 0x76:
 		tmp=ref_gb->get_regs()->TIMA+(sys_clock+rest_clock)/timer_clocks[ref_gb->get_regs()->TAC&0x03];
 
 		if (tmp&0xFF00){//HALT中に割りこみがかかる場合
+			STAT_ADD(ref_gb,STAT_HALT_CLOCKS,(256-ref_gb->get_regs()->TIMA)*timer_clocks[ref_gb->get_regs()->TAC&0x03]-sys_clock);
 			total_clock+=(256-ref_gb->get_regs()->TIMA)*timer_clocks[ref_gb->get_regs()->TAC&0x03]-sys_clock;
 			rest_clock-=(256-ref_gb->get_regs()->TIMA)*timer_clocks[ref_gb->get_regs()->TAC&0x03]-sys_clock;
 			ref_gb->get_regs()->TIMA=ref_gb->get_regs()->TMA;
@@ -430,6 +431,7 @@ case 0x76:
 			ref_gb->get_regs()->TIMA=tmp&0xFF;
 			sys_clock=(sys_clock+rest_clock)&(timer_clocks[ref_gb->get_regs()->TAC&0x03]-1);
 			halt=true;
+			STAT_ADD(ref_gb,STAT_HALT_CLOCKS,rest_clock);
 			total_clock+=rest_clock;
 			rest_clock=0;
 			REG_PC--;
@@ -437,6 +439,7 @@ case 0x76:
 	}
 	else{
 		halt=true;
+		STAT_ADD(ref_gb,STAT_HALT_CLOCKS,rest_clock);
 		total_clock+=rest_clock;
 		div_clock+=rest_clock;
 		rest_clock=0;
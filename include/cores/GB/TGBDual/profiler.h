@@ -0,0 +1,62 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Sampling profiler for emulated code
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <map>
+#include <string>
+#include <unordered_map>
+
+// Histogram of the guest PC, keyed by (bank, PC) like an RGBDS .sym file.
+// cpu::exec() takes one sample every 'period' clocks; an instruction that
+// spans several periods (a HALT) is weighted accordingly,
+// so the counts are proportional to emulated time, not instructions.
+// Use a period that is not a multiple of 4 (a prime such as 997) so
+// tight loops don't alias onto a single instruction.
+class gb_profiler
+{
+public:
+	gb_profiler(int period);
+
+	int get_period() const { return period; }
+	uint64_t get_samples() const { return samples; }
+
+	void sample(int bank, int pc, int periods) { hist[((uint32_t)bank << 16) | (pc & 0xffff)] += periods; samples += periods; }
+	void clear() { hist.clear(); samples = 0; }
+
+	// reads "BB:AAAA label" lines (RGBDS/no$gmb .sym), may be called for several files
+	bool load_sym(const char* path);
+	void clear_sym() { symbols.clear(); }
+
+	// one "root;label;BB:AAAA count" line per sampled address, for flamegraph.pl
+	// addresses without a label are grouped as "ROMX_BB" etc.
+	bool write_folded(FILE* out, const char* root) const;
+	bool write_folded(const char* path, const char* root) const;
+
+private:
+	std::string label_for(uint32_t key) const;
+
+	int period;
+	uint64_t samples;
+	std::unordered_map<uint32_t, uint64_t> hist;
+	std::map<uint32_t, std::string> symbols;
+};
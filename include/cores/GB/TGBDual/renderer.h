@@ -30,6 +30,51 @@ class sound_renderer
 {
 public:
 	virtual void render(short *buf,int samples)=0;
+	// advance to the current clock without producing samples (muted instances)
+	virtual void skip()=0;
+};
+
+// レンダラの get_time()/set_time() が使う RTC の時計。fixed_time は sync_time() で gb から受け取る
+// The clock behind a renderer's get_time()/set_time(): fixed_time is the RTC
+// time (seconds) from sync_time(), offset keeps what the game wrote into the
+// registers. type is 8 second, 9 minute, 10 hour, 11 day (L), 12 day (H).
+struct rtc_clock
+{
+	dword fixed_time;
+	dword offset;
+
+	rtc_clock() { fixed_time=offset=0; }
+
+	byte get(int type) const
+	{
+		dword now=fixed_time-offset;
+
+		switch(type)
+		{
+			case 8: return (byte)(now%60);
+			case 9: return (byte)((now/60)%60);
+			case 10: return (byte)((now/(60*60))%24);
+			case 11: return (byte)((now/(24*60*60))&0xff);
+			case 12: return (byte)((now/(256*24*60*60))&1);
+		}
+		return 0;
+	}
+
+	void set(int type,byte dat)
+	{
+		dword now=fixed_time;
+		dword adj=now-offset;
+
+		switch(type)
+		{
+			case 8: adj=(adj/60)*60+(dat%60); break;
+			case 9: adj=(adj/(60*60))*60*60+(dat%60)*60+(adj%60); break;
+			case 10: adj=(adj/(24*60*60))*24*60*60+(dat%24)*60*60+(adj%(60*60)); break;
+			case 11: adj=(adj/(256*24*60*60))*256*24*60*60+(dat*24*60*60)+(adj%(24*60*60)); break;
+			case 12: adj=(dat&1)*256*24*60*60+(adj%(256*24*60*60)); break;
+		}
+		offset=now-adj;
+	}
 };
 
 class renderer
@@ -46,11 +91,23 @@ public:
 
 	virtual byte get_time(int type)=0;
 	virtual void set_time(int type,byte dat)=0;
+	// 毎フレーム gb から RTC の時刻 (秒) を受け取る // receives the RTC clock (seconds) from gb once per frame
+	virtual void sync_time(dword /*now*/) {}
 
 	virtual word get_sensor(bool x_y)=0;
 
 	virtual void set_bibrate(bool bibrate)=0;
 
+	// false なら今のフレームは表示されない (遅延描画で捨てられる)
+	// false when the current frame will not be shown, so deferred lines can be dropped
+	virtual bool frame_wanted() { return true; }
+
+	// 全インスタンスが走り終えてから retro_run のスレッドで呼ばれる。refresh() と
+	// render_screen() で貯めた出力をここでフロントエンドに渡す
+	// called on the frontend thread once every instance has run the frame; output
+	// kept by refresh() and render_screen() goes to the frontend here
+	virtual void flush_output() {}
+
 protected:
 	sound_renderer *snd_render;
 };
@@ -3,6 +3,7 @@
 #define __SERIALIZER_H__
 
 #include <string.h>
+#include <stdint.h>
 
 // convenience macros for common uses
 #define s_ARRAY(a) s.process((a), sizeof(a))
@@ -19,6 +20,9 @@ public:
 		my_mode = mode;
 		my_target.ptr = target;
 	}
+	bool saving() const { return my_mode == SAVE_BUF; }
+	bool loading() const { return my_mode == LOAD_BUF; }
+
 	inline size_t process(void *data, size_t size)
 	{
 		switch(my_mode) {
@@ -47,5 +51,68 @@ private:
 	} my_target;
 };
 
+// same interface with the mode fixed at compile time: process() is a bare
+// memcpy or add, so the many small fields of a gb state cost nothing extra.
+template <serializer::mode_t MODE>
+class state_serializer
+{
+public:
+	// size bounds a LOAD_BUF buffer for remaining(), 0 leaves it unbounded
+	state_serializer(void *target, size_t size = 0)
+	{
+		my_target.ptr = target;
+		my_end = size ? (unsigned char *)target + size : nullptr;
+	}
+	static constexpr bool saving() { return MODE == serializer::SAVE_BUF; }
+	static constexpr bool loading() { return MODE == serializer::LOAD_BUF; }
+	// bytes left in a bounded input, SIZE_MAX otherwise. Optional trailing
+	// blocks check it before they read.
+	size_t remaining() const
+	{
+		if (MODE != serializer::LOAD_BUF || !my_end)
+			return SIZE_MAX;
+		return my_target.buf < my_end ? (size_t)(my_end - my_target.buf) : 0;
+	}
+
+	inline size_t process(void *data, size_t size)
+	{
+		if (MODE == serializer::COUNT)
+			my_target.counter[0] += size;
+		else if (MODE == serializer::SAVE_BUF) {
+			memcpy(my_target.buf, data, size);
+			my_target.buf += size;
+		} else {
+			memcpy(data, my_target.buf, size);
+			my_target.buf += size;
+		}
+		return size;
+	}
+private:
+	union {
+		void *ptr;
+		size_t *counter;
+		unsigned char *buf;
+	} my_target;
+	unsigned char *my_end;
+};
+
+// explicit instantiations for a 'template <class S> void serialize(S &s)'
+// member that is defined in a .cpp file
+#define SERIALIZE_INSTANTIATE(cls) \
+	template void cls::serialize(state_serializer<serializer::COUNT> &); \
+	template void cls::serialize(state_serializer<serializer::SAVE_BUF> &); \
+	template void cls::serialize(state_serializer<serializer::LOAD_BUF> &)
+
+// Packed state blocks: 'template <bool load> void transfer_state(xxx_state &st)'
+// lists every member once with s_FIELD, which copies it into the block of the
+// same name before saving and back out of it after loading, so the block
+// itself goes through process() with a single memcpy.
+#define s_FIELD(v) (load ? (void)memcpy(&(v), &st.v, sizeof(v)) : (void)memcpy(&st.v, &(v), sizeof(v)))
+#define s_BLOCK(st) do { \
+		if (s.saving()) transfer_state<false>(st); \
+		s_VAR(st); \
+		if (s.loading()) transfer_state<true>(st); \
+	} while (0)
+
 #endif //__SERIALIZER_H__
 
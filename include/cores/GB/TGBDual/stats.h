@@ -0,0 +1,128 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Hot path instrumentation counters
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Counters are compiled in with -DTGB_STATS only. Without it every STAT_*
+// macro is empty and the C API below reports no instances.
+
+enum tgb_stat {
+	STAT_INSTRUCTIONS,
+	STAT_HALT_CLOCKS,
+	STAT_READ_ROM0,
+	STAT_READ_ROMX,
+	STAT_READ_VRAM,
+	STAT_READ_SRAM,
+	STAT_READ_WRAM,
+	STAT_READ_OAM,
+	STAT_READ_IO,
+	STAT_READ_HRAM,
+	STAT_BANK_SWITCHES,
+	STAT_OAM_DMA,
+	STAT_HDMA,
+	STAT_SERIAL_BYTES,
+	STAT_IR_EDGES,
+	STAT_LINES_RENDERED,
+	STAT_LINES_SKIPPED,
+	// scoped timers, in nanoseconds
+	STAT_TIME_CPU_EXEC,
+	STAT_TIME_LCD_RENDER,
+	STAT_TIME_APU_RENDER,
+	STAT_TIME_LINK_PROCESS,
+	STAT_COUNT
+};
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+int tgb_stats_instance_count(void);
+const char *tgb_stats_name(int stat);
+// last_frame != 0: the last completed frame, otherwise the total since the last reset
+uint64_t tgb_stats_get(int instance, int stat, int last_frame);
+uint64_t tgb_stats_frames(int instance);
+void tgb_stats_reset(void);
+// writes {"instances":[{"frames":n,"frame":{...},"total":{...}},...]}, returns the full length like snprintf
+size_t tgb_stats_dump_json(char *buf, size_t size);
+// log gets one line per instance every 'every_frames' frames (0 turns it off),
+// from tgb_stats_flush_log() only
+void tgb_stats_set_log(void (*log)(const char *line), int every_frames);
+// call on the frontend thread once the frame's instances have run
+void tgb_stats_flush_log(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#ifdef __cplusplus
+#ifdef TGB_STATS
+
+#include <chrono>
+
+// frame は gb のスレッドだけが触る。end_frame() がロックの中で残りに写す
+// frame is only touched by the gb's own thread; end_frame() copies it into
+// the published counters under the registry lock, where the C API reads them.
+struct gb_stats {
+	uint64_t frame[STAT_COUNT];
+	// published, guarded by the registry lock
+	uint64_t last_frame[STAT_COUNT];
+	uint64_t total[STAT_COUNT];
+	uint64_t frames;
+	uint64_t logged_frames;
+	bool discard_frame; // tgb_stats_reset() ran during this frame
+	int id;
+
+	gb_stats();
+	void reset();
+	void end_frame();
+};
+
+class stat_timer {
+public:
+	stat_timer(uint64_t &slot) : acc(slot), start(std::chrono::steady_clock::now()) {}
+	~stat_timer() { acc+=std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now()-start).count(); }
+private:
+	uint64_t &acc;
+	std::chrono::steady_clock::time_point start;
+};
+
+// gb の登録 (C API のインスタンス番号になる) // registers a gb, its order is the C API instance index
+void tgb_stats_register(gb_stats *s);
+void tgb_stats_unregister(gb_stats *s);
+
+#define STAT_CAT_(a,b) a##b
+#define STAT_CAT(a,b) STAT_CAT_(a,b)
+#define STAT_ADD(g,stat,n) ((g)->get_stats()->frame[stat]+=(n))
+#define STAT_INC(g,stat) STAT_ADD(g,stat,1)
+#define STAT_TIMER(g,stat) stat_timer STAT_CAT(stat_timer_,__LINE__)((g)->get_stats()->frame[stat])
+#define STAT_ONLY(x) x
+
+#else
+
+#define STAT_ADD(g,stat,n) ((void)0)
+#define STAT_INC(g,stat) ((void)0)
+#define STAT_TIMER(g,stat)
+#define STAT_ONLY(x)
+
+#endif
+#endif
@@ -80,7 +80,7 @@ void TGBDualRenderer::refresh() {
         this->snd_render->render(stream, SAMPLES_PER_FRAME);
         audio_batch_cb(stream, SAMPLES_PER_FRAME);
     }
-    fixed_time = time(NULL);
+    clock.fixed_time = time(NULL);
 
     */
 }
@@ -115,47 +115,11 @@ int TGBDualRenderer::check_pad()
 
 byte TGBDualRenderer::get_time(int type)
 {
-    dword now = fixed_time - cur_time;
-
-    switch (type)
-    {
-    case 8: // second
-        return (byte)(now % 60);
-    case 9: // minute
-        return (byte)((now / 60) % 60);
-    case 10: // hour
-        return (byte)((now / (60 * 60)) % 24);
-    case 11: // day (L)
-        return (byte)((now / (24 * 60 * 60)) & 0xff);
-    case 12: // day (H)
-        return (byte)((now / (256 * 24 * 60 * 60)) & 1);
-    }
-    return 0;
+    return clock.get(type);
 }
 
 void TGBDualRenderer::set_time(int type, byte dat)
 {
-    dword now = fixed_time;
-    dword adj = now - cur_time;
-
-    switch (type)
-    {
-    case 8: // second
-        adj = (adj / 60) * 60 + (dat % 60);
-        break;
-    case 9: // minute
-        adj = (adj / (60 * 60)) * 60 * 60 + (dat % 60) * 60 + (adj % 60);
-        break;
-    case 10: // hour
-        adj = (adj / (24 * 60 * 60)) * 24 * 60 * 60 + (dat % 24) * 60 * 60 + (adj % (60 * 60));
-        break;
-    case 11: // day (L)
-        adj = (adj / (256 * 24 * 60 * 60)) * 256 * 24 * 60 * 60 + (dat * 24 * 60 * 60) + (adj % (24 * 60 * 60));
-        break;
-    case 12: // day (H)
-        adj = (dat & 1) * 256 * 24 * 60 * 60 + (adj % (256 * 24 * 60 * 60));
-        break;
-    }
-    cur_time = now - adj;
+    clock.set(type, dat);
 }
 
@@ -27,25 +27,23 @@
 #include <cores/GB/TGBDual/gb.h>
 #include <stdlib.h>
 
-static dword sq1_cur_pos=0;
-static dword sq2_cur_pos=0;
-static dword wav_cur_pos=0;
-static dword noi_cur_pos=0;
-
 apu::apu(gb *ref)
 {
 	ref_gb=ref;
-	snd=new apu_snd(this);
+	snd=ref_gb->create_part<apu_snd>(this);
 	reset();
 }
 
 apu::~apu()
 {
+	ref_gb->destroy_part(snd);
 }
 
 void apu::reset()
 {
-	//
+	// 次のwriteで現在のクロックに合わせる // re-synced to the current clock on the next write
+	bef_clock=0x7fffffff;
+	clocks=0;
 	snd->reset();
 }
 
@@ -63,9 +61,6 @@ byte apu::read(word adr)
 
 void apu::write(word adr,byte dat,int clock)
 {
-	static int bef_clock=clock;
-	static int clocks=0;
-
 	snd->mem[adr-0xFF10]=dat;
 
 	snd->write_que[snd->que_count].adr=adr;
@@ -114,6 +109,8 @@ byte *apu::get_mem()
 apu_snd::apu_snd(apu *papu)
 {
 	ref_apu=papu;
+	write_que=(apu_que*)ref_apu->ref_gb->alloc_cold(sizeof(apu_que)*0x10000);
+	echo_filter=(short*)ref_apu->ref_gb->alloc_cold(sizeof(short)*8820*2);
 	b_enable[0]=b_enable[1]=b_enable[2]=b_enable[3]=true;
 	b_echo=false;
 	b_lowpass=true;
@@ -121,6 +118,8 @@ apu_snd::apu_snd(apu *papu)
 
 apu_snd::~apu_snd()
 {
+	ref_apu->ref_gb->free_cold(write_que);
+	ref_apu->ref_gb->free_cold(echo_filter);
 }
 
 void apu_snd::reset()
@@ -140,6 +139,20 @@ void apu_snd::reset()
 
 	memcpy(&stat_cpy,&stat,sizeof(stat));
 
+	// 波形生成/フィルタの状態はインスタンス毎 // waveform and filter state is per instance
+	sq1_cur_pos=sq2_cur_pos=wav_cur_pos=noi_cur_pos=0;
+	sq1_cur_sample=sq2_cur_sample=0;
+	wav_cur_pos2=0;
+	wav_bef_sample=wav_cur_sample=0;
+	noi_cur_sample=10000;
+	noi_shift_reg=0x7f;
+	noi_bef_degree=0;
+	update_counter=0;
+	memset(echo_filter,0,sizeof(short)*8820*2);
+	echo_counter=0;
+	memset(bef_sample_l,0,sizeof(bef_sample_l));
+	memset(bef_sample_r,0,sizeof(bef_sample_r));
+
 	byte gb_init_wav[]={0x06,0xFE,0x0E,0x7F,0x00,0xFF,0x58,0xDF,0x00,0xEC,0x00,0xBF,0x0C,0xED,0x03,0xF7};
 	byte gbc_init_wav[]={0x00,0xFF,0x00,0xFF,0x00,0xFF,0x00,0xFF,0x00,0xFF,0x00,0xFF,0x00,0xFF,0x00,0xFF};
 
@@ -333,7 +346,6 @@ static int sq_wav_dat[4][8]={
 
 inline short apu_snd::sq1_produce(int freq)
 {
-	static dword cur_sample=0;
 	dword cur_freq;
 	short ret;
 
@@ -341,11 +353,11 @@ inline short apu_snd::sq1_produce(int freq)
 		return 15000;
 
 	if (freq){
-		ret=sq_wav_dat[stat.sq1_type&3][cur_sample]*20000-10000;
+		ret=sq_wav_dat[stat.sq1_type&3][sq1_cur_sample]*20000-10000;
 		cur_freq=((freq*8)>0x10000)?0xffff:freq*8;
 		sq1_cur_pos+=(cur_freq<<16)/44100;
 		if (sq1_cur_pos&0xffff0000){
-			cur_sample=(cur_sample+(sq1_cur_pos>>16))&7;
+			sq1_cur_sample=(sq1_cur_sample+(sq1_cur_pos>>16))&7;
 			sq1_cur_pos&=0xffff;
 		}
 	}
@@ -357,7 +369,6 @@ inline short apu_snd::sq1_produce(int freq)
 
 inline short apu_snd::sq2_produce(int freq)
 {
-	static dword cur_sample=0;
 	dword cur_freq;
 	short ret;
 
@@ -365,11 +376,11 @@ inline short apu_snd::sq2_produce(int freq)
 		return 15000;
 
 	if (freq){
-		ret=sq_wav_dat[stat.sq2_type&3][cur_sample]*20000-10000;
+		ret=sq_wav_dat[stat.sq2_type&3][sq2_cur_sample]*20000-10000;
 		cur_freq=((freq*8)>0x10000)?0xffff:freq*8;
 		sq2_cur_pos+=(cur_freq<<16)/44100;
 		if (sq2_cur_pos&0xffff0000){
-			cur_sample=(cur_sample+(sq2_cur_pos>>16))&7;
+			sq2_cur_sample=(sq2_cur_sample+(sq2_cur_pos>>16))&7;
 			sq2_cur_pos&=0xffff;
 		}
 	}
@@ -381,8 +392,6 @@ inline short apu_snd::sq2_produce(int freq)
 
 inline short apu_snd::wav_produce(int freq,bool interpolation)
 {
-	static dword cur_pos2=0;
-	static byte bef_sample=0,cur_sample=0;
 	dword cur_freq;
 	short ret;
 
@@ -393,20 +402,20 @@ inline short apu_snd::wav_produce(int freq,bool interpolation)
 
 		if (interpolation)
 		{
-			ret=((cur_sample*2500-15000)*wav_cur_pos+(bef_sample*2500-15000)*(0x10000-wav_cur_pos))/0x10000;
+			ret=((wav_cur_sample*2500-15000)*wav_cur_pos+(wav_bef_sample*2500-15000)*(0x10000-wav_cur_pos))/0x10000;
 		}
 		else{
-			ret=cur_sample*2500-15000;
+			ret=wav_cur_sample*2500-15000;
 		}
 		cur_freq=(freq>0x10000)?0xffff:freq;
 		wav_cur_pos+=(cur_freq<<16)/44100;
 		if (wav_cur_pos&0xffff0000){
-			bef_sample=cur_sample;
-			cur_pos2=(cur_pos2+(wav_cur_pos>>16))&31;
-			if (cur_pos2&1)
-				cur_sample=mem[0x20+cur_pos2/2]&0xf;
+			wav_bef_sample=wav_cur_sample;
+			wav_cur_pos2=(wav_cur_pos2+(wav_cur_pos>>16))&31;
+			if (wav_cur_pos2&1)
+				wav_cur_sample=mem[0x20+wav_cur_pos2/2]&0xf;
 			else
-				cur_sample=mem[0x20+cur_pos2/2]>>4;
+				wav_cur_sample=mem[0x20+wav_cur_pos2/2]>>4;
 			wav_cur_pos&=0xffff;
 		}
 	}
@@ -416,10 +425,10 @@ inline short apu_snd::wav_produce(int freq,bool interpolation)
 	return ret;
 }
 
-static inline unsigned int _mrand(dword degree)
+inline unsigned int apu_snd::_mrand(dword degree)
 {
-	static int shift_reg=0x7f;
-	static int bef_degree=0;
+	int &shift_reg=noi_shift_reg;
+	int &bef_degree=noi_bef_degree;
 	int xor_reg=0;
 	int masked;
 	
@@ -470,27 +479,26 @@ inline short apu_snd::noi_produce(int freq)
 }*/
 inline short apu_snd::noi_produce(int freq)
 {
- 	static int cur_sample=10000;
  	dword cur_freq;
  	short ret;
  	int sc;
  	if (freq){
- 		ret=cur_sample;
+ 		ret=noi_cur_sample;
  		cur_freq=freq;
  		noi_cur_pos+=cur_freq;
  		sc=0;
  		while(noi_cur_pos>44100){
  			if(sc==0)
- 				cur_sample=(_mrand(stat.noi_step)&1)?12000:-10000;
+ 				noi_cur_sample=(_mrand(stat.noi_step)&1)?12000:-10000;
 			else
- 				cur_sample+=(_mrand(stat.noi_step)&1)?12000:-10000;
-//			cur_sample=(_mrand(stat.noi_step)&0x1f)*1000;
+ 				noi_cur_sample+=(_mrand(stat.noi_step)&1)?12000:-10000;
+//			noi_cur_sample=(_mrand(stat.noi_step)&0x1f)*1000;
 			noi_cur_pos-=44100;
  			sc++;
  		}
  		
 		if(sc > 0)
- 			cur_sample /= sc;
+ 			noi_cur_sample /= sc;
  		
 		
 	}
@@ -501,7 +509,7 @@ inline short apu_snd::noi_produce(int freq)
 
 void apu_snd::update()
 {
-	static int counter=0;
+	int &counter=update_counter;
 
 	if (stat.sq1_playing&&stat.master_enable){
 		if (stat.sq1_env_speed&&(counter%(4*stat.sq1_env_speed)==0)){
@@ -564,8 +572,9 @@ void apu_snd::update()
 
 void apu_snd::render(short *buf,int sample)
 {
-	static short filter[8820*2];
-	static int counter=0;
+	STAT_TIMER(ref_apu->ref_gb,STAT_TIME_APU_RENDER);
+	short *filter=echo_filter;
+	int &counter=echo_counter;
 
 	memcpy(&stat_tmp,&stat,sizeof(stat));
 	memcpy(&stat,&stat_cpy,sizeof(stat_cpy));
@@ -573,7 +582,7 @@ void apu_snd::render(short *buf,int sample)
 	int tmp_l,tmp_r,tmp;
 	int now_clock=ref_apu->ref_gb->get_cpu()->get_clock();
 	int cur=0;
-	static int tmp_sample=0,now_time,bef_sample_l[5]={0,0,0,0,0},bef_sample_r[5]={0,0,0,0,0};
+	int now_time;
 	int update_count=0;
 
 	memset(buf,0,sample*4);
@@ -667,8 +676,6 @@ void apu_snd::render(short *buf,int sample)
 		buf[i*2]=tmp_r;
 		buf[i*2+1]=tmp_l;
 
-		tmp_sample++;
-
 		while(update_count*CLOKS_PER_INTERVAL*(ref_apu->ref_gb->get_cpu()->get_speed()?2:1)<now_time-bef_clock){
 			update();
 			update_count++;
@@ -690,17 +697,35 @@ void apu_snd::render(short *buf,int sample)
 	memcpy(&stat,&stat_tmp,sizeof(stat));
 }
 
-void apu::serialize(serializer &s) { snd->serialize(s); }
-void apu_snd::serialize(serializer &s)
+void apu_snd::skip()
+{
+	// 出力しないインスタンスはキューを捨てて描画側の状態を追いつかせる
+	// muted instances drop their queue and bring the render copy up to date
+	que_count=0;
+	bef_clock=ref_apu->ref_gb->get_cpu()->get_clock();
+	memcpy(&stat_cpy,&stat,sizeof(stat));
+}
+
+template <class S> void apu::serialize(S &s) { snd->serialize(s); }
+SERIALIZE_INSTANTIATE(apu);
+
+template <bool load> void apu_snd::transfer_state(apu_state &st)
 {
 	// originally, the only things saved were stat, stat_cpy,
 	// and the first 0x30 bytes of mem.
-	s_VAR(stat);
-	s_VAR(stat_cpy);
-	s_ARRAY(mem);
+	s_FIELD(stat);
+	s_FIELD(stat_cpy);
+	s_FIELD(mem);
 
-	s_VAR(bef_clock);
-	s_VAR(b_echo);
-	s_VAR(b_lowpass);
+	s_FIELD(bef_clock);
+	s_FIELD(b_echo);
+	s_FIELD(b_lowpass);
+}
+
+template <class S> void apu_snd::serialize(S &s)
+{
+	apu_state st;
+	s_BLOCK(st);
 }
+SERIALIZE_INSTANTIATE(apu_snd);
 
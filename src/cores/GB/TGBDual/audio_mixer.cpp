@@ -0,0 +1,199 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Multi instance audio mixer
+   Copyright (C) 2023  Tim Oelrichs
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <cores/GB/TGBDual/audio_mixer.h>
+#include <cmath>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define MIXER_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define MIXER_NEON
+#endif
+
+audio_mixer gb_audio_mixer;
+
+static int16_t to_gain(float value)
+{
+	if (value < 0.0f) value = 0.0f;
+	if (value > 1.0f) value = 1.0f;
+	return (int16_t)(value * MIXER_GAIN_ONE + 0.5f);
+}
+
+audio_mixer::audio_mixer()
+{
+	reset();
+}
+
+void audio_mixer::reset()
+{
+	for (int i = 0; i < MIXER_MAX_PLAYERS; i++)
+		mute_player(i);
+	memset(acc_l, 0, sizeof(acc_l));
+	memset(acc_r, 0, sizeof(acc_r));
+	applied_mode = -1;
+	applied_players = 0;
+}
+
+void audio_mixer::set_player(int player, float gain, float pan, bool mono)
+{
+	if (player < 0 || player >= MIXER_MAX_PLAYERS)
+		return;
+
+	float left = gain * (pan > 0.0f ? 1.0f - pan : 1.0f);
+	float right = gain * (pan < 0.0f ? 1.0f + pan : 1.0f);
+
+	if (mono)
+	{
+		matrix[player][0] = matrix[player][1] = to_gain(left * 0.5f);
+		matrix[player][2] = matrix[player][3] = to_gain(right * 0.5f);
+	}
+	else
+	{
+		matrix[player][0] = to_gain(left);
+		matrix[player][1] = 0;
+		matrix[player][2] = 0;
+		matrix[player][3] = to_gain(right);
+	}
+
+	audible[player] = matrix[player][0] || matrix[player][1] || matrix[player][2] || matrix[player][3];
+}
+
+void audio_mixer::mute_player(int player)
+{
+	if (player < 0 || player >= MIXER_MAX_PLAYERS)
+		return;
+
+	memset(matrix[player], 0, sizeof(matrix[player]));
+	audible[player] = false;
+}
+
+void audio_mixer::apply_mode(int mode, int players)
+{
+	if (mode == applied_mode && players == applied_players)
+		return;
+
+	applied_mode = mode;
+	applied_players = players;
+
+	for (int i = 0; i < MIXER_MAX_PLAYERS; i++)
+		mute_player(i);
+
+	if (mode >= 0 && mode < players)
+	{
+		set_player(mode, 1.0f, 0.0f);
+		return;
+	}
+
+	if (players == 2)
+	{
+		// dual mono: player 1 left, player 2 right
+		set_player(0, 1.0f, -1.0f, true);
+		set_player(1, 1.0f, 1.0f, true);
+		return;
+	}
+
+	// equal power so a full 16 player mix does not just clip
+	float gain = 1.0f / std::sqrt((float)(players > 0 ? players : 1));
+	for (int i = 0; i < players && i < MIXER_MAX_PLAYERS; i++)
+		set_player(i, gain, 0.0f);
+}
+
+void audio_mixer::add(int player, const int16_t* stream, int samples)
+{
+	if (player < 0 || player >= MIXER_MAX_PLAYERS || !audible[player])
+		return;
+	if (samples > MIXER_SAMPLES_PER_FRAME)
+		samples = MIXER_SAMPLES_PER_FRAME;
+
+	const int16_t* m = matrix[player];
+	int i = 0;
+
+#if defined(MIXER_SSE2)
+	// one madd per output channel handles 4 stereo frames: L*a + R*b
+	const __m128i ml = _mm_set_epi16(m[1], m[0], m[1], m[0], m[1], m[0], m[1], m[0]);
+	const __m128i mr = _mm_set_epi16(m[3], m[2], m[3], m[2], m[3], m[2], m[3], m[2]);
+	for (; i + 4 <= samples; i += 4)
+	{
+		__m128i frames = _mm_loadu_si128((const __m128i*)(stream + i * 2));
+		__m128i l = _mm_srai_epi32(_mm_madd_epi16(frames, ml), MIXER_GAIN_BITS);
+		__m128i r = _mm_srai_epi32(_mm_madd_epi16(frames, mr), MIXER_GAIN_BITS);
+		_mm_storeu_si128((__m128i*)(acc_l + i), _mm_add_epi32(_mm_loadu_si128((const __m128i*)(acc_l + i)), l));
+		_mm_storeu_si128((__m128i*)(acc_r + i), _mm_add_epi32(_mm_loadu_si128((const __m128i*)(acc_r + i)), r));
+	}
+#elif defined(MIXER_NEON)
+	for (; i + 4 <= samples; i += 4)
+	{
+		int16x4x2_t frames = vld2_s16(stream + i * 2);
+		int32x4_t l = vmlal_n_s16(vmull_n_s16(frames.val[0], m[0]), frames.val[1], m[1]);
+		int32x4_t r = vmlal_n_s16(vmull_n_s16(frames.val[0], m[2]), frames.val[1], m[3]);
+		vst1q_s32(acc_l + i, vaddq_s32(vld1q_s32(acc_l + i), vshrq_n_s32(l, MIXER_GAIN_BITS)));
+		vst1q_s32(acc_r + i, vaddq_s32(vld1q_s32(acc_r + i), vshrq_n_s32(r, MIXER_GAIN_BITS)));
+	}
+#endif
+	for (; i < samples; i++)
+	{
+		int32_t l = stream[i * 2];
+		int32_t r = stream[i * 2 + 1];
+		acc_l[i] += (l * m[0] + r * m[1]) >> MIXER_GAIN_BITS;
+		acc_r[i] += (l * m[2] + r * m[3]) >> MIXER_GAIN_BITS;
+	}
+}
+
+int audio_mixer::flush(int16_t* out, int samples)
+{
+	if (samples > MIXER_SAMPLES_PER_FRAME)
+		samples = MIXER_SAMPLES_PER_FRAME;
+
+	int i = 0;
+
+#if defined(MIXER_SSE2)
+	for (; i + 4 <= samples; i += 4)
+	{
+		__m128i l = _mm_loadu_si128((const __m128i*)(acc_l + i));
+		__m128i r = _mm_loadu_si128((const __m128i*)(acc_r + i));
+		// interleave and saturate back to 16 bit
+		__m128i lr = _mm_packs_epi32(_mm_unpacklo_epi32(l, r), _mm_unpackhi_epi32(l, r));
+		_mm_storeu_si128((__m128i*)(out + i * 2), lr);
+	}
+#elif defined(MIXER_NEON)
+	for (; i + 4 <= samples; i += 4)
+	{
+		int16x4x2_t lr;
+		lr.val[0] = vqmovn_s32(vld1q_s32(acc_l + i));
+		lr.val[1] = vqmovn_s32(vld1q_s32(acc_r + i));
+		vst2_s16(out + i * 2, lr);
+	}
+#endif
+	for (; i < samples; i++)
+	{
+		int32_t l = acc_l[i];
+		int32_t r = acc_r[i];
+		out[i * 2] = (int16_t)(l > 32767 ? 32767 : (l < -32768 ? -32768 : l));
+		out[i * 2 + 1] = (int16_t)(r > 32767 ? 32767 : (r < -32768 ? -32768 : r));
+	}
+
+	memset(acc_l, 0, samples * sizeof(int32_t));
+	memset(acc_r, 0, samples * sizeof(int32_t));
+	return samples;
+}
@@ -25,6 +25,7 @@
 cheat::cheat(gb *ref)
 {
 	ref_gb=ref;
+	cheat_map=(int*)ref_gb->alloc_cold(sizeof(int)*0x10000);
 	cheat_list.clear();
 	create_cheat_map();
 }
@@ -32,6 +33,7 @@ cheat::cheat(gb *ref)
 cheat::~cheat()
 {
 	cheat_list.clear();
+	ref_gb->free_cold(cheat_map);
 }
 
 void cheat::clear()
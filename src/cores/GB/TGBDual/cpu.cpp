@@ -22,6 +22,7 @@
 // CPU emulation unit (I/O, IRQ, etc.)
 
 #include <cores/GB/TGBDual/gb.h>
+#include <cores/GB/TGBDual/profiler.h>
 #include <libretro.h>
 #include <string>
 #include <istream>
@@ -49,7 +50,12 @@ void netpacket_poll_receive();
 cpu::cpu(gb *ref)
 {
 	ref_gb=ref;
+	ram=(byte*)ref_gb->alloc_cold(0x2000*4);
+	vram=(byte*)ref_gb->alloc_cold(0x2000*2);
 	b_trace=false;
+	profiler=NULL;
+	prof_next=0;
+	out_ir_signal_que.reserve(2);
 
 	for (int i=0;i<256;i++){
 		z802gb[i]=((i&0x40)?0x80:0)|((i&0x10)?0x20:0)|((i&0x02)?0x40:0)|((i&0x01)?0x10:0);
@@ -61,6 +67,9 @@ cpu::cpu(gb *ref)
 
 cpu::~cpu()
 {
+	ir_signal::release(out_ir_signal_que);
+	ref_gb->free_cold(ram);
+	ref_gb->free_cold(vram);
 }
 
 void cpu::reset()
@@ -90,8 +99,8 @@ void cpu::reset()
 	last_int=0;
 	int_desable=false;
 
-	memset(ram,0,sizeof(ram));
-	memset(vram,0,sizeof(vram));
+	memset(ram,0,0x2000*4);
+	memset(vram,0,0x2000*2);
 	memset(stack,0,sizeof(stack));
 	memset(oam,0,sizeof(oam));
 	memset(spare_oam,0,sizeof(spare_oam));
@@ -145,8 +154,54 @@ void cpu::restore_state_ex(int *dat)
 	total_clock=dat[3];
 }
 
+void cpu::set_profiler(gb_profiler *prof)
+{
+	profiler=prof;
+	if (prof)
+		prof_next=(int)((unsigned)total_clock+prof->get_period());
+}
+
+// 実行中だった命令の PC と、その領域で .sym が使うバンク番号
+// the PC of the instruction that was running and the bank number a .sym file uses for its area
+void cpu::profile_sample(int pc)
+{
+	int period=profiler->get_period();
+	int periods=(int)((unsigned)total_clock-(unsigned)prof_next)/period+1;
+	prof_next=(int)((unsigned)prof_next+(unsigned)(periods*period));
+
+	int bank=0;
+	switch(pc>>12){
+	case 4: case 5: case 6: case 7:
+		bank=(int)((ref_gb->get_mbc()->get_rom()-ref_gb->get_rom()->get_rom())/0x4000)+1;
+		break;
+	case 8: case 9:
+		bank=(int)((vram_bank-vram)/0x2000);
+		break;
+	case 0xA: case 0xB:
+		bank=(int)((ref_gb->get_mbc()->get_sram()-ref_gb->get_rom()->get_sram())/0x2000);
+		break;
+	case 0xD:
+		bank=(int)((ram_bank-ram)/0x1000);
+		break;
+	}
+	profiler->sample(bank,pc,periods);
+}
+
+#ifdef TGB_STATS
+static inline int read_region(word adr)
+{
+	static const int region[8]={STAT_READ_ROM0,STAT_READ_ROM0,STAT_READ_ROMX,STAT_READ_ROMX,STAT_READ_VRAM,STAT_READ_SRAM,STAT_READ_WRAM,STAT_READ_WRAM};
+	if (adr<0xFE00)
+		return region[adr>>13];
+	if (adr<0xFF00)
+		return STAT_READ_OAM;
+	return (adr>=0xFF80&&adr<0xFFFF)?STAT_READ_HRAM:STAT_READ_IO;
+}
+#endif
+
 byte cpu::read_direct(word adr)
 {
+	STAT_INC(ref_gb,read_region(adr));
 	switch(adr>>13){
 	case 0:
 	case 1:
@@ -197,7 +252,9 @@ void cpu::write(word adr,byte dat)
 		ref_gb->get_mbc()->write(adr,dat);
 		break;
 	case 4:
+		ref_gb->get_lcd()->sync();
 		vram_bank[adr&0x1FFF]=dat;
+		ref_gb->get_lcd()->invalidate_tile((int)((vram_bank-vram)/0x2000),adr&0x1FFF);
 		break;
 	case 5:
 		if (ref_gb->get_mbc()->is_ext_ram())
@@ -218,8 +275,11 @@ void cpu::write(word adr,byte dat)
 			else
 				ram[adr&0x0fff]=dat;
 		}
-		else if (adr<0xFEA0)
+		else if (adr<0xFEA0){
+			ref_gb->get_lcd()->sync();
+			ref_gb->get_lcd()->invalidate_sprites();
 			oam[adr-0xFE00]=dat;
+		}
 		else if (adr<0xFF00)
 			spare_oam[(((adr-0xFFA0)>>5)<<3)|(adr&7)]=dat;
 		else if (adr<0xFF80)
@@ -238,7 +298,7 @@ byte cpu::io_read(word adr)
 	switch(adr){
 	case 0xFF00://P1(パッド制御) //P1 (control pad)
 		int tmp;
-		tmp=ref_gb->get_renderer()->check_pad();
+		tmp=ref_gb->check_pad();
 		if (ref_gb->get_regs()->P1==0x03)
 			return 0xff;
 		switch((ref_gb->get_regs()->P1>>4)&0x3){
@@ -342,6 +402,7 @@ byte cpu::io_read(word adr)
 						ref_gb->get_cregs()->RP = ir_state.byte;
 
 						next_ir_clock = total_clock + ref_gb->received_ir_signals[0]->duration;
+						delete ref_gb->received_ir_signals[0];
 						ref_gb->received_ir_signals.erase(ref_gb->received_ir_signals.begin());
 					
 					}
@@ -457,6 +518,7 @@ void cpu::io_write(word adr,byte dat)
 						seri_occer = total_clock + 512 * 8;
             }
 			}
+			ref_gb->publish_link_state();
 			return;
 		case 0xFF04://DIV(ディバイダー) // DIV (divider)
 			ref_gb->get_regs()->DIV=0;
@@ -476,6 +538,7 @@ void cpu::io_write(word adr,byte dat)
 			return;
 		case 0xFF0F://IF(割りこみフラグ) // IF (Interrupt flag)
 			ref_gb->get_regs()->IF=dat;
+			ref_gb->publish_link_state();
 			return;
 		case 0xFF40://LCDC(LCDコントロール) // LCDC (LCD control)
 			if ((dat&0x80)&&(!(ref_gb->get_regs()->LCDC&0x80))){
@@ -508,6 +571,9 @@ void cpu::io_write(word adr,byte dat)
 			ref_gb->get_regs()->LYC=dat;
 			return;
 		case 0xFF46://DMA(DMA転送) // DMA (DMA transfer)
+			STAT_INC(ref_gb,STAT_OAM_DMA);
+			ref_gb->get_lcd()->sync();
+			ref_gb->get_lcd()->invalidate_sprites();
 			switch(dat>>5){
 			case 0:
 			case 1:
@@ -633,7 +699,9 @@ void cpu::io_write(word adr,byte dat)
 				dma_executing=false;
 				dma_rest=0;
 				ref_gb->get_cregs()->HDMA5=0xFF;
+				STAT_INC(ref_gb,STAT_HDMA);
 
+				ref_gb->get_lcd()->sync();
 				switch(dma_src>>13){
 				case 0:
 				case 1:
@@ -657,6 +725,7 @@ void cpu::io_write(word adr,byte dat)
 				case 7:
 					break;
 				}
+				ref_gb->get_lcd()->invalidate_tiles((int)((vram_bank-vram)/0x2000),dma_dest&0x1ff0,16*(dat&0x7F)+16);
 				dma_src+=((dat&0x7F)+1)*16;
 				dma_dest+=((dat&0x7F)+1)*16;
 
@@ -690,6 +759,7 @@ void cpu::io_write(word adr,byte dat)
 
 			if (old_ir_state.bits.ir_light_on != new_ir_state.bits.ir_light_on)
 			{
+				STAT_INC(ref_gb,STAT_IR_EDGES);
 				if (!out_ir_signal_que.empty()) {
 					//correct last duration value
 					int size = out_ir_signal_que.size();
@@ -700,10 +770,11 @@ void cpu::io_write(word adr,byte dat)
 					bool role_has_changed =	!out_ir_signal_que[size - 1]->light_on &&
 											out_ir_signal_que[size - 1]->duration > 45000;
 					if (!role_has_changed) {
-						ref_gb->send_ir_signal(out_ir_signal_que[size - 1]);
 						log_ir_traffic(out_ir_signal_que[size - 1], false);
+						ref_gb->send_ir_signal(out_ir_signal_que[size - 1]);
+						out_ir_signal_que.pop_back(); // 受け手のものになった // the receiver owns it now
 					}
-						
+					ir_signal::release(out_ir_signal_que);
 				}
 
 				//add signal to out queu
@@ -715,6 +786,7 @@ void cpu::io_write(word adr,byte dat)
 			ref_gb->get_cregs()->BCPS=dat;
 			return;
 		case 0xFF69://BCPD(BGパレット書きこみデータ xBBBBBGG GGGRRRRR) // (write BG palette data xBBBBBGG GGGRRRR)
+			ref_gb->get_lcd()->sync();
 			if (ref_gb->get_cregs()->BCPS&1){
 				ref_gb->get_lcd()->get_pal((ref_gb->get_cregs()->BCPS>>3)&7)[(ref_gb->get_cregs()->BCPS>>1)&3]=
 				(ref_gb->get_lcd()->get_pal((ref_gb->get_cregs()->BCPS>>3)&7)[(ref_gb->get_cregs()->BCPS>>1)&3]&0xff)|(dat<<8);
@@ -742,6 +814,7 @@ void cpu::io_write(word adr,byte dat)
 			ref_gb->get_cregs()->OCPS=dat;
 			return;
 		case 0xFF6B://OCPD(OBJパレット書きこみデータ) // OCPD (Write data OBJ palette)
+			ref_gb->get_lcd()->sync();
 			if (ref_gb->get_cregs()->OCPS&1){
 				ref_gb->get_lcd()->get_pal(((ref_gb->get_cregs()->OCPS>>3)&7)+8)[(ref_gb->get_cregs()->OCPS>>1)&3]=
 				(ref_gb->get_lcd()->get_pal(((ref_gb->get_cregs()->OCPS>>3)&7)+8)[(ref_gb->get_cregs()->OCPS>>1)&3]&0xff)|(dat<<8);
@@ -775,6 +848,7 @@ void cpu::io_write(word adr,byte dat)
 
 		case 0xFFFF://IE(割りこみマスク) // IE (Interrupt mask)
 			ref_gb->get_regs()->IE=dat;
+			ref_gb->publish_link_state();
 //			ref_gb->get_regs()->IF=0;
 //			fprintf(file,"IE = %02X\n",in_data);
 			return;
@@ -938,10 +1012,12 @@ byte cpu::receive_from_linkcable(byte in_data)
 
 	byte out_data = ref_gb->get_regs()->SB;
 	log_link_traffic(in_data, out_data);
+	STAT_INC(ref_gb,STAT_SERIAL_BYTES);
 
 	ref_gb->get_regs()->SB = in_data;
 	ref_gb->get_regs()->SC &= 1;
 	irq(INT_SERIAL);
+	ref_gb->publish_link_state();
 	return out_data;
 
 	
@@ -1034,6 +1110,7 @@ void cpu::irq_process()
 			regs.PC=0x58;
 			ref_gb->get_regs()->IF&=0xF7;
 			last_int=INT_SERIAL;
+			ref_gb->publish_link_state();
 		}
 		else if (ref_gb->get_regs()->IF&ref_gb->get_regs()->IE&INT_PAD){//Pad
 			regs.PC=0x60;
@@ -1049,6 +1126,18 @@ void cpu::irq_process()
 }
 
 void cpu::exec(int clocks)
+{
+	STAT_TIMER(ref_gb,STAT_TIME_CPU_EXEC);
+
+	// プロファイラ無しのループにはフックを入れない // the unprofiled loop carries no profiler hook
+	if (profiler)
+		exec_loop<true>(clocks);
+	else
+		exec_loop<false>(clocks);
+}
+
+template <bool profile>
+void cpu::exec_loop(int clocks)
 {
 	if (speed)
 		clocks*=2;
@@ -1085,8 +1174,10 @@ void cpu::exec(int clocks)
 	while(rest_clock>0){
 		irq_process();
 
+		word op_pc=regs.PC;
 		op_code=op_read();
 		tmp_clocks=cycles[op_code];
+		STAT_INC(ref_gb,STAT_INSTRUCTIONS);
 
 //		if (b_trace)
 //			log();
@@ -1107,6 +1198,9 @@ void cpu::exec(int clocks)
 		div_clock+=tmp_clocks;
 		total_clock+=tmp_clocks;
 
+		if (profile&&(int)((unsigned)total_clock-(unsigned)prof_next)>=0)
+			profile_sample(op_pc);
+
 		if (ref_gb->get_regs()->TAC&0x04){//タイマ割りこみ // Timer interrupt
 			sys_clock+=tmp_clocks;
 			if (sys_clock>timer_clocks[ref_gb->get_regs()->TAC&0x03]){
@@ -1128,6 +1222,7 @@ void cpu::exec(int clocks)
 		
 		if (total_clock>seri_occer){
 			seri_occer=0x7fffffff;
+			STAT_INC(ref_gb,STAT_SERIAL_BYTES);
 
 			//new netpacket feature for pokemon
 			if (emulated_gbs == 1 && (num_clients == 1 || my_client_id == 1)) {
@@ -1157,6 +1252,7 @@ void cpu::exec(int clocks)
 				}
 			}
 			irq(INT_SERIAL);
+			ref_gb->publish_link_state();
 		}
 
 		/*
@@ -1177,7 +1273,31 @@ void cpu::exec(int clocks)
 	}
 }
 
-void cpu::serialize(serializer &s)
+template <bool load> void cpu::transfer_state(cpu_state &st)
+{
+	s_FIELD(que_cur);
+
+	s_FIELD(total_clock);
+	s_FIELD(rest_clock);
+	s_FIELD(sys_clock);
+	s_FIELD(div_clock);
+	s_FIELD(seri_occer);
+
+	s_FIELD(halt);
+	s_FIELD(speed);
+	s_FIELD(speed_change);
+	s_FIELD(dma_executing);
+
+	s_FIELD(dma_src);
+	s_FIELD(dma_dest);
+	s_FIELD(dma_rest);
+	s_FIELD(gdma_rest);
+	s_FIELD(b_dma_first);
+
+	s_FIELD(_ff6c); s_FIELD(_ff72); s_FIELD(_ff73); s_FIELD(_ff74); s_FIELD(_ff75);
+}
+
+template <class S> void cpu::serialize(S &s)
 {
 	int tmp;
 
@@ -1187,8 +1307,8 @@ void cpu::serialize(serializer &s)
 	s_VAR(regs);
 
 	if (ref_gb->get_rom()->get_info()->gb_type >= 3) { // GB: 1, SGB: 2, GBC: 3...
-		s_ARRAY(ram);
-		s_ARRAY(vram);
+		s.process(ram, 0x2000*4);
+		s.process(vram,0x2000*2);
 	} else {
 		s.process(ram, 0x2000);
 		s.process(vram,0x2000);
@@ -1200,29 +1320,14 @@ void cpu::serialize(serializer &s)
 	s_ARRAY(spare_oam);
 	s_ARRAY(ext_mem);
 	s_ARRAY(rp_que);
-	s_VAR(que_cur);
-
-	s_VAR(total_clock);
-	s_VAR(rest_clock);
-	s_VAR(sys_clock);
-	s_VAR(div_clock);
-	s_VAR(seri_occer); // nor was this
-
-	s_VAR(halt);
-	s_VAR(speed);
-	s_VAR(speed_change);
-	s_VAR(dma_executing);
-
-	s_VAR(dma_src);
-	s_VAR(dma_dest);
-	s_VAR(dma_rest);
-	s_VAR(gdma_rest); // or these
-	s_VAR(b_dma_first); // two.
-
-	// undocumented registers:
-	s_VAR(_ff6c); s_VAR(_ff72); s_VAR(_ff73); s_VAR(_ff74); s_VAR(_ff75);
+
+	// que_cur, the clocks, dma and the undocumented registers (_ff6c.._ff75)
+	cpu_state st;
+	s_BLOCK(st);
 }
 
+SERIALIZE_INSTANTIATE(cpu);
+
 
 
 
@@ -27,8 +27,17 @@
 
 #include <cores/GB/TGBDual/dmy_renderer.h>
 #include <cores/GB/TGBDual/gb.h>
+#include <cores/GB/TGBDual/audio_mixer.h>
 #include "libretro.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define GHOSTING_SSE2
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define GHOSTING_NEON
+#endif
+
 extern std::vector<gb* > v_gb;
 extern int emulated_gbs;
 extern int max_gbs; 
@@ -54,7 +63,7 @@ extern bool gblink_enable;
 extern int audio_2p_mode;
 
 #define MSG_FRAMES 60
-#define SAMPLES_PER_FRAME (44100/60)
+#define SAMPLES_PER_FRAME MIXER_SAMPLES_PER_FRAME
 
 extern bool _screen_vertical;
 extern bool _screen_4p_split; 
@@ -63,6 +72,17 @@ extern bool libretro_supports_bitmasks;
 extern int _show_player_screen; // 0 = p1 only, 1 = p2 only, 2 = both players
 
 std::array<word, GRADIENT_STEPS> blended_palette;
+std::array<byte, 0x10000> blended_palette_index;
+
+// 合成中のフレームに変化があったか (表示するインスタンスのどれかのラインが変わった)
+// whether any shown instance changed a line since the last frame was handed to the frontend
+static bool frame_changed = true;
+static bool frontend_can_dupe = false;
+// 画面配置が変わるたびに増える // bumped whenever the screen layout changes
+static int layout_key = -1;
+static int layout_serial = 0;
+// フロントエンドがこのフレームの映像を使うか // whether the frontend shows this frame's video at all
+static bool video_enabled = true;
 
 
 static inline void temperature_tint(double temperature, double* r, double* g, double* b)
@@ -99,9 +119,126 @@ dmy_renderer::dmy_renderer(int which)
       log_cb(RETRO_LOG_INFO, "Frontend supports RGB565; will use that instead of XRGB1555.\n");
 #endif
 
+   if (!environ_cb(RETRO_ENVIRONMENT_GET_CAN_DUPE, &frontend_can_dupe))
+      frontend_can_dupe = false;
+
    //gradient for DMG LCD Ghosting effect
    generateGradient();
    std::fill_n(last_frame, 160 * 144, 0xFFFF);
+   memset(line_age, 0, sizeof(line_age));
+   memset(line_dirty, 1, sizeof(line_dirty));
+   ghosting = false;
+   composed_layout = -1;
+   pending_audio = 0;
+   pending_screen = false;
+   pending_width = pending_height = pending_depth = 0;
+}
+
+void dmy_renderer::blendFrame(const word* frame, word* out, word* prev, int count)
+{
+    int i = 0;
+
+    if (ghosting_mode == GhostingMode::RGB565_BLEND)
+    {
+        // per channel (a + b) >> 1 without unpacking: (a & b) + (((a ^ b) & ~lsb) >> 1)
+#if defined(GHOSTING_SSE2)
+        const __m128i mask = _mm_set1_epi16((short)0xF7DE);
+        for (; i + 8 <= count; i += 8) {
+            __m128i cur = _mm_loadu_si128((const __m128i*)(frame + i));
+            __m128i last = _mm_loadu_si128((const __m128i*)(prev + i));
+            __m128i half = _mm_srli_epi16(_mm_and_si128(_mm_xor_si128(cur, last), mask), 1);
+            _mm_storeu_si128((__m128i*)(prev + i), cur);
+            _mm_storeu_si128((__m128i*)(out + i), _mm_add_epi16(_mm_and_si128(cur, last), half));
+        }
+#elif defined(GHOSTING_NEON)
+        const uint16x8_t mask = vdupq_n_u16(0xF7DE);
+        for (; i + 8 <= count; i += 8) {
+            uint16x8_t cur = vld1q_u16(frame + i);
+            uint16x8_t last = vld1q_u16(prev + i);
+            uint16x8_t half = vshrq_n_u16(vandq_u16(veorq_u16(cur, last), mask), 1);
+            vst1q_u16(prev + i, cur);
+            vst1q_u16(out + i, vaddq_u16(vandq_u16(cur, last), half));
+        }
+#endif
+        for (; i < count; ++i) {
+            word cur = frame[i];
+            word last = prev[i];
+            prev[i] = cur;
+            out[i] = (cur & last) + (((cur ^ last) & 0xF7DE) >> 1);
+        }
+        return;
+    }
+
+    // palette blend: two table lookups per pixel, no float math
+    for (; i < count; ++i) {
+        word cur = frame[i];
+        int blended_index = (blended_palette_index[prev[i]] + blended_palette_index[cur]) >> 1;
+        prev[i] = cur;
+        out[i] = blended_palette[blended_index];
+    }
+}
+
+void dmy_renderer::track_lines(word* frame, int width, int height)
+{
+    int key = emulated_gbs | (_number_of_local_screens << 5) | ((_show_player_screen & 0x1F) << 8) |
+        (_screen_vertical << 13) | (_screen_4p_split << 14) | (_screen_switched << 15) |
+        (is_gbc_rom << 16) | (gbc_lcd_interlacing_enabled << 17);
+    if (key != layout_key)
+    {
+        layout_key = key;
+        layout_serial++;
+    }
+
+    // 新しい配置では合成先が古いので全部描き直す。インターレースは合成先をその場で書き換えるので毎回全部
+    // a new layout leaves stale joined buffers, and interlacing rewrites them in place every frame
+    bool full = composed_layout != layout_serial || (is_gbc_rom && gbc_lcd_interlacing_enabled);
+    composed_layout = layout_serial;
+
+    ghosting = !is_gbc_rom && emulated_gbs == 1 && (_number_of_local_screens == 1 || _show_player_screen == emulated_gbs);
+
+    bool changed = false;
+    for (int y = 0; y < height; y++)
+    {
+        word* row = frame + y * width;
+        word* prev = last_frame + y * width;
+        if (full || memcmp(row, prev, width * sizeof(word)) != 0)
+            line_age[y] = 0;
+        else if (line_age[y] < 255)
+            line_age[y]++;
+
+        if (ghosting)
+        {
+            // ゴーストは直前の 2 フレームを混ぜるので、止まってから 1 フレーム後に落ち着く
+            // ghosting mixes the last two frames, so a line settles one frame after it stopped changing
+            line_dirty[y] = line_age[y] < 2;
+            if (line_dirty[y])
+                blendFrame(row, ghost_frame + y * width, prev, width);
+        }
+        else
+        {
+            line_dirty[y] = line_age[y] == 0;
+            if (line_dirty[y])
+                memcpy(prev, row, width * sizeof(word));
+        }
+        changed |= line_dirty[y];
+    }
+
+    if (changed && frame_wanted())
+        frame_changed = true;
+}
+
+void dmy_renderer::copy_lines(byte* dst, int dst_pitch, const byte* src, int pitch, int height)
+{
+    for (int row = 0; row < height; ++row)
+        if (line_dirty[row])
+            memcpy(dst + dst_pitch * row, src + pitch * row, pitch);
+}
+
+void dmy_renderer::present_frame(const void* data, unsigned width, unsigned height, size_t pitch)
+{
+    // NULL: フロントエンドに前のフレームをそのまま使わせる // NULL lets the frontend show the previous frame again
+    video_cb(frame_changed || !frontend_can_dupe ? data : NULL, width, height, pitch);
+    frame_changed = false;
 }
 
 word dmy_renderer::map_color(word gb_col)
@@ -271,57 +408,42 @@ word dmy_renderer::unmap_color(word gb_col)
 }
 
 void dmy_renderer::refresh() {
-   static int16_t stream[SAMPLES_PER_FRAME*2];
-   // static int16_t stream[SAMPLES_PER_FRAME];
+   // the mixer and the frontend are only touched in flush_output()
+   if (pending_audio >= DMY_PENDING_FRAMES)
+   {
+      this->snd_render->skip();
+      return;
+   }
 
-   
-   //if (v_gb[1] && gblink_enable)
-   //if (emulated_gbs > 1)
-   if(true)
+   // audible only changes in begin_frame(), never while instances run
+   if (gb_audio_mixer.is_audible(which_gb))
+      this->snd_render->render(stream + pending_audio * SAMPLES_PER_FRAME * 2, SAMPLES_PER_FRAME);
+   else
+      this->snd_render->skip();
+   pending_audio++;
+}
+
+void dmy_renderer::flush_output() {
+   // every instance feeds the shared mixer, the last one hands the mix to the frontend
+   for (int i = 0; i < pending_audio; i++)
    {
-        /*
-      // if dual gb mode
-      if (audio_2p_mode == 2)
+      int16_t* frame = stream + i * SAMPLES_PER_FRAME * 2;
+      if (gb_audio_mixer.is_audible(which_gb))
+         gb_audio_mixer.add(which_gb, frame, SAMPLES_PER_FRAME);
+
+      if (which_gb >= (emulated_gbs-1))
       {
-         // mix down to one per channel (dual mono)
-         int16_t tmp_stream[SAMPLES_PER_FRAME*2];
-         this->snd_render->render(tmp_stream, SAMPLES_PER_FRAME);
-         for(int i = 0; i < SAMPLES_PER_FRAME; ++i)
-         {
-            int l = tmp_stream[(i*2)+0], r = tmp_stream[(i*2)+1];
-            stream[(i*2)+which_gb] = int16_t( (l+r) / 2 );
-         }
+         gb_audio_mixer.flush(frame, SAMPLES_PER_FRAME);
+         audio_batch_cb(frame, SAMPLES_PER_FRAME);
       }
-      else if (audio_2p_mode == which_gb)
-      */
-
-       if (audio_2p_mode == which_gb)
-       {
-           // only play gb 0 or 1
-           
-           this->snd_render->render(stream, SAMPLES_PER_FRAME);
-           audio_batch_cb(stream, SAMPLES_PER_FRAME);
-      
-           memset(stream, 0, sizeof(stream));
-       
-       }
-       if (which_gb >= (emulated_gbs-1))
-       {
-         // only do audio callback after both gb's are rendered.
-         //audio_batch_cb(stream, SAMPLES_PER_FRAME);
-
-         //audio_2p_mode &= 3;
-         //memset(stream, 0, sizeof(stream));
-        }
    }
-   else
+   pending_audio = 0;
+
+   if (pending_screen)
    {
-      this->snd_render->render(stream, SAMPLES_PER_FRAME);
-      audio_batch_cb(stream, SAMPLES_PER_FRAME); 
+      pending_screen = false;
+      compose_screen((byte*)pending_frame, pending_width, pending_height, pending_depth);
    }
-   fixed_time = time(NULL);
-
-   
 }
 
 int dmy_renderer::check_pad()
@@ -352,7 +474,18 @@ int dmy_renderer::check_pad()
 
 
 
+// vframe が次のフレームで書き換わる前に写しておく (lcd::sync() はフレームの途中でも描く)
+// copy the frame before the next one overwrites vframe, lcd::sync() can draw mid frame
 void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
+{
+    memcpy(pending_frame, buf, (size_t)width * height * ((depth + 7) / 8));
+    pending_width = width;
+    pending_height = height;
+    pending_depth = depth;
+    pending_screen = true;
+}
+
+void dmy_renderer::compose_screen(byte* buf, int width, int height, int depth)
 {
     static byte joined_buf[160*144*2*2]; // two screens' worth of 16-bit data
     static byte joined_buf3[160 * 144 * 3 * 2]; // three screens' worth of 16-bit data
@@ -368,6 +501,8 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
     if (_screen_switched)
         switched_gb = 1 - switched_gb;
 
+    track_lines(reinterpret_cast<word*>(buf), width, height);
+
    
     if (_number_of_local_screens == 1 || _show_player_screen == emulated_gbs)
     {
@@ -384,20 +519,12 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
             if (!is_gbc_rom)
             {
                 //DMG Ghosting Effect
-                // Cast buf to 16-bit to work with 16-bit color values
-                word* frame_buffer = reinterpret_cast<word*>(buf);
-
-                for (int i = 0; i < width * height; ++i) {
-                    word blended = blendPixels(last_frame[i], frame_buffer[i]);
-                    last_frame[i] = frame_buffer[i]; // Update last_frame direkt
-                    frame_buffer[i] = blended;        // Überschreibe buf sofort
-                }
-
-                video_cb(reinterpret_cast<byte*>(frame_buffer), width, height, pitch);
+                // track_lines() has already blended the changed lines into ghost_frame
+                present_frame(ghost_frame, width, height, pitch);
                 break; 
             }
 
-            video_cb(buf, width, height, pitch);
+            present_frame(buf, width, height, pitch);
             break;
       
         }
@@ -408,21 +535,20 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
             {
                 if (_screen_vertical)
                 {
-                    memcpy(joined_buf + switched_gb * size_single_screen, buf, size_single_screen);
+                    copy_lines(joined_buf + switched_gb * size_single_screen, pitch, buf, pitch, height);
                     if (which_gb == 1)
-                        video_cb(joined_buf, width, height * 2, pitch);
+                        present_frame(joined_buf, width, height * 2, pitch);
                 }
                 else
                 {
-                    for (int row = 0; row < height; ++row)
-                        memcpy(joined_buf + pitch * (2 * row + switched_gb), buf + pitch * row, pitch);
+                    copy_lines(joined_buf + pitch * switched_gb, pitch * 2, buf, pitch, height);
                     if (which_gb == 1) {
                         //experimental GBC LCD interlacing effect
                         if (is_gbc_rom && gbc_lcd_interlacing_enabled)
                         {
                             add_gbc_interlacing_effect(joined_buf, width*2, height, pitch * 2);
                         }
-                        video_cb(joined_buf, width * 2, height, pitch * 2);
+                        present_frame(joined_buf, width * 2, height, pitch * 2);
                     }
                 }
 
@@ -432,14 +558,14 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                 // are we currently on the gb that we want to draw?
                 // (this ignores the "switch player screens" setting)
                 if (_show_player_screen == which_gb)
-                    memcpy(joined_buf, buf, size_single_screen);
+                    copy_lines(joined_buf, pitch, buf, pitch, height);
                 if (which_gb == (emulated_gbs - 1)) {
                     //experimental GBC LCD interlacing effect
                     if (is_gbc_rom && gbc_lcd_interlacing_enabled)
                     {
                         add_gbc_interlacing_effect(joined_buf, width, height, pitch);
                     }
-                    video_cb(joined_buf, width, height, pitch);
+                    present_frame(joined_buf, width, height, pitch);
                 }
             }
 
@@ -451,12 +577,10 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                 if (_screen_4p_split)
                 {
                     if (which_gb < 2) {
-                        for (int row = 0; row < height; ++row)
-                            memcpy(joined_buf4 + pitch * (2 * row + switched_gb), buf + pitch * row, pitch);
+                        copy_lines(joined_buf4 + pitch * switched_gb, pitch * 2, buf, pitch, height);
                     }
                     else if (which_gb < 4) {
-                        for (int row = 0; row < height; ++row)
-                            memcpy(joined_buf + pitch * (2 * row + switched_gb), buf + pitch * row, pitch);
+                        copy_lines(joined_buf + pitch * switched_gb, pitch * 2, buf, pitch, height);
                     }
                     if (which_gb == 2) {
                         memcpy(joined_buf4 + sizeof(joined_buf), joined_buf, sizeof(joined_buf));
@@ -465,33 +589,32 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                         {
                             add_gbc_interlacing_effect(joined_buf4, width* 2, height* 2, pitch* 2);
                         }
-                        video_cb(joined_buf4, width * 2, height * 2, pitch * 2);
+                        present_frame(joined_buf4, width * 2, height * 2, pitch * 2);
                     }
                 }
                 else if (_screen_vertical)
                 {
-                    memcpy(joined_buf3 + switched_gb * size_single_screen, buf, size_single_screen);
+                    copy_lines(joined_buf3 + switched_gb * size_single_screen, pitch, buf, pitch, height);
                     if (which_gb == 2) {
                         //experimental GBC LCD interlacing effect
                         if (is_gbc_rom && gbc_lcd_interlacing_enabled)
                         {
                             add_gbc_interlacing_effect(joined_buf3, width, height * 3, pitch);
                         }
-                        video_cb(joined_buf3, width, height * 3, pitch);
+                        present_frame(joined_buf3, width, height * 3, pitch);
                     }
                        
                 }
                 else
                 {
-                    for (int row = 0; row < height; ++row)
-                        memcpy(joined_buf3 + pitch * (3 * row + switched_gb), buf + pitch * row, pitch);
+                    copy_lines(joined_buf3 + pitch * switched_gb, pitch * 3, buf, pitch, height);
                     if (which_gb == 2) {
                         //experimental GBC LCD interlacing effect
                         if (is_gbc_rom && gbc_lcd_interlacing_enabled)
                         {
                             add_gbc_interlacing_effect(joined_buf3, width*3, height, pitch * 3);
                         }
-                        video_cb(joined_buf3, width * 3, height, pitch * 3);
+                        present_frame(joined_buf3, width * 3, height, pitch * 3);
                     }
                        
                 }
@@ -501,14 +624,14 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                 // are we currently on the gb that we want to draw?
                 // (this ignores the "switch player screens" setting)
                 if (_show_player_screen == which_gb)
-                    memcpy(joined_buf, buf, size_single_screen);
+                    copy_lines(joined_buf, pitch, buf, pitch, height);
                 if (which_gb == emulated_gbs) {
                     //experimental GBC LCD interlacing effect
                     if (is_gbc_rom && gbc_lcd_interlacing_enabled)
                     {
                         add_gbc_interlacing_effect(joined_buf, width, height, pitch);
                     }
-                    video_cb(joined_buf, width, height, pitch);
+                    present_frame(joined_buf, width, height, pitch);
                 }
                    
             }
@@ -523,12 +646,10 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                 if (_screen_4p_split)
                 {
                     if (which_gb < 2) {
-                        for (int row = 0; row < height; ++row)
-                            memcpy(joined_buf4 + pitch * (2 * row + switched_gb), buf + pitch * row, pitch);
+                        copy_lines(joined_buf4 + pitch * switched_gb, pitch * 2, buf, pitch, height);
                     }
                     else if (which_gb < 4) {
-                        for (int row = 0; row < height; ++row)
-                            memcpy(joined_buf + pitch * (2 * row + switched_gb), buf + pitch * row, pitch);
+                        copy_lines(joined_buf + pitch * switched_gb, pitch * 2, buf, pitch, height);
                     }
                     if (which_gb == 3) {
                         memcpy(joined_buf4 + sizeof(joined_buf), joined_buf, sizeof(joined_buf));
@@ -536,32 +657,31 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                         {
                             add_gbc_interlacing_effect(joined_buf4, width * 2, height* 2, pitch * 2);
                         }
-                        video_cb(joined_buf4, width * 2, height * 2, pitch * 2);
+                        present_frame(joined_buf4, width * 2, height * 2, pitch * 2);
                     }
                 }
 
                 else if (_screen_vertical)
                 {
-                    memcpy(joined_buf4 + switched_gb * size_single_screen, buf, size_single_screen);
+                    copy_lines(joined_buf4 + switched_gb * size_single_screen, pitch, buf, pitch, height);
                     if (which_gb == emulated_gbs - 1) {
                         if (is_gbc_rom && gbc_lcd_interlacing_enabled)
                         {
                             add_gbc_interlacing_effect(joined_buf4, width, height * emulated_gbs, pitch);
                         }
-                        video_cb(joined_buf4, width, height * emulated_gbs, pitch);
+                        present_frame(joined_buf4, width, height * emulated_gbs, pitch);
                     }
                        
                 }
                 else
                 {
-                    for (int row = 0; row < height; ++row)
-                        memcpy(joined_buf4 + pitch * (emulated_gbs * row + switched_gb), buf + pitch * row, pitch);
+                    copy_lines(joined_buf4 + pitch * switched_gb, pitch * emulated_gbs, buf, pitch, height);
                     if (which_gb == emulated_gbs - 1) {
                         if (is_gbc_rom && gbc_lcd_interlacing_enabled)
                         {
                             add_gbc_interlacing_effect(joined_buf4, width* emulated_gbs, height, pitch* emulated_gbs);
                         }
-                        video_cb(joined_buf4, width* emulated_gbs, height, pitch* emulated_gbs);
+                        present_frame(joined_buf4, width* emulated_gbs, height, pitch* emulated_gbs);
                     }
                        
                 }
@@ -571,14 +691,14 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                 // are we currently on the gb that we want to draw?
                 // (this ignores the "switch player screens" setting)
                 if (_show_player_screen == which_gb)
-                    memcpy(joined_buf, buf, size_single_screen);
+                    copy_lines(joined_buf, pitch, buf, pitch, height);
                 if (which_gb == (emulated_gbs - 1))
                 {
                     if (is_gbc_rom && gbc_lcd_interlacing_enabled)
                     {
                         add_gbc_interlacing_effect(joined_buf, width, height, pitch);
                     }
-                    video_cb(joined_buf, width, height, pitch);
+                    present_frame(joined_buf, width, height, pitch);
                 }
             }
 
@@ -595,8 +715,7 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                 if (_screen_4p_split)
                 {
                     if (which_gb < 3) {
-                        for (int row = 0; row < height; ++row)
-                            memcpy(joined_buf9 + pitch * (3 * row + switched_gb), buf + pitch * row, pitch);
+                        copy_lines(joined_buf9 + pitch * switched_gb, pitch * 3, buf, pitch, height);
                     }
                     else if (which_gb < 6) {
                         for (int row = 0; row < height; ++row)
@@ -618,22 +737,21 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
 
                     if (which_gb == (emulated_gbs - 1)) {
                         //memcpy(joined_buf16 + sizeof(joined_buf8), joined_buf8, sizeof(joined_buf8));
-                        video_cb(joined_buf9, width * 3, height * 3, pitch * 3);
+                        present_frame(joined_buf9, width * 3, height * 3, pitch * 3);
                     }
                 }
 
                 else if (_screen_vertical)
                 {
-                    memcpy(joined_buf16 + switched_gb * size_single_screen, buf, size_single_screen);
+                    copy_lines(joined_buf16 + switched_gb * size_single_screen, pitch, buf, pitch, height);
                     if (which_gb == emulated_gbs - 1)
-                        video_cb(joined_buf16, width, height * emulated_gbs, pitch);
+                        present_frame(joined_buf16, width, height * emulated_gbs, pitch);
                 }
                 else
                 {
-                    for (int row = 0; row < height; ++row)
-                        memcpy(joined_buf16 + pitch * (emulated_gbs * row + switched_gb), buf + pitch * row, pitch);
+                    copy_lines(joined_buf16 + pitch * switched_gb, pitch * emulated_gbs, buf, pitch, height);
                     if (which_gb == emulated_gbs - 1)
-                        video_cb(joined_buf16, width * emulated_gbs, height, pitch * emulated_gbs);
+                        present_frame(joined_buf16, width * emulated_gbs, height, pitch * emulated_gbs);
                 }
             }
             else
@@ -641,9 +759,9 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                 // are we currently on the gb that we want to draw?
                 // (this ignores the "switch player screens" setting)
                 if (_show_player_screen == which_gb)
-                    memcpy(joined_buf, buf, size_single_screen);
+                    copy_lines(joined_buf, pitch, buf, pitch, height);
                 if (which_gb == (emulated_gbs - 1))
-                    video_cb(joined_buf, width, height, pitch);
+                    present_frame(joined_buf, width, height, pitch);
             }
 
             break;
@@ -662,8 +780,7 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                 if (_screen_4p_split)
                 {
                     if (which_gb < 4) {
-                        for (int row = 0; row < height; ++row)
-                            memcpy(joined_buf16 + pitch * (4 * row + switched_gb), buf + pitch * row, pitch);
+                        copy_lines(joined_buf16 + pitch * switched_gb, pitch * 4, buf, pitch, height);
                     }
                     else if (which_gb < 8) {
                         for (int row = 0; row < height; ++row)
@@ -684,7 +801,7 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                         /*
                         if (which_gb == (emulated_gbs - 1)) {
                             //memcpy(joined_buf16 + sizeof(joined_buf8), joined_buf8, sizeof(joined_buf8));
-                            video_cb(joined_buf16, width * 4, height * 4, pitch * 4);
+                            present_frame(joined_buf16, width * 4, height * 4, pitch * 4);
                         }*/
 
                     }
@@ -696,22 +813,21 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                     }
                     if (which_gb == (emulated_gbs - 1)) {
                         //memcpy(joined_buf16 + sizeof(joined_buf8), joined_buf8, sizeof(joined_buf8));
-                        video_cb(joined_buf16, width * 4, height * 4, pitch * 4);
+                        present_frame(joined_buf16, width * 4, height * 4, pitch * 4);
                     }
                 }
 
                 else if (_screen_vertical)
                 {
-                    memcpy(joined_buf16 + switched_gb * size_single_screen, buf, size_single_screen);
+                    copy_lines(joined_buf16 + switched_gb * size_single_screen, pitch, buf, pitch, height);
                     if (which_gb == emulated_gbs - 1)
-                        video_cb(joined_buf16, width, height * emulated_gbs, pitch);
+                        present_frame(joined_buf16, width, height * emulated_gbs, pitch);
                 }
                 else
                 {
-                    for (int row = 0; row < height; ++row)
-                        memcpy(joined_buf16 + pitch * (emulated_gbs * row + switched_gb), buf + pitch * row, pitch);
+                    copy_lines(joined_buf16 + pitch * switched_gb, pitch * emulated_gbs, buf, pitch, height);
                     if (which_gb == emulated_gbs - 1)
-                        video_cb(joined_buf16, width * emulated_gbs, height, pitch * emulated_gbs);
+                        present_frame(joined_buf16, width * emulated_gbs, height, pitch * emulated_gbs);
                 }
             }
             else
@@ -719,9 +835,9 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
                 // are we currently on the gb that we want to draw?
                 // (this ignores the "switch player screens" setting)
                 if (_show_player_screen == which_gb)
-                    memcpy(joined_buf, buf, size_single_screen);
+                    copy_lines(joined_buf, pitch, buf, pitch, height);
                 if (which_gb == (emulated_gbs - 1))
-                    video_cb(joined_buf, width, height, pitch);
+                    present_frame(joined_buf, width, height, pitch);
             }
 
 
@@ -739,16 +855,15 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
             {
                 if (_screen_vertical)
                 {
-                    memcpy(joined_buf + switched_gb * size_single_screen, buf, size_single_screen);
+                    copy_lines(joined_buf + switched_gb * size_single_screen, pitch, buf, pitch, height);
                     if (which_gb == _show_player_screen + 1)
-                        video_cb(joined_buf, width, height * 2, pitch);
+                        present_frame(joined_buf, width, height * 2, pitch);
                 }
                 else
                 {
-                    for (int row = 0; row < height; ++row)
-                        memcpy(joined_buf + pitch * (2 * row + switched_gb), buf + pitch * row, pitch);
+                    copy_lines(joined_buf + pitch * switched_gb, pitch * 2, buf, pitch, height);
                     if (which_gb == _show_player_screen + 1)
-                        video_cb(joined_buf, width * 2, height, pitch * 2);
+                        present_frame(joined_buf, width * 2, height, pitch * 2);
                 }
 
             }
@@ -759,49 +874,37 @@ void dmy_renderer::render_screen(byte* buf, int width, int height, int depth)
     }
 }
 
-byte dmy_renderer::get_time(int type)
+// render_screen() と同じ条件で、このインスタンスの画面が使われるか
+// Mirrors the screen selection in render_screen(): is this instance's frame shown at all
+bool dmy_renderer::frame_wanted()
 {
-   dword now = fixed_time-cur_time;
+    if (!video_enabled)
+        return false;
+    if (emulated_gbs == 1 || _show_player_screen == emulated_gbs)
+        return true;
+    if (_number_of_local_screens == 2)
+        return which_gb == _show_player_screen || which_gb == _show_player_screen + 1;
+    return which_gb == _show_player_screen;
+}
 
-   switch(type)
-   {
-      case 8: // second
-         return (byte)(now%60);
-      case 9: // minute
-         return (byte)((now/60)%60);
-      case 10: // hour
-         return (byte)((now/(60*60))%24);
-      case 11: // day (L)
-         return (byte)((now/(24*60*60))&0xff);
-      case 12: // day (H)
-         return (byte)((now/(256*24*60*60))&1);
-   }
-   return 0;
+void dmy_renderer::begin_frame()
+{
+    gb_audio_mixer.apply_mode(audio_2p_mode, emulated_gbs);
+
+    int av = 3;
+    // 対応していないフロントエンドは常に表示する // frontends without the call always show the frame
+    if (!environ_cb(RETRO_ENVIRONMENT_GET_AUDIO_VIDEO_ENABLE, &av))
+        av = 3;
+    video_enabled = (av & 1) != 0;
 }
 
-void dmy_renderer::set_time(int type,byte dat)
+byte dmy_renderer::get_time(int type)
 {
-   dword now = fixed_time;
-   dword adj = now - cur_time;
+   return clock.get(type);
+}
 
-   switch(type)
-   {
-      case 8: // second
-         adj = (adj/60)*60+(dat%60);
-         break;
-      case 9: // minute
-         adj = (adj/(60*60))*60*60+(dat%60)*60+(adj%60);
-         break;
-      case 10: // hour
-         adj = (adj/(24*60*60))*24*60*60+(dat%24)*60*60+(adj%(60*60));
-         break;
-      case 11: // day (L)
-         adj = (adj/(256*24*60*60))*256*24*60*60+(dat*24*60*60)+(adj%(24*60*60));
-         break;
-      case 12: // day (H)
-         adj = (dat&1)*256*24*60*60+(adj%(256*24*60*60));
-         break;
-   }
-   cur_time = now - adj;
+void dmy_renderer::set_time(int type,byte dat)
+{
+   clock.set(type,dat);
 }
 
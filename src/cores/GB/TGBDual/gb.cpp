@@ -22,20 +22,42 @@
 // Interface with external / other unit emulation GB
 
 #include <cores/GB/TGBDual/gb.h>
+#include <cores/GB/TGBDual/profiler.h>
+#include "../common/capture/include/frame_capture.hpp"
 #include <stdlib.h>
+#include <cassert>
+#include <ctime>
+#include <mutex>
 
-gb::gb(renderer *ref,bool b_lcd,bool b_apu)
+#define FRAME_GUARD (160*5)
+#define FRAME_BYTES ((FRAME_GUARD+160*(144+100))*sizeof(word))
+
+gb::gb(renderer *ref,bool b_lcd,bool b_apu,gb_pool *pool)
 {
 	m_renderer=ref;
-
-	m_lcd=new lcd(this);
-	m_rom=new rom();
-	m_apu=new apu(this);// ROMより後に作られたし // I was made ​​later than the ROM
-	m_mbc=new mbc(this);
-	m_cpu=new cpu(this);
-	m_cheat=new cheat(this);
+	this->pool=pool;
+
+	vframe=(word*)alloc_cold(FRAME_BYTES)+FRAME_GUARD;
+
+	// プールでは部品がこの順に gb の後ろへ並ぶ // with a pool the parts follow the gb in this order
+	m_lcd=create_part<lcd>(this);
+	m_rom=create_part<rom>();
+	m_apu=create_part<apu>(this);// ROMより後に作られたし // I was made ​​later than the ROM
+	m_mbc=create_part<mbc>(this);
+	m_cpu=create_part<cpu>(this);
+	m_cheat=create_part<cheat>(this);
+	m_profiler=NULL;
 	linked_cable_device=NULL;
 	linked_ir_device = NULL;
+	link_ready=NULL;
+	link_port=0;
+	link_published=0;
+	m_capture=NULL;
+	capture_id=0;
+	capture_fmt=0;
+
+	rtc_emulated=false;
+	rtc_host_sync=true;
 
 	m_renderer->reset();
 	m_renderer->set_sound_renderer(b_apu?m_apu->get_renderer():NULL);
@@ -44,17 +66,80 @@ gb::gb(renderer *ref,bool b_lcd,bool b_apu)
 
 	hook_ext=false;
 	use_gba=false;
+	pad_latched=false;
+	pad_latch=0;
+	// デバイスは一度に1メッセージ分を送ってくる // devices hand over a whole message at once
+	received_ir_signals.reserve(1024);
+	STAT_ONLY(tgb_stats_register(&stats);)
 }
 
 gb::~gb()
 {
+	STAT_ONLY(tgb_stats_unregister(&stats);)
+	set_link_readiness(NULL,0);
 	m_renderer->set_sound_renderer(NULL);
+	ir_signal::release(received_ir_signals);
+
+	destroy_part(m_mbc);
+	destroy_part(m_rom);
+	destroy_part(m_apu);
+	destroy_part(m_lcd);
+	destroy_part(m_cpu);
+	destroy_part(m_cheat);
+	delete m_profiler;
+	free_cold(vframe-FRAME_GUARD);
+}
+
+link_readiness::~link_readiness()
+{
+	for (int i=0;i<32;i++)
+		if (port_gb[i])
+			port_gb[i]->set_link_readiness(NULL,0);
+}
+
+void gb::set_link_readiness(link_readiness *ready,int port)
+{
+	// 前のマスクからは外して、ビットを落とす // leave the previous mask and drop its bits
+	if (link_ready&&link_ready->port_gb[link_port]==this){
+		link_ready->port_gb[link_port]=NULL;
+		link_ready->publish(link_port,false,false,false);
+	}
+	link_ready=ready;
+	link_port=port;
+	link_published=0xFF;
+	if (link_ready)
+		link_ready->port_gb[port]=this;
+	publish_link_state();
+}
+
+void *gb::alloc_part(size_t size)
+{
+	return pool?pool->hot(size):operator new(size);
+}
 
-	delete m_mbc;
-	delete m_rom;
-	delete m_apu;
-	delete m_lcd;
-	delete m_cpu;
+void gb::free_part(void *p)
+{
+	if (!pool)
+		::operator delete(p);
+}
+
+void *gb::alloc_cold(size_t size)
+{
+	return pool?pool->cold(size):calloc(1,size);
+}
+
+void gb::free_cold(void *p)
+{
+	if (!pool)
+		free(p);
+}
+
+void gb::set_profiler(int period)
+{
+	m_cpu->set_profiler(NULL);
+	delete m_profiler;
+	m_profiler=period>0?new gb_profiler(period):NULL;
+	m_cpu->set_profiler(m_profiler);
 }
 
 void gb::reset()
@@ -77,6 +162,7 @@ void gb::reset()
 	regs.WX=0;
 	regs.IF=0;
 	regs.IE=0;
+	publish_link_state();
 
 	memset(&c_regs,0,sizeof(c_regs));
 
@@ -87,6 +173,7 @@ void gb::reset()
 	m_lcd->reset();
 	m_apu->reset();
 	m_mbc->reset();
+	reset_rtc();
 
 	now_frame=0;
 	skip=skip_buf=0;
@@ -118,6 +205,40 @@ void gb::set_skip(int frame)
 	skip_buf=frame;
 }
 
+// スキップされるフレームと、誰にも見られないフレームは遅延モードで描画しない
+// In deferred mode the lines of a frame that is skipped, or that neither the
+// renderer nor a capture wants, are dropped instead of rasterised
+void gb::update_frame_wanted()
+{
+	m_lcd->set_frame_wanted(now_frame>=skip&&(m_capture||m_renderer->frame_wanted()));
+}
+
+void gb::set_rtc_mode(bool emulated,bool host_sync)
+{
+	rtc_emulated=emulated;
+	rtc_host_sync=host_sync;
+	reset_rtc();
+}
+
+void gb::reset_rtc()
+{
+	rtc_base=rtc_host_sync?(uint32_t)time(NULL):0;
+	rtc_cycles=0;
+	rtc_last_clock=(uint32_t)m_cpu->get_clock();
+}
+
+dword gb::get_rtc_time()
+{
+	if (!rtc_emulated)
+		return (dword)time(NULL);
+
+	// 倍速中は total_clock が2倍で進む // total_clock runs twice as fast in double speed mode
+	uint32_t now=(uint32_t)m_cpu->get_clock();
+	rtc_cycles+=(now-rtc_last_clock)>>(m_cpu->get_speed()?1:0);
+	rtc_last_clock=now;
+	return rtc_base+(dword)(rtc_cycles/4194304);
+}
+
 void gb::set_use_gba(bool use) {
 	use_gba = use;
 	if (use) this->get_cpu()->get_regs()->BC.b.l = 0x01;
@@ -140,6 +261,8 @@ bool gb::load_rom(byte *buf,int size,byte *ram,int ram_size, bool persistent)
 // savestate format matching the original TGB dual, pre-libretro port
 void gb::serialize_legacy(serializer &s)
 {
+	m_lcd->sync();
+
 	int tbl_ram[]={1,1,1,4,16,8};
 
 	s.process(&m_rom->get_info()->gb_type, sizeof(int));
@@ -156,6 +279,8 @@ void gb::serialize_legacy(serializer &s)
 	}
 	s.process(m_rom->get_sram(), tbl_ram[m_rom->get_info()->ram_size]*0x2000);
 	s.process(m_cpu->get_oam(), 0xA0);
+	m_lcd->invalidate_sprites();
+	m_lcd->invalidate_all_tiles();
 	s.process(m_cpu->get_stack(), 0x80);
 
 	int rom_page = (m_mbc->get_rom()-m_rom->get_rom())/0x4000;
@@ -228,6 +353,8 @@ void gb::serialize_legacy(serializer &s)
 // TODO: put 'serialize' in other classes (cpu, mbc, ...) and call it from here.
 void gb::serialize_firstrev(serializer &s)
 {
+	m_lcd->sync();
+
 	int tbl_ram[]={1,1,1,4,16,8};
 
 	s.process(&m_rom->get_info()->gb_type, sizeof(int));
@@ -244,6 +371,8 @@ void gb::serialize_firstrev(serializer &s)
 	}
 	s.process(m_rom->get_sram(), tbl_ram[m_rom->get_info()->ram_size]*0x2000);
 	s.process(m_cpu->get_oam(), 0xA0);
+	m_lcd->invalidate_sprites();
+	m_lcd->invalidate_all_tiles();
 	s.process(m_cpu->get_stack(), 0x80);
 
 	int rom_page = (m_mbc->get_rom() - m_rom->get_rom()) / 0x4000;
@@ -287,7 +416,7 @@ void gb::serialize_firstrev(serializer &s)
 	s.process(m_apu->get_stat_cpy(), sizeof(apu_stat));
 }
 
-void gb::serialize(serializer &s)
+template <class S> void gb::serialize(S &s)
 {
 	s_VAR(regs);
 	s_VAR(c_regs);
@@ -297,30 +426,67 @@ void gb::serialize(serializer &s)
 	m_mbc->serialize(s);
 	m_lcd->serialize(s);
 	m_apu->serialize(s);
+
+	if (rtc_emulated){
+		rtc_state st;
+		st.tag=RTC_STATE_TAG;
+		// ホスト時計で作ったステートはここで終わる: 読まずに時計をやり直す
+		// A host-clock state ends here; restart the clock instead of reading past it
+		if (s.loading()&&s.remaining()<sizeof(st))
+			reset_rtc();
+		else{
+			s_BLOCK(st);
+			// 時計を持たないステートか別の版: 時計をやり直す // a state without our clock, restart it
+			if (s.loading()&&st.tag!=RTC_STATE_TAG)
+				reset_rtc();
+		}
+	}
+}
+
+template <bool load> void gb::transfer_state(rtc_state &st)
+{
+	s_FIELD(rtc_base);
+	s_FIELD(rtc_cycles);
+	s_FIELD(rtc_last_clock);
 }
 
+SERIALIZE_INSTANTIATE(gb);
+
 size_t gb::get_state_size(void)
 {
-	size_t ret = 0;
-	serializer s(&ret, serializer::COUNT);
-	serialize(s);
-	return ret;
+	return state_size(m_rom->get_info()->gb_type >= 3, m_rom->get_sram_size(), rtc_emulated);
 }
 
 void gb::save_state_mem(void *buf)
 {
-	serializer s(buf, serializer::SAVE_BUF);
+	state_serializer<serializer::SAVE_BUF> s(buf);
 	serialize(s);
 }
 
 void gb::restore_state_mem(void *buf)
 {
-	serializer s(buf, serializer::LOAD_BUF);
+	restore_state_mem(buf,get_state_size());
+}
+
+bool gb::restore_state_mem(void *buf,size_t size)
+{
+	// 時計のブロックは無くてもよい // only the RTC block is optional
+	if (size<state_size(m_rom->get_info()->gb_type >= 3, m_rom->get_sram_size(), false))
+		return false;
+	state_serializer<serializer::LOAD_BUF> s(buf,size);
 	serialize(s);
+
+	if (rtc_emulated&&rtc_host_sync)
+		reset_rtc();
+	publish_link_state();
+	// total_clock が変わったのでサンプル間隔を合わせ直す // total_clock changed, restart the sample period
+	m_cpu->set_profiler(m_profiler);
+	return true;
 }
 
 void gb::refresh_pal()
 {
+	m_lcd->sync();
 	for (int i=0;i<64;i++)
 		m_lcd->get_mapped_pal(i>>2)[i&3]=m_renderer->map_color(m_lcd->get_pal(i>>2)[i&3]);
 }
@@ -339,15 +505,21 @@ void gb::run()
 					m_cpu->irq(INT_LCDC);
 			}
 			if (regs.LY==0){
+				m_renderer->sync_time(get_rtc_time());
 				m_renderer->refresh();
+				STAT_ONLY(stats.end_frame();)
 				if (now_frame>=skip){
+					m_lcd->flush();
 					m_renderer->render_screen((byte*)vframe,160,144,16);
+					if (m_capture)
+						m_capture->submit(capture_id,vframe,160,144,160*2,(capture_format)capture_fmt);
 					now_frame=0;
 				}
 				else
 					now_frame++;
 				m_lcd->clear_win_count();
 				skip=skip_buf;
+				update_frame_wanted();
 			}
 			if (regs.LY>=144){ // VBlank 期間中 // During VBlank
 				regs.STAT|=1;
@@ -393,7 +565,10 @@ void gb::run()
 						else m_cpu->dma_src_bank=NULL;
 						m_cpu->b_dma_first=false;
 					}
+					m_lcd->sync();
 					memcpy(m_cpu->dma_dest_bank+(m_cpu->dma_dest&0x1ff0),m_cpu->dma_src_bank+m_cpu->dma_src,16);
+					m_lcd->invalidate_tiles((int)((m_cpu->dma_dest_bank-m_cpu->vram)/0x2000),m_cpu->dma_dest&0x1ff0,16);
+					STAT_INC(this,STAT_HDMA);
 //					fprintf(m_cpu->file,"%03d : dma exec %04X -> %04X rest %d\n",regs.LY,m_cpu->dma_src,m_cpu->dma_dest,m_cpu->dma_rest);
 
 					m_cpu->dma_src+=16;
@@ -410,7 +585,9 @@ void gb::run()
 //					regs.STAT|=3;
 
 					if (now_frame>=skip)
-						m_lcd->render(vframe,regs.LY);
+						m_lcd->defer(vframe,regs.LY);
+					else
+						STAT_INC(this,STAT_LINES_SKIPPED);
 
 					regs.STAT&=0xfc;
 					m_cpu->exec(207); // state=3
@@ -423,7 +600,7 @@ void gb::run()
 								m_cpu->irq(INT_LCDC);
 							regs.STAT&=0xfc;
 							if (now_frame>=skip)
-								m_lcd->render(vframe,regs.LY);
+								m_lcd->defer(vframe,regs.LY);
 							m_cpu->exec(78); // state=0
 						}
 						else{
@@ -432,14 +609,16 @@ void gb::run()
 								m_cpu->irq(INT_LCDC);
 							regs.STAT&=0xfc;
 							if (now_frame>=skip)
-								m_lcd->render(vframe,regs.LY);
+								m_lcd->defer(vframe,regs.LY);
 							m_cpu->exec(207-(129*m_lcd->get_sprite_count()/10)); // state=0
 						}
 					}
 					else{
 */						regs.STAT&=0xfc;
 						if (now_frame>=skip)
-							m_lcd->render(vframe,regs.LY);
+							m_lcd->defer(vframe,regs.LY);
+						else
+							STAT_INC(this,STAT_LINES_SKIPPED);
 						if ((regs.STAT&0x08))
 							m_cpu->irq(INT_LCDC);
 						m_cpu->exec(207); // state=0
@@ -452,15 +631,21 @@ void gb::run()
 //			regs.LY=(regs.LY+1)%154;
 			re_render++;
 			if (re_render>=154){
+				m_lcd->flush();
 				memset(vframe,0xff,160*144*2);
+				m_renderer->sync_time(get_rtc_time());
 				m_renderer->refresh();
+				STAT_ONLY(stats.end_frame();)
 				if (now_frame>=skip){
 					m_renderer->render_screen((byte*)vframe,160,144,16);
+					if (m_capture)
+						m_capture->submit(capture_id,vframe,160,144,160*2,(capture_format)capture_fmt);
 					now_frame=0;
 				}
 				else
 					now_frame++;
 				m_lcd->clear_win_count();
+				update_frame_wanted();
 				re_render=0;
 			}
 			regs.STAT&=0xF8;
@@ -497,6 +682,72 @@ void gb::send_ir_signal(ir_signal* signal)
 
 }
 
+// ir_signal のフリーリスト。全スレッドで一本を共有する (スケジューラのワーカーも同じリストから取る)
+// ir_signal free list. One list shared by every thread, so the scheduler's workers
+// draw from what loadGame reserved and a slot deleted on another thread comes back here.
+union ir_signal_slot {
+	ir_signal_slot *next;
+	char data[sizeof(ir_signal)];
+};
+
+#define IR_SIGNAL_CHUNK 1024
+
+static std::mutex ir_free_lock;
+static std::vector<ir_signal_slot*> ir_chunks; // プロセス終了まで持つ // kept until exit
+static ir_signal_slot *ir_free_list=NULL;
+static size_t ir_free_count=0;
+
+// ir_free_lock を取ってから呼ぶ // call with ir_free_lock held
+static void ir_signal_grow(size_t count)
+{
+	ir_signal_slot *chunk=new ir_signal_slot[count];
+	ir_chunks.push_back(chunk);
+	for (size_t i=0;i<count;i++){
+		chunk[i].next=ir_free_list;
+		ir_free_list=&chunk[i];
+	}
+	ir_free_count+=count;
+}
+
+void *ir_signal::operator new(size_t size)
+{
+	// スロットは ir_signal 一個分。派生クラスは入らない // a slot holds exactly one ir_signal, no derived classes
+	assert(size<=sizeof(ir_signal_slot));
+	(void)size;
+	std::lock_guard<std::mutex> guard(ir_free_lock);
+	if (!ir_free_list)
+		ir_signal_grow(IR_SIGNAL_CHUNK);
+	ir_signal_slot *slot=ir_free_list;
+	ir_free_list=slot->next;
+	ir_free_count--;
+	return slot;
+}
+
+void ir_signal::operator delete(void *p)
+{
+	if (!p)
+		return;
+	ir_signal_slot *slot=(ir_signal_slot*)p;
+	std::lock_guard<std::mutex> guard(ir_free_lock);
+	slot->next=ir_free_list;
+	ir_free_list=slot;
+	ir_free_count++;
+}
+
+void ir_signal::reserve(size_t count)
+{
+	std::lock_guard<std::mutex> guard(ir_free_lock);
+	if (ir_free_count<count)
+		ir_signal_grow(count-ir_free_count);
+}
+
+void ir_signal::release(std::vector<ir_signal*> &que)
+{
+	for (size_t i=0;i<que.size();i++)
+		delete que[i];
+	que.clear();
+}
+
 
 static int asHex(const char c)
 {
@@ -0,0 +1,90 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Instance pool with hot and cold arenas
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <cores/GB/TGBDual/gb_pool.h>
+#include <cores/GB/TGBDual/gb.h>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+#define ARENA_ALIGN 64
+
+static size_t align_up(size_t size)
+{
+	return (size + ARENA_ALIGN - 1) & ~(size_t)(ARENA_ALIGN - 1);
+}
+
+gb_arena::gb_arena(size_t chunk_size)
+{
+	this->chunk_size = align_up(chunk_size);
+	cur = NULL;
+	left = 0;
+	used = 0;
+}
+
+gb_arena::~gb_arena()
+{
+	for (size_t i = 0; i < chunks.size(); i++)
+		::operator delete(chunks[i]);
+}
+
+void* gb_arena::alloc(size_t size)
+{
+	size = align_up(size ? size : 1);
+	if (size > left)
+	{
+		// 足りなければ新しいチャンク (大きな要求はそれ専用) // a new chunk, or a dedicated one for a large request
+		size_t n = size > chunk_size ? size : chunk_size;
+		char* raw = (char*)::operator new(n + ARENA_ALIGN);
+		memset(raw, 0, n + ARENA_ALIGN);
+		chunks.push_back(raw);
+		cur = (char*)align_up((size_t)(uintptr_t)raw);
+		left = n;
+	}
+	void* p = cur;
+	cur += size;
+	left -= size;
+	used += size;
+	return p;
+}
+
+size_t gb_pool::instance_size()
+{
+	return align_up(sizeof(gb)) + align_up(sizeof(lcd)) + align_up(sizeof(rom)) + align_up(sizeof(apu)) +
+		align_up(sizeof(apu_snd)) + align_up(sizeof(mbc)) + align_up(sizeof(cpu)) + align_up(sizeof(cheat));
+}
+
+gb_pool::gb_pool(int count)
+	: hot_arena(instance_size() * (count > 0 ? count : 1)), cold_arena(4 * 1024 * 1024)
+{
+}
+
+gb_pool::~gb_pool()
+{
+	for (size_t i = instances.size(); i-- > 0;)
+		instances[i]->~gb();
+}
+
+gb* gb_pool::create(renderer* ref, bool b_lcd, bool b_apu)
+{
+	gb* g = new (hot(sizeof(gb))) gb(ref, b_lcd, b_apu, this);
+	instances.push_back(g);
+	return g;
+}
@@ -30,6 +30,8 @@
 lcd::lcd(gb* ref)
 {
 	ref_gb = ref;
+	sprite_line = (byte(*)[40])ref_gb->alloc_cold(144 * 40);
+	tile_cache = (byte(*)[8][8])ref_gb->alloc_cold(2 * 384 * 8 * 8);
 
 	byte dat[] = { 31,21,11,0 };
 
@@ -38,6 +40,10 @@ lcd::lcd(gb* ref)
 		m_pal32[i] = ((dat[i] << 16) | (dat[i] << 8) | dat[i]);
 	}
 
+	deferred=false;
+	frame_wanted=true;
+	pend_count=0;
+
 	/*
 	for (int i = 0; i < 16; i++)
 	{
@@ -53,10 +59,13 @@ lcd::lcd(gb* ref)
 
 lcd::~lcd()
 {
+	ref_gb->free_cold(sprite_line);
+	ref_gb->free_cold(tile_cache);
 }
 
 void lcd::set_enable(int layer,bool enable)
 {
+	sync();
 	layer_enable[layer]=enable;
 }
 
@@ -67,23 +76,75 @@ bool lcd::get_enable(int layer)
 
 void lcd::reset()
 {
+	pend_count=0;
+	sprite_dirty=true;
+	invalidate_all_tiles();
 	now_win_line=0;
 	layer_enable[0]=layer_enable[1]=layer_enable[2]=true;
 	sprite_count=0;
 }
 
+void lcd::invalidate_tiles(int bank,int adr,int len)
+{
+	// GDMA は次のバンクまではみ出すことがある // a GDMA may run past the end of the bank
+	for (int off=bank*0x2000+(adr&~15),end=bank*0x2000+adr+len;off<end&&off<0x4000;off+=16)
+		invalidate_tile(off>>13,off&0x1FFF);
+}
+
+void lcd::invalidate_all_tiles()
+{
+	memset(tile_dirty,1,sizeof(tile_dirty));
+}
+
+void lcd::decode_tile(int tile)
+{
+	const byte *src=ref_gb->get_cpu()->get_vram()+(tile>=384?0x2000:0)+(tile%384)*16;
+	for (int row=0;row<8;row++,src+=2){
+		byte lo=src[0],hi=src[1];
+		for (int x=0;x<8;x++)
+			tile_cache[tile][row][x]=((lo>>(7-x))&1)|(((hi>>(7-x))&1)<<1);
+	}
+	tile_dirty[tile]=0;
+}
+
+inline const byte *lcd::tile_row(int tile,int row)
+{
+	if (tile_dirty[tile])
+		decode_tile(tile);
+	return tile_cache[tile][row];
+}
+
+// BG/ウインドウのタイル番号をキャッシュの番号へ (pat=0x1000 なら 0-127 は 256-383)
+// Maps a BG/window tile number to its cache slot (with pat=0x1000, 0-127 are tiles 256-383)
+static inline int tile_slot(byte tile,word pat)
+{
+	return (tile&0x80)?tile:tile+(pat>>4);
+}
+
+// 1 タイル分 (8 ドット) の色と色番号を書き出す // writes one tile row (8 dots) and its colour indices
+static inline void put_tile_row(word *dat,byte *trans,const byte *row,const word *pal,bool flip)
+{
+	if (flip){
+		for (int i=0;i<8;i++){
+			trans[i]=row[7-i];
+			dat[i]=pal[row[7-i]];
+		}
+	}
+	else{
+		memcpy(trans,row,8);
+		for (int i=0;i<8;i++)
+			dat[i]=pal[row[i]];
+	}
+}
+
 void lcd::bg_render(void *buf,int scanline)
 {
 	int i,x,y;
    int start, y_div_8, prefix = 0;
    byte *trans, *now_tile;
-	dword tmp_dat, calc1, calc2;
-   word back, pat, *dat;
-   word *now_share, *now_pat;
-   byte *vrams[2];
-	word share  = 0x0000;//prefix
+   word back, pat;
+   word *dat;
 	word pal[4];
-	byte tile;
 
 	if (!(ref_gb->get_regs()->LCDC&0x80)||!(ref_gb->get_regs()->LCDC&0x01)||
 		(ref_gb->get_regs()->WY<=(dword)scanline&&ref_gb->get_regs()->WX<8&&(ref_gb->get_regs()->LCDC&0x20)))
@@ -100,8 +161,6 @@ void lcd::bg_render(void *buf,int scanline)
 
 	back      = (ref_gb->get_regs()->LCDC&0x08)?0x1C00:0x1800;
 	pat       = (ref_gb->get_regs()->LCDC&0x10)?0x0000:0x1000;
-	vrams[0]  = ref_gb->get_cpu()->get_vram();
-   vrams[1]  = ref_gb->get_cpu()->get_vram() +0x2000;
 
 	pal[0]    = m_pal16[ref_gb->get_regs()->BGP&0x3];
 	pal[1]    = m_pal16[(ref_gb->get_regs()->BGP>>2)&0x3];
@@ -121,47 +180,13 @@ void lcd::bg_render(void *buf,int scanline)
 
 
 	trans=trans_tbl;
-	now_tile=vrams[0]+back+((y_div_8)<<5)+start;
-	now_share=(word*)(vrams[0]+share+((y&7)<<1));
-	now_pat=(word*)(vrams[0]+pat+((y&7)<<1));
-
-	tile=*(now_tile++);
-	tmp_dat=(tile&0x80)?*(now_share+(tile<<3)):*(now_pat+(tile<<3));
-	calc1=tmp_dat;
-	calc2=tmp_dat>>7;
-	calc1&=0x55;
-	calc2&=0xAA;
-	calc1|=calc2;
-	calc2=tmp_dat>>1;
-	tmp_dat>>=8;
-	calc2&=0x55;
-	tmp_dat&=0xAA;
-	calc2|=tmp_dat;
-
-	*(dat++)=pal[calc2>>6];
-	*(dat++)=pal[calc1>>6];
-	*(dat++)=pal[(calc2>>4)&3];
-	*(dat++)=pal[(calc1>>4)&3];
-	*(dat++)=pal[(calc2>>2)&3];
-	*(dat++)=pal[(calc1>>2)&3];
-	*(dat++)=pal[calc2&3];
-	*(dat++)=pal[calc1&3];
-
-	*(trans++)=(calc2>>6);
-	*(trans++)=(calc1>>6);
-	*(trans++)=(calc2>>4)&3;
-	*(trans++)=(calc1>>4)&3;
-	*(trans++)=(calc2>>2)&3;
-	*(trans++)=(calc1>>2)&3;
-	*(trans++)=calc2&3;
-	*(trans++)=calc1&3;
-
-	dat   -= 8;
-	trans -= 8;
+	now_tile=ref_gb->get_cpu()->get_vram()+back+((y_div_8)<<5)+start;
+
+	put_tile_row(dat,trans,tile_row(tile_slot(*(now_tile++),pat),y&7),pal,false);
 
 	for (i=0;i<8-(x&7);i++){ // スクロール補正 // Scroll correction
 		*(dat)=*(dat+(x&7));
-		*(trans)=*(dat+(x&7));
+		*(trans)=*(trans+(x&7));
 		dat++; trans++;
 	}
 
@@ -170,36 +195,8 @@ void lcd::bg_render(void *buf,int scanline)
 			now_tile=ref_gb->get_cpu()->get_vram()+back+((y/8)<<5);
 			prefix=256;
 		}
-		tile=*(now_tile++);
-		tmp_dat=(tile&0x80)?*(now_share+(tile<<3)):*(now_pat+(tile<<3));
-		calc1=tmp_dat;
-		calc2=tmp_dat>>7;
-		calc1&=0x55;
-		calc2&=0xAA;
-		calc1|=calc2;
-		calc2=tmp_dat>>1;
-		tmp_dat>>=8;
-		calc2&=0x55;
-		tmp_dat&=0xAA;
-		calc2|=tmp_dat;
-
-		*(dat++)=pal[calc2>>6];
-		*(dat++)=pal[calc1>>6];
-		*(dat++)=pal[(calc2>>4)&3];
-		*(dat++)=pal[(calc1>>4)&3];
-		*(dat++)=pal[(calc2>>2)&3];
-		*(dat++)=pal[(calc1>>2)&3];
-		*(dat++)=pal[calc2&3];
-		*(dat++)=pal[calc1&3];
-
-		*(trans++)=(calc2>>6);
-		*(trans++)=(calc1>>6);
-		*(trans++)=(calc2>>4)&3;
-		*(trans++)=(calc1>>4)&3;
-		*(trans++)=(calc2>>2)&3;
-		*(trans++)=(calc1>>2)&3;
-		*(trans++)=calc2&3;
-		*(trans++)=calc1&3;
+		put_tile_row(dat,trans,tile_row(tile_slot(*(now_tile++),pat),y&7),pal,false);
+		dat+=8; trans+=8;
 	}
 }
 
@@ -217,10 +214,8 @@ void lcd::win_render(void *buf,int scanline)
 
 	word back=(ref_gb->get_regs()->LCDC&0x40)?0x1C00:0x1800;
 	word pat=(ref_gb->get_regs()->LCDC&0x10)?0x0000:0x1000;
-	word share=0x0000;//prefix
 	word pal[4];
 	word *dat=(word*)buf;
-	byte tile;
 	int i;
 
 	pal[0]=m_pal16[ref_gb->get_regs()->BGP&0x3];
@@ -230,43 +225,46 @@ void lcd::win_render(void *buf,int scanline)
 	dat+=160*scanline+ref_gb->get_regs()->WX-7;
 	trans+=ref_gb->get_regs()->WX-7;
 	byte *now_tile=ref_gb->get_cpu()->get_vram()+back+(((y>>3)-1)<<5);
-	word *now_share=(word*)(ref_gb->get_cpu()->get_vram()+share+((y&7)<<1));
-	word *now_pat=(word*)(ref_gb->get_cpu()->get_vram()+pat+((y&7)<<1));
-	dword tmp_dat;
-	dword calc1,calc2;
 
 	for (i=ref_gb->get_regs()->WX>>3;i<21;i++){
-		tile=*(now_tile++);
-		tmp_dat=(tile&0x80)?*(now_share+(tile<<3)):*(now_pat+(tile<<3));
-		calc1=tmp_dat;
-		calc2=tmp_dat>>7;
-		calc1&=0x55;
-		calc2&=0xAA;
-		calc1|=calc2;
-		calc2=tmp_dat>>1;
-		tmp_dat>>=8;
-		calc2&=0x55;
-		tmp_dat&=0xAA;
-		calc2|=tmp_dat;
-
-		*(dat++)=pal[calc2>>6];
-		*(dat++)=pal[calc1>>6];
-		*(dat++)=pal[(calc2>>4)&3];
-		*(dat++)=pal[(calc1>>4)&3];
-		*(dat++)=pal[(calc2>>2)&3];
-		*(dat++)=pal[(calc1>>2)&3];
-		*(dat++)=pal[calc2&3];
-		*(dat++)=pal[calc1&3];
-
-		*(trans++)=(calc2>>6);
-		*(trans++)=(calc1>>6);
-		*(trans++)=(calc2>>4)&3;
-		*(trans++)=(calc1>>4)&3;
-		*(trans++)=(calc2>>2)&3;
-		*(trans++)=(calc1>>2)&3;
-		*(trans++)=calc2&3;
-		*(trans++)=calc1&3;
+		put_tile_row(dat,trans,tile_row(tile_slot(*(now_tile++),pat),y&7),pal,false);
+		dat+=8; trans+=8;
+	}
+}
+
+// OAM からライン毎の表示スプライト一覧を作る。番号の小さい順 (手前から) に並ぶ
+// Builds the per-line sprite lists from OAM, in priority order (lowest index first)
+void lcd::build_sprite_buckets(bool tall)
+{
+	byte *oam=ref_gb->get_cpu()->get_oam();
+	int x,y,h=tall?15:7;
+
+	memset(sprite_line_count,0,sizeof(sprite_line_count));
+	for (int i=0;i<40;i++){
+		y=oam[i*4]-(tall?1:9);
+		x=oam[i*4+1]-8;
+		if ((x==-8&&y==-16)||x>160)
+			continue;
+		for (int line=(y-h<0)?0:y-h;line<=y&&line<144;line++)
+			sprite_line[line][sprite_line_count[line]++]=i;
 	}
+
+	sprite_dirty=false;
+	sprite_tall=tall;
+}
+
+// l1/l2 (calc 形式) から左から順の8ピクセルの色番号を取り出す
+// Unpacks the interleaved l1/l2 pair into the 8 colour numbers, left to right
+static inline void unpack_sprite_row(word l1,word l2,byte *col)
+{
+	col[0]=l2>>6;
+	col[1]=l1>>6;
+	col[2]=(l2>>4)&3;
+	col[3]=(l1>>4)&3;
+	col[4]=(l2>>2)&3;
+	col[5]=(l1>>2)&3;
+	col[6]=l2&3;
+	col[7]=l1&3;
 }
 
 void lcd::sprite_render(void *buf,int scanline)
@@ -274,15 +272,19 @@ void lcd::sprite_render(void *buf,int scanline)
 	if (!(ref_gb->get_regs()->LCDC&0x80)||!(ref_gb->get_regs()->LCDC&0x02))
 		return;
 
-	word *sdat=((word*)buf)+(scanline)*160,*now_pos;
-	int x,y,tile,atr,i,now;
+	word *sdat=((word*)buf)+(scanline)*160;
+	int x,y,tile,atr,i,n,now;
 	word l1,l2,tmp_dat;
 	word pal[2][4],*cur_p;
 	byte *oam=ref_gb->get_cpu()->get_oam(),*vram=ref_gb->get_cpu()->get_vram();
+	byte col[8],drawn[160];
 
 	bool sp_size=(ref_gb->get_regs()->LCDC&0x04)?true:false;
 	int palnum;
 
+	if (sprite_dirty||sprite_tall!=sp_size)
+		build_sprite_buckets(sp_size);
+
 	pal[0][0]=m_pal16[ref_gb->get_regs()->OBP1&0x3];
 	pal[0][1]=m_pal16[(ref_gb->get_regs()->OBP1>>2)&0x3];
 	pal[0][2]=m_pal16[(ref_gb->get_regs()->OBP1>>4)&0x3];
@@ -293,7 +295,12 @@ void lcd::sprite_render(void *buf,int scanline)
 	pal[1][2]=m_pal16[(ref_gb->get_regs()->OBP2>>4)&0x3];
 	pal[1][3]=m_pal16[(ref_gb->get_regs()->OBP2>>6)&0x3];
 
-	for (i=39;i>=0;i--){
+	// 手前のスプライトから描き、書いたピクセルは後ろのスプライトで上書きしない
+	// Drawn front to back; a pixel taken by a sprite is never overdrawn by the ones behind it
+	memset(drawn,0,sizeof(drawn));
+
+	for (n=0;n<sprite_line_count[scanline];n++){
+		i=sprite_line[scanline][n];
 		tile=oam[i*4+2];
 		atr=oam[i*4+3];
 		palnum=(atr>>4)&1;
@@ -302,8 +309,6 @@ void lcd::sprite_render(void *buf,int scanline)
 		if (sp_size){ // 8*16
 			y=oam[i*4]-1;
 			x=oam[i*4+1]-8;
-			if ((x==-8&&y==-16)||x>160||y>144+15||(y<scanline)||(y>scanline+15))
-				continue;
 			if (scanline-y+15<8)
          {
 				now= (atr & 0x40) ? ((y-scanline) & 7) : ((7 - (y - scanline)) & 7);
@@ -317,13 +322,10 @@ void lcd::sprite_render(void *buf,int scanline)
 		else{
 			y=oam[i*4]-9;
 			x=oam[i*4+1]-8;
-			if ((x==-8&&y==-16)||(x>160)||(y>144+7)||(y<scanline)||(y>scanline+7))
-				continue;
 			now=(atr&0x40)?((y-scanline)&7):((7-(y-scanline)) & 7);
 			tmp_dat=*(word*)(vram+tile*16+now*2);
 		}
 		sprite_count++;
-		now_pos=sdat+x;
 
 		l1=tmp_dat;
 		l2=tmp_dat>>7;
@@ -344,47 +346,15 @@ void lcd::sprite_render(void *buf,int scanline)
 			ROL_BYTE(l1,4);
 		}
 
-		if (x<0){ // クリッピング処理
-			if (atr&0x80){ // プライオリティ(背面に)
-				if ((-x)<=1) if (!trans_tbl[x+1]) if (l1>>6) *(now_pos+1)=cur_p[l1>>6];
-				if ((-x)<=2) if (!trans_tbl[x+2]) if ((l2>>4)&3) *(now_pos+2)=cur_p[(l2>>4)&3];
-				if ((-x)<=3) if (!trans_tbl[x+3]) if ((l1>>4)&3) *(now_pos+3)=cur_p[(l1>>4)&3];
-				if ((-x)<=4) if (!trans_tbl[x+4]) if ((l2>>2)&3) *(now_pos+4)=cur_p[(l2>>2)&3];
-				if ((-x)<=5) if (!trans_tbl[x+5]) if ((l1>>2)&3) *(now_pos+5)=cur_p[(l1>>2)&3];
-				if ((-x)<=6) if (!trans_tbl[x+6]) if (l2&3) *(now_pos+6)=cur_p[l2&3];
-				if ((-x)<=7) if (!trans_tbl[x+7]) if (l1&3) *(now_pos+7)=cur_p[l1&3];
-			}
-			else{
-				if ((-x)<=1) if (l1>>6) *(now_pos+1)=cur_p[l1>>6];
-				if ((-x)<=2) if ((l2>>4)&3) *(now_pos+2)=cur_p[(l2>>4)&3];
-				if ((-x)<=3) if ((l1>>4)&3) *(now_pos+3)=cur_p[(l1>>4)&3];
-				if ((-x)<=4) if ((l2>>2)&3) *(now_pos+4)=cur_p[(l2>>2)&3];
-				if ((-x)<=5) if ((l1>>2)&3) *(now_pos+5)=cur_p[(l1>>2)&3];
-				if ((-x)<=6) if (l2&3) *(now_pos+6)=cur_p[l2&3];
-				if ((-x)<=7) if (l1&3) *(now_pos+7)=cur_p[l1&3];
-			}
-		}
-		else{
-			if (atr&0x80){
-				if (!trans_tbl[x+0]) if (l2>>6) *(now_pos)=cur_p[l2>>6];
-				if (!trans_tbl[x+1]) if (l1>>6) *(now_pos+1)=cur_p[l1>>6];
-				if (!trans_tbl[x+2]) if ((l2>>4)&3) *(now_pos+2)=cur_p[(l2>>4)&3];
-				if (!trans_tbl[x+3]) if ((l1>>4)&3) *(now_pos+3)=cur_p[(l1>>4)&3];
-				if (!trans_tbl[x+4]) if ((l2>>2)&3) *(now_pos+4)=cur_p[(l2>>2)&3];
-				if (!trans_tbl[x+5]) if ((l1>>2)&3) *(now_pos+5)=cur_p[(l1>>2)&3];
-				if (!trans_tbl[x+6]) if (l2&3) *(now_pos+6)=cur_p[l2&3];
-				if (!trans_tbl[x+7]) if (l1&3) *(now_pos+7)=cur_p[l1&3];
-			}
-			else{
-				if (l2>>6) *(now_pos)=cur_p[l2>>6];
-				if (l1>>6) *(now_pos+1)=cur_p[l1>>6];
-				if ((l2>>4)&3) *(now_pos+2)=cur_p[(l2>>4)&3];
-				if ((l1>>4)&3) *(now_pos+3)=cur_p[(l1>>4)&3];
-				if ((l2>>2)&3) *(now_pos+4)=cur_p[(l2>>2)&3];
-				if ((l1>>2)&3) *(now_pos+5)=cur_p[(l1>>2)&3];
-				if (l2&3) *(now_pos+6)=cur_p[l2&3];
-				if (l1&3) *(now_pos+7)=cur_p[l1&3];
-			}
+		unpack_sprite_row(l1,l2,col);
+
+		for (int k=(x<0)?-x:0;k<8&&x+k<160;k++){ // クリッピング処理
+			if (!col[k]||drawn[x+k])
+				continue;
+			if ((atr&0x80)&&trans_tbl[x+k]) // プライオリティ(背面に)
+				continue;
+			drawn[x+k]=1;
+			sdat[x+k]=cur_p[col[k]];
 		}
 	}
 }
@@ -401,11 +371,10 @@ void lcd::remap_all_palettes() {
 
 void lcd::bg_render_color(void *buf,int scanline)
 {
-	byte tile;
 	int i,x,y;
-   word back, pat, *pal, *dat;
-   byte *vrams[2];
-   word share=0x0000;//prefix
+   word back, pat;
+   const word *pal;
+   word *dat;
 	trans_count=0;
 
 	// カラーではOFF機能が働かない?(僕のキャンプ場､モンコレナイト)
@@ -424,8 +393,6 @@ void lcd::bg_render_color(void *buf,int scanline)
 
 	back=(ref_gb->get_regs()->LCDC&0x08)?0x1C00:0x1800;
 	pat=(ref_gb->get_regs()->LCDC&0x10)?0x0000:0x1000;
-	vrams[0] = ref_gb->get_cpu()->get_vram();
-   vrams[1] = ref_gb->get_cpu()->get_vram()+0x2000;
 
 	y=scanline+ref_gb->get_regs()->SCY;
 	if (y>=256)
@@ -437,68 +404,18 @@ void lcd::bg_render_color(void *buf,int scanline)
 	int start=ref_gb->get_regs()->SCX>>3;
 	int y_div_8=y>>3;
 	int prefix=0;
-	byte *now_tile=vrams[0]+back+((y_div_8)<<5)+start;
-	byte *now_atr=vrams[0]+back+((y_div_8)<<5)+start+0x2000;
-	word *now_share=(word*)(vrams[0]+share+((y&7)<<1));
-	word *now_pat=(word*)(vrams[0]+pat+((y&7)<<1));
-	word *now_share2=(word*)(vrams[0]+share+14-((y&7)<<1));
-	word *now_pat2=(word*)(vrams[0]+pat+14-((y&7)<<1));
-	dword tmp_dat;
-	dword calc1,calc2;
+	byte *now_tile=ref_gb->get_cpu()->get_vram()+back+((y_div_8)<<5)+start;
+	byte *now_atr=ref_gb->get_cpu()->get_vram()+back+((y_div_8)<<5)+start+0x2000;
 	byte atr;
-	word bank;
 	byte *trans=trans_tbl;
 	byte *priority=priority_tbl;
 
-	tile=*(now_tile++);
+	// 属性: bit3 バンク, bit5 左右反転, bit6 上下反転 // attributes: bit 3 bank, bit 5 x flip, bit 6 y flip
 	atr=*(now_atr++);
-
 	pal=mapped_pal[atr&7];
-	bank=(atr<<9)&0x1000;
-	tmp_dat=(tile&0x80)?*(((atr&0x40)?now_share2:now_share)+(tile<<3)+bank):*(((atr&0x40)?now_pat2:now_pat)+(tile<<3)+bank);
-	calc1=tmp_dat;
-	calc2=tmp_dat>>7;
-	calc1&=0x55;
-	calc2&=0xAA;
-	calc1|=calc2;
-	calc2=tmp_dat>>1;
-	tmp_dat>>=8;
-	calc2&=0x55;
-	tmp_dat&=0xAA;
-	calc2|=tmp_dat;
-
-	if (atr&0x20){ // 反転する
-		byte tmp_p=calc2;
-		calc2=((calc1>>2)&0x33)|((calc1<<2)&0xcc);
-		ROL_BYTE(calc2,4);
-		calc1=((tmp_p>>2)&0x33)|((tmp_p<<2)&0xcc);
-		ROL_BYTE(calc1,4);
-	}
-
-	*(dat++)=pal[calc2>>6];
-	*(dat++)=pal[calc1>>6];
-	*(dat++)=pal[(calc2>>4)&3];
-	*(dat++)=pal[(calc1>>4)&3];
-	*(dat++)=pal[(calc2>>2)&3];
-	*(dat++)=pal[(calc1>>2)&3];
-	*(dat++)=pal[calc2&3];
-	*(dat++)=pal[calc1&3];
-
-	*(trans++)=(calc2>>6);
-	*(trans++)=(calc1>>6);
-	*(trans++)=(calc2>>4)&3;
-	*(trans++)=(calc1>>4)&3;
-	*(trans++)=(calc2>>2)&3;
-	*(trans++)=(calc1>>2)&3;
-	*(trans++)=calc2&3;
-	*(trans++)=calc1&3;
+	put_tile_row(dat,trans,tile_row(((atr>>3)&1)*384+tile_slot(*(now_tile++),pat),(atr&0x40)?7-(y&7):(y&7)),pal,(atr&0x20)!=0);
 
 	memset(priority,(atr&0x80),8);
-	priority+=8;
-
-	dat-=8;
-	trans-=8;
-	priority-=8;
 
 	for (i=0;i<8-(x&7);i++){ // スクロール補正 // Scroll correction
 		*(dat)=*(dat+(x&7));
@@ -514,49 +431,10 @@ void lcd::bg_render_color(void *buf,int scanline)
 			prefix=256;
 		}
 
-		tile=*(now_tile++);
 		atr=*(now_atr++);
-
 		pal=mapped_pal[atr&7];
-		bank=(atr<<9)&0x1000;
-		tmp_dat=(tile&0x80)?*(((atr&0x40)?now_share2:now_share)+(tile<<3)+bank):*(((atr&0x40)?now_pat2:now_pat)+(tile<<3)+bank);
-
-		calc1=tmp_dat;
-		calc2=tmp_dat>>7;
-		calc1&=0x55;
-		calc2&=0xAA;
-		calc1|=calc2;
-		calc2=tmp_dat>>1;
-		tmp_dat>>=8;
-		calc2&=0x55;
-		tmp_dat&=0xAA;
-		calc2|=tmp_dat;
-
-		if (atr&0x20){ // 反転する
-			byte tmp_p=calc2;
-			calc2=((calc1>>2)&0x33)|((calc1<<2)&0xcc);
-			ROL_BYTE(calc2,4);
-			calc1=((tmp_p>>2)&0x33)|((tmp_p<<2)&0xcc);
-			ROL_BYTE(calc1,4);
-		}
-
-		*(dat++)=pal[calc2>>6];
-		*(dat++)=pal[calc1>>6];
-		*(dat++)=pal[(calc2>>4)&3];
-		*(dat++)=pal[(calc1>>4)&3];
-		*(dat++)=pal[(calc2>>2)&3];
-		*(dat++)=pal[(calc1>>2)&3];
-		*(dat++)=pal[calc2&3];
-		*(dat++)=pal[calc1&3];
-
-		*(trans++)=(calc2>>6);
-		*(trans++)=(calc1>>6);
-		*(trans++)=(calc2>>4)&3;
-		*(trans++)=(calc1>>4)&3;
-		*(trans++)=(calc2>>2)&3;
-		*(trans++)=(calc1>>2)&3;
-		*(trans++)=calc2&3;
-		*(trans++)=calc1&3;
+		put_tile_row(dat,trans,tile_row(((atr>>3)&1)*384+tile_slot(*(now_tile++),pat),(atr&0x40)?7-(y&7):(y&7)),pal,(atr&0x20)!=0);
+		dat+=8; trans+=8;
 
 		memset(priority,(atr&0x80),8);
 		priority+=8;
@@ -578,16 +456,12 @@ void lcd::win_render_color(void *buf,int scanline)
 	int y=now_win_line-1/*scanline-res->system_reg.WY*/;
 	now_win_line++;
 
-	byte *vrams[2]={ref_gb->get_cpu()->get_vram(),ref_gb->get_cpu()->get_vram()+0x2000};
-
 	word back=(ref_gb->get_regs()->LCDC&0x40)?0x1C00:0x1800;
 	word pat=(ref_gb->get_regs()->LCDC&0x10)?0x0000:0x1000;
-	word share=0x0000;//prefix
-	word *pal;
+	const word *pal;
 	word *dat=(word*)buf;
 	byte *trans=trans_tbl;
 	byte *priority=priority_tbl;
-	byte tile;
 	int i;
 
 	dat+=160*scanline+ref_gb->get_regs()->WX-7;
@@ -595,57 +469,13 @@ void lcd::win_render_color(void *buf,int scanline)
 	priority+=ref_gb->get_regs()->WX-7;
 	byte *now_tile=ref_gb->get_cpu()->get_vram()+back+(((y>>3)-1)<<5);
 	byte *now_atr=ref_gb->get_cpu()->get_vram()+back+(((y>>3)-1)<<5)+0x2000;
-	word *now_share=(word*)(ref_gb->get_cpu()->get_vram()+share+((y&7)<<1));
-	word *now_pat=(word*)(ref_gb->get_cpu()->get_vram()+pat+((y&7)<<1));
-	word *now_share2=(word*)(vrams[0]+share+14-((y&7)<<1));
-	word *now_pat2=(word*)(vrams[0]+pat+14-((y&7)<<1));
-	dword tmp_dat;
-	dword calc1,calc2;
 	byte atr;
-	word bank;
 
 	for (i=ref_gb->get_regs()->WX>>3;i<21;i++){
-		tile=*(now_tile++);
 		atr=*(now_atr++);
-		bank=(atr<<9)&0x1000;
 		pal=mapped_pal[atr&7];
-		tmp_dat=(tile&0x80)?*(((atr&0x40)?now_share2:now_share)+(tile<<3)+bank):*(((atr&0x40)?now_pat2:now_pat)+(tile<<3)+bank);
-		calc1=tmp_dat;
-		calc2=tmp_dat>>7;
-		calc1&=0x55;
-		calc2&=0xAA;
-		calc1|=calc2;
-		calc2=tmp_dat>>1;
-		tmp_dat>>=8;
-		calc2&=0x55;
-		tmp_dat&=0xAA;
-		calc2|=tmp_dat;
-
-		if (atr&0x20){ // 反転する
-			byte tmp_p=calc2;
-			calc2=((calc1>>2)&0x33)|((calc1<<2)&0xcc);
-			ROL_BYTE(calc2,4);
-			calc1=((tmp_p>>2)&0x33)|((tmp_p<<2)&0xcc);
-			ROL_BYTE(calc1,4);
-		}
-
-		*(dat++)=pal[calc2>>6];
-		*(dat++)=pal[calc1>>6];
-		*(dat++)=pal[(calc2>>4)&3];
-		*(dat++)=pal[(calc1>>4)&3];
-		*(dat++)=pal[(calc2>>2)&3];
-		*(dat++)=pal[(calc1>>2)&3];
-		*(dat++)=pal[calc2&3];
-		*(dat++)=pal[calc1&3];
-
-		*(trans++)=(calc2>>6);
-		*(trans++)=(calc1>>6);
-		*(trans++)=(calc2>>4)&3;
-		*(trans++)=(calc1>>4)&3;
-		*(trans++)=(calc2>>2)&3;
-		*(trans++)=(calc1>>2)&3;
-		*(trans++)=calc2&3;
-		*(trans++)=calc1&3;
+		put_tile_row(dat,trans,tile_row(((atr>>3)&1)*384+tile_slot(*(now_tile++),pat),(atr&0x40)?7-(y&7):(y&7)),pal,(atr&0x20)!=0);
+		dat+=8; trans+=8;
 
 		memset(priority,(atr&0x80),8);
 		priority+=8;
@@ -657,17 +487,24 @@ void lcd::sprite_render_color(void *buf,int scanline)
 	if (!(ref_gb->get_regs()->LCDC&0x80)||!(ref_gb->get_regs()->LCDC&0x02))
 		return;
 
-	word *sdat=((word*)buf)+(scanline)*160,*now_pos;
-	int x,y,tile,atr,i,now;
+	word *sdat=((word*)buf)+(scanline)*160;
+	int x,y,tile,atr,i,n,now;
 	word l1,l2,tmp_dat;
-	word *cur_p;
+	const word *cur_p;
 	byte *oam=ref_gb->get_cpu()->get_oam(),*vram=ref_gb->get_cpu()->get_vram();
+	byte col[8],drawn[160];
 
 	bool sp_size=(ref_gb->get_regs()->LCDC&0x04)?true:false;
 
 	word bank;
 
-	for (i=39;i>=0;i--){
+	if (sprite_dirty||sprite_tall!=sp_size)
+		build_sprite_buckets(sp_size);
+
+	memset(drawn,0,sizeof(drawn));
+
+	for (n=0;n<sprite_line_count[scanline];n++){
+		i=sprite_line[scanline][n];
 		tile=oam[i*4+2];
 		atr=oam[i*4+3];
 		cur_p=mapped_pal[(atr&7)+8];
@@ -676,8 +513,6 @@ void lcd::sprite_render_color(void *buf,int scanline)
 		if (sp_size){ // 8*16
 			y=oam[i*4]-1;
 			x=oam[i*4+1]-8;
-			if ((x==-8&&y==-16)||x>160||y>144+15||(y<scanline)||(y>scanline+15))
-				continue;
 
 			if (scanline-y+15<8){ //上半分
 				now=(atr&0x40)?((y-scanline)&7):((7-(y-scanline)) &7);
@@ -691,14 +526,11 @@ void lcd::sprite_render_color(void *buf,int scanline)
 		else{ // 8*8
 			y=oam[i*4]-9;
 			x=oam[i*4+1]-8;
-			if ((x==-8&&y==-16)||(x>160)||(y>144+7)||(y<scanline)||(y>scanline+7))
-				continue;
 
 			now=(atr&0x40)?((y-scanline)&7):((7-(y-scanline)) & 7);
 			tmp_dat=*(word*)(vram+tile*16+now*2+bank);
 		}
 		sprite_count++;
-		now_pos=sdat+x; // now_pos=現在地点
 
 		l1=tmp_dat;
 		l2=tmp_dat>>7;
@@ -719,54 +551,27 @@ void lcd::sprite_render_color(void *buf,int scanline)
 			ROL_BYTE(l1,4);
 		}
 
-		if (x<0){ // クリッピング処理
+		unpack_sprite_row(l1,l2,col);
+
+		for (int k=(x<0)?-x:0;k<8&&x+k<160;k++){ // クリッピング処理
+			if (!col[k]||drawn[x+k])
+				continue;
 			if (atr&0x80){ // プライオリティ(背面に)
-				if ((-x)<=1) if (!trans_tbl[x+1]) if (l1>>6) *(now_pos+1)=cur_p[l1>>6];
-				if ((-x)<=2) if (!trans_tbl[x+2]) if ((l2>>4)&3) *(now_pos+2)=cur_p[(l2>>4)&3];
-				if ((-x)<=3) if (!trans_tbl[x+3]) if ((l1>>4)&3) *(now_pos+3)=cur_p[(l1>>4)&3];
-				if ((-x)<=4) if (!trans_tbl[x+4]) if ((l2>>2)&3) *(now_pos+4)=cur_p[(l2>>2)&3];
-				if ((-x)<=5) if (!trans_tbl[x+5]) if ((l1>>2)&3) *(now_pos+5)=cur_p[(l1>>2)&3];
-				if ((-x)<=6) if (!trans_tbl[x+6]) if (l2&3) *(now_pos+6)=cur_p[l2&3];
-				if ((-x)<=7) if (!trans_tbl[x+7]) if (l1&3) *(now_pos+7)=cur_p[l1&3];
-			}
-			else{
-				if ((-x)<=1) if (!(priority_tbl[x+1]&&trans_tbl[x+1])) if (l1>>6) *(now_pos+1)=cur_p[l1>>6];
-				if ((-x)<=2) if (!(priority_tbl[x+2]&&trans_tbl[x+2])) if ((l2>>4)&3) *(now_pos+2)=cur_p[(l2>>4)&3];
-				if ((-x)<=3) if (!(priority_tbl[x+3]&&trans_tbl[x+3])) if ((l1>>4)&3) *(now_pos+3)=cur_p[(l1>>4)&3];
-				if ((-x)<=4) if (!(priority_tbl[x+4]&&trans_tbl[x+4])) if ((l2>>2)&3) *(now_pos+4)=cur_p[(l2>>2)&3];
-				if ((-x)<=5) if (!(priority_tbl[x+5]&&trans_tbl[x+5])) if ((l1>>2)&3) *(now_pos+5)=cur_p[(l1>>2)&3];
-				if ((-x)<=6) if (!(priority_tbl[x+6]&&trans_tbl[x+6])) if (l2&3) *(now_pos+6)=cur_p[l2&3];
-				if ((-x)<=7) if (!(priority_tbl[x+7]&&trans_tbl[x+7])) if (l1&3) *(now_pos+7)=cur_p[l1&3];
-			}
-		}
-		else{
-			if (atr&0x80){
-				if (!trans_tbl[x+0]) if (l2>>6) *(now_pos)=cur_p[l2>>6];
-				if (!trans_tbl[x+1]) if (l1>>6) *(now_pos+1)=cur_p[l1>>6];
-				if (!trans_tbl[x+2]) if ((l2>>4)&3) *(now_pos+2)=cur_p[(l2>>4)&3];
-				if (!trans_tbl[x+3]) if ((l1>>4)&3) *(now_pos+3)=cur_p[(l1>>4)&3];
-				if (!trans_tbl[x+4]) if ((l2>>2)&3) *(now_pos+4)=cur_p[(l2>>2)&3];
-				if (!trans_tbl[x+5]) if ((l1>>2)&3) *(now_pos+5)=cur_p[(l1>>2)&3];
-				if (!trans_tbl[x+6]) if (l2&3) *(now_pos+6)=cur_p[l2&3];
-				if (!trans_tbl[x+7]) if (l1&3) *(now_pos+7)=cur_p[l1&3];
-			}
-			else{
-				if (!(priority_tbl[x]&&trans_tbl[x])) if (l2>>6) *(now_pos)=cur_p[l2>>6];
-				if (!(priority_tbl[x+1]&&trans_tbl[x+1])) if (l1>>6) *(now_pos+1)=cur_p[l1>>6];
-				if (!(priority_tbl[x+2]&&trans_tbl[x+2])) if ((l2>>4)&3) *(now_pos+2)=cur_p[(l2>>4)&3];
-				if (!(priority_tbl[x+3]&&trans_tbl[x+3])) if ((l1>>4)&3) *(now_pos+3)=cur_p[(l1>>4)&3];
-				if (!(priority_tbl[x+4]&&trans_tbl[x+4])) if ((l2>>2)&3) *(now_pos+4)=cur_p[(l2>>2)&3];
-				if (!(priority_tbl[x+5]&&trans_tbl[x+5])) if ((l1>>2)&3) *(now_pos+5)=cur_p[(l1>>2)&3];
-				if (!(priority_tbl[x+6]&&trans_tbl[x+6])) if (l2&3) *(now_pos+6)=cur_p[l2&3];
-				if (!(priority_tbl[x+7]&&trans_tbl[x+7])) if (l1&3) *(now_pos+7)=cur_p[l1&3];
+				if (trans_tbl[x+k])
+					continue;
 			}
+			else if (priority_tbl[x+k]&&trans_tbl[x+k])
+				continue;
+			drawn[x+k]=1;
+			sdat[x+k]=cur_p[col[k]];
 		}
 	}
 }
 
-
 void lcd::render(void *buf,int scanline)
 {
+	STAT_TIMER(ref_gb,STAT_TIME_LCD_RENDER);
+	STAT_INC(ref_gb,STAT_LINES_RENDERED);
 	sprite_count=0;
 
 	if (ref_gb->get_rom()->get_info()->gb_type>=3){
@@ -779,7 +584,7 @@ void lcd::render(void *buf,int scanline)
 			sprite_render_color(buf,scanline);
 		}
 		else{
-			memset(((word*)buf)+160*scanline,0x00,160*2);
+			memset(((word*)buf)+160*scanline,0x00,160*sizeof(word));
 			if (layer_enable[0])
 				bg_render_color(buf,scanline);
 			if (layer_enable[1])
@@ -795,7 +600,7 @@ void lcd::render(void *buf,int scanline)
 			sprite_render(buf,scanline);
 		}
 		else{
-			memset(((word*)buf)+160*scanline,0x00,160*2);
+			memset(((word*)buf)+160*scanline,0x00,160*sizeof(word));
 			if (layer_enable[0])
 				bg_render(buf,scanline);
 			if (layer_enable[1])
@@ -806,8 +611,77 @@ void lcd::render(void *buf,int scanline)
 	}
 }
 
-void lcd::serialize(serializer &s)
+void lcd::set_deferred(bool enable)
+{
+	sync();
+	deferred=enable;
+}
+
+void lcd::defer(void *buf,int scanline)
+{
+	if (!deferred){
+		render(buf,scanline);
+		return;
+	}
+
+	// 連続していなければ先に描画する // Not contiguous with the pending run, rasterise it first
+	if (pend_count&&(buf!=pend_buf||scanline!=pend_first+pend_count||pend_count>=144))
+		flush();
+	if (!pend_count){
+		pend_buf=buf;
+		pend_first=scanline;
+	}
+
+	gb_regs *r=ref_gb->get_regs();
+	line_regs *l=&pend_regs[pend_count++];
+	l->LCDC=r->LCDC; l->SCX=r->SCX; l->SCY=r->SCY; l->WX=r->WX;
+	l->WY=r->WY; l->BGP=r->BGP; l->OBP1=r->OBP1; l->OBP2=r->OBP2;
+}
+
+// 記録したレジスタを一時的に戻して描画する
+// Rasterises the pending lines with their recorded registers swapped in
+void lcd::flush()
+{
+	if (!pend_count)
+		return;
+
+	if (!frame_wanted){
+		STAT_ADD(ref_gb,STAT_LINES_SKIPPED,pend_count);
+		pend_count=0;
+		return;
+	}
+	render_pending();
+}
+
+void lcd::render_pending()
+{
+	int count=pend_count;
+	pend_count=0;
+
+	gb_regs *r=ref_gb->get_regs();
+	line_regs cur={r->LCDC,r->SCX,r->SCY,r->WX,r->WY,r->BGP,r->OBP1,r->OBP2};
+
+	for (int i=0;i<count;i++){
+		line_regs *l=&pend_regs[i];
+		r->LCDC=l->LCDC; r->SCX=l->SCX; r->SCY=l->SCY; r->WX=l->WX;
+		r->WY=l->WY; r->BGP=l->BGP; r->OBP1=l->OBP1; r->OBP2=l->OBP2;
+		render(pend_buf,pend_first+i);
+	}
+
+	r->LCDC=cur.LCDC; r->SCX=cur.SCX; r->SCY=cur.SCY; r->WX=cur.WX;
+	r->WY=cur.WY; r->BGP=cur.BGP; r->OBP1=cur.OBP1; r->OBP2=cur.OBP2;
+}
+
+template <class S> void lcd::serialize(S &s)
 {
+	// 描画待ちのラインは間引き中でも描画する (ステートの trans_tbl などが表示の有無で変わらないように)
+	// Pending lines are rendered even when the frame is culled, so the line state
+	// saved here does not depend on whether the frame is displayed
+	if (pend_count)
+		render_pending();
+	sprite_dirty=true;
+	if (s.loading())
+		invalidate_all_tiles();
 	s_ARRAY(m_pal16);
 	s_ARRAY(m_pal32);
 	s_ARRAY(col_pal); // the only one that was in the original state format.
@@ -821,3 +695,5 @@ void lcd::serialize(serializer &s)
 	s_ARRAY(layer_enable);
 }
 
+SERIALIZE_INSTANTIATE(lcd);
+
@@ -70,13 +70,15 @@ void mbc::reset()
 		ext_is_ram=false;
 	}
 
+	bind_handlers();
+
 	huc3_haltTime = huc3_baseTime = 0;
 	huc3_dataTime = huc3_writingTime = 0;
 	huc3_ramValue = huc3_shift = huc3_current_mem_control_reg = huc3_modeflag = huc3_access_adress = 0;
 	huc3_halted = false;
 
 	
-	huc3_rtc_register = (byte*)calloc(0xFF, sizeof(byte));
+	memset(huc3_rtc_register, 0, sizeof(huc3_rtc_register));
 	/*
 	for (int i = 0; i < 0xFF; i++)
 	{
@@ -92,332 +94,246 @@ byte mbc::read(word adr)
 	return 0;
 }
 
-void mbc::write(word adr,byte dat)
+byte mbc::nop_ext_read(word /*adr*/)
 {
-	switch(ref_gb->get_rom()->get_info()->cart_type){
-	case 1:
-	case 2:
-	case 3:
-		mbc1_write(adr,dat);
-		break;
-	case 5:
-	case 6:
-		mbc2_write(adr,dat);
-		break;
-	case 0x0F:
-	case 0x10:
-	case 0x11:
-	case 0x12:
-	case 0x13:
-		mbc3_write(adr,dat);
-		break;
-	case 0x19:
-	case 0x1A:
-	case 0x1B:
-	case 0x1C:
-	case 0x1D:
-	case 0x1E:
-		mbc5_write(adr,dat);
-		break;
-	case 0x22:
-		mbc7_write(adr,dat);
-		break;
-	case 0xFD:
-		tama5_write(adr,dat);
-		break;
-	case 0xFE:
-		huc3_write(adr,dat);
-		break;
-	case 0xFF:
-		huc1_write(adr,dat);
-		break;
-	case 0x100:
-		mmm01_write(adr,dat);
-		break;
+	return 0;
+}
+
+void mbc::nop_write(word /*adr*/,byte /*dat*/)
+{
+}
+
+byte mbc::mbc3_ext_read(word /*adr*/)
+{
+//	extern FILE *file;
+//	fprintf(file,"external read [%04X]\n",adr);
+	if (mbc3_latch){
+		switch(mbc3_timer){
+		case 8: return mbc3_sec;
+		case 9: return mbc3_min;
+		case 10: return mbc3_hour;
+		case 11: return mbc3_dayl;
+		case 12: return mbc3_dayh;
+		}
 	}
+	return ref_gb->get_renderer()->get_time(mbc3_timer);
 }
 
-byte mbc::ext_read(word adr)
+void mbc::mbc3_ext_write(word /*adr*/,byte dat)
 {
-	switch(ref_gb->get_rom()->get_info()->cart_type){
-	case 1:
-	case 2:
-	case 3:
-	case 5:
-	case 6:
+	ref_gb->get_renderer()->set_time(mbc3_timer,dat);
+}
+
+byte mbc::mbc7_ext_read(word adr) // コロコロカービィ // Korokoro Kirby
+{
+	switch(adr&0xa0f0)
+	{
+	case 0xA000:
 		return 0;
-	case 0x0F:
-	case 0x10:
-	case 0x11:
-	case 0x12:
-	case 0x13:
-//		extern FILE *file;
-//		fprintf(file,"external read [%04X]\n",adr);
-		if (mbc3_latch){
-			switch(mbc3_timer){
-			case 8: return mbc3_sec;
-			case 9: return mbc3_min;
-			case 10: return mbc3_hour;
-			case 11: return mbc3_dayl;
-			case 12: return mbc3_dayh;
-			}
-		}
-		return ref_gb->get_renderer()->get_time(mbc3_timer);
-	case 0x19:
-	case 0x1A:
-	case 0x1B:
-	case 0x1C:
-	case 0x1D:
-	case 0x1E:
+	case 0xA010:
 		return 0;
-	case 0x22: // コロコロカービィ // Korokoro Kirby
-		switch(adr&0xa0f0)
-		{
-		case 0xA000:
-			return 0;
-		case 0xA010:
-			return 0;
-		case 0xA020:
-			return ref_gb->get_renderer()->get_sensor(true)&0xff;
-		case 0xA030:
-			return (ref_gb->get_renderer()->get_sensor(true)>>8)&0xf;
-		case 0xA040:
-			return ref_gb->get_renderer()->get_sensor(false)&0xff;
-		case 0xA050:
-			return (ref_gb->get_renderer()->get_sensor(false)>>8)&0xf;
-		case 0xA060:
-			return 0;
-		case 0xA070:
-			return 0;
-		case 0xA080:
-			return mbc7_ret;
-		}
-		return 0xff;
-	case 0xFD:
-//		extern FILE *file;
-//		fprintf(file,"%04X : TAMA5 ext_read %04X \n",ref_gb->get_cpu()->get_regs()->PC,adr);
-		return 1;
-	case 0xFE:
-//		extern FILE *file;
-//		fprintf(file,"%04X : HuC-3 ext_read %04X \n",ref_gb->get_cpu()->get_regs()->PC,adr);
-
-		return huc3_read(adr);
-	case 0xFF:
+	case 0xA020:
+		return ref_gb->get_renderer()->get_sensor(true)&0xff;
+	case 0xA030:
+		return (ref_gb->get_renderer()->get_sensor(true)>>8)&0xf;
+	case 0xA040:
+		return ref_gb->get_renderer()->get_sensor(false)&0xff;
+	case 0xA050:
+		return (ref_gb->get_renderer()->get_sensor(false)>>8)&0xf;
+	case 0xA060:
+		return 0;
+	case 0xA070:
 		return 0;
+	case 0xA080:
+		return mbc7_ret;
 	}
-	return 0;
+	return 0xff;
 }
 
-void mbc::ext_write(word adr,byte dat)
+void mbc::mbc7_ext_write(word adr,byte dat)
 {
 	int i;
 
-	switch(ref_gb->get_rom()->get_info()->cart_type){
-	case 1:
-	case 2:
-	case 3:
-	case 5:
-	case 6:
-	case 0x19:
-	case 0x1A:
-	case 0x1B:
-	case 0x1C:
-	case 0x1D:
-	case 0x1E:
-	case 0xFF:
-		break;
-	case 0x0F:
-	case 0x10:
-	case 0x11:
-	case 0x12:
-	case 0x13:
-		ref_gb->get_renderer()->set_time(mbc3_timer,dat);
-		break;
-	case 0xFE: //HuC-3
-//		extern FILE *file;
-//		fprintf(file,"%04X : HuC-3 ext_write %04X <= %02X\n",ref_gb->get_cpu()->get_regs()->PC,adr,dat);
-		huc3_write(adr, dat);
-		break;
-	case 0xFD: //TAMA5
-//		extern FILE *file;
-//		fprintf(file,"%04X : TAMA5 ext_write %04X <= %02X\n",ref_gb->get_cpu()->get_regs()->PC,adr,dat);
-		break;
-	case 0x22: // コロコロカービィ // Korokoro Kirby
-		if (adr==0xA080){
-			int bef_cs=mbc7_cs,bef_sk=mbc7_sk;
-
-			mbc7_cs=dat>>7;
-			mbc7_sk=(dat>>6)&1;
-
-			if (!bef_cs&&mbc7_cs){
-				if (mbc7_state==5){
-					if (mbc7_write_enable){
-						*(ref_gb->get_rom()->get_sram()+mbc7_adr*2)=mbc7_buf>>8;
-						*(ref_gb->get_rom()->get_sram()+mbc7_adr*2+1)=mbc7_buf&0xff;
+	if (adr==0xA080){
+		int bef_cs=mbc7_cs,bef_sk=mbc7_sk;
+
+		mbc7_cs=dat>>7;
+		mbc7_sk=(dat>>6)&1;
+
+		if (!bef_cs&&mbc7_cs){
+			if (mbc7_state==5){
+				if (mbc7_write_enable){
+					*(ref_gb->get_rom()->get_sram()+mbc7_adr*2)=mbc7_buf>>8;
+					*(ref_gb->get_rom()->get_sram()+mbc7_adr*2+1)=mbc7_buf&0xff;
 ////						fprintf(file,"書き込み完了\n");
 //						fprintf(file,"Write complete\n");
-					}
-					mbc7_state=0;
-					mbc7_ret=1;
+				}
+				mbc7_state=0;
+				mbc7_ret=1;
 ////					fprintf(file,"書き込み受理 ステート:なし\n");
 //					fprintf(file,"State writing acceptance: no\n");
-				}
-				else{
-					mbc7_idle=true; // アイドル状態突入
-					mbc7_state=0;
+			}
+			else{
+				mbc7_idle=true; // アイドル状態突入
+				mbc7_state=0;
 ////					fprintf(file,"アイドル状態突入 ステート:アイドル状態\n");
 //					fprintf(file,"Idle: idle state rush\n");
-				}
 			}
+		}
 
-			if (!bef_sk&&mbc7_sk){ // クロック立ち上がり // Rising edge of the clock
-				if (mbc7_idle){ // アイドル状態であれば // If idle
-					if (dat&0x02){
-						mbc7_idle=false; // アイドル状態解除 // Idle state release
-						mbc7_count=0;
-						mbc7_state=1;
+		if (!bef_sk&&mbc7_sk){ // クロック立ち上がり // Rising edge of the clock
+			if (mbc7_idle){ // アイドル状態であれば // If idle
+				if (dat&0x02){
+					mbc7_idle=false; // アイドル状態解除 // Idle state release
+					mbc7_count=0;
+					mbc7_state=1;
 ////						fprintf(file,"アイドル状態解除 ステート:コマンド認識\n");
 //						fprintf(file,"Command recognition: release idle state\n");
-					}
 				}
-				else{
-					switch(mbc7_state){
-					case 1: // コマンド受付 // Command reception
-						mbc7_buf<<=1;
-						mbc7_buf|=(dat&0x02)?1:0;
-						mbc7_count++;
-						if (mbc7_count==2){ // 受付終了 // Exit Reception
-							mbc7_state=2;
-							mbc7_count=0;
-							mbc7_op_code=mbc7_buf&3;
-						}
-						break;
-					case 2: // アドレス受信 // Address received
-						mbc7_buf<<=1;
-						mbc7_buf|=(dat&0x02)?1:0;
-						mbc7_count++;
-						if (mbc7_count==8){ // 受付終了 // Exit Reception
-							mbc7_state=3;
-							mbc7_count=0;
-							mbc7_adr=mbc7_buf&0xff;
-							if (mbc7_op_code==0){
-								if ((mbc7_adr>>6)==0){
+			}
+			else{
+				switch(mbc7_state){
+				case 1: // コマンド受付 // Command reception
+					mbc7_buf<<=1;
+					mbc7_buf|=(dat&0x02)?1:0;
+					mbc7_count++;
+					if (mbc7_count==2){ // 受付終了 // Exit Reception
+						mbc7_state=2;
+						mbc7_count=0;
+						mbc7_op_code=mbc7_buf&3;
+					}
+					break;
+				case 2: // アドレス受信 // Address received
+					mbc7_buf<<=1;
+					mbc7_buf|=(dat&0x02)?1:0;
+					mbc7_count++;
+					if (mbc7_count==8){ // 受付終了 // Exit Reception
+						mbc7_state=3;
+						mbc7_count=0;
+						mbc7_adr=mbc7_buf&0xff;
+						if (mbc7_op_code==0){
+							if ((mbc7_adr>>6)==0){
 ////									fprintf(file,"書き込み消去禁止 ステート:なし\n");
 //									fprintf(file,"erasing state prohibited : No\n");
-									mbc7_write_enable=false;
-									mbc7_state=0;
-								}
-								else if ((mbc7_adr>>6)==3){
+								mbc7_write_enable=false;
+								mbc7_state=0;
+							}
+							else if ((mbc7_adr>>6)==3){
 ////									fprintf(file,"書き込み消去許可 ステート:なし\n");
 //									fprintf(file,"erasing the authorized state : No\n");
-									mbc7_write_enable=true;
-									mbc7_state=0;
-								}
+								mbc7_write_enable=true;
+								mbc7_state=0;
 							}
-							else{
+						}
+						else{
 ////								fprintf(file,"アドレス:%02X ステート:データ受信\n",mbc7_adr);
 //								fprintf(file,"Address: %02X State: Data reception\n",mbc7_adr);
-							}
 						}
-						break;
-					case 3: // データ // Data
-						mbc7_buf<<=1;
-						mbc7_buf|=(dat&0x02)?1:0;
-						mbc7_count++;
-
-						switch(mbc7_op_code){
-						case 0:
-							if (mbc7_count==16){
-								if ((mbc7_adr>>6)==0){
+					}
+					break;
+				case 3: // データ // Data
+					mbc7_buf<<=1;
+					mbc7_buf|=(dat&0x02)?1:0;
+					mbc7_count++;
+
+					switch(mbc7_op_code){
+					case 0:
+						if (mbc7_count==16){
+							if ((mbc7_adr>>6)==0){
 ////									fprintf(file,"書き込み消去禁止 ステート:なし\n");
 //									fprintf(file,"erasing state prohibited : No\n");
-									mbc7_write_enable=false;
-									mbc7_state=0;
-								}
-								else if ((mbc7_adr>>6)==1){
-									if (mbc7_write_enable){
-										for (i=0;i<256;i++){
-											*(ref_gb->get_rom()->get_sram()+i*2)=mbc7_buf>>8;
-											*(ref_gb->get_rom()->get_sram()+i*2)=mbc7_buf&0xff;
-										}
+								mbc7_write_enable=false;
+								mbc7_state=0;
+							}
+							else if ((mbc7_adr>>6)==1){
+								if (mbc7_write_enable){
+									for (i=0;i<256;i++){
+										*(ref_gb->get_rom()->get_sram()+i*2)=mbc7_buf>>8;
+										*(ref_gb->get_rom()->get_sram()+i*2)=mbc7_buf&0xff;
 									}
+								}
 ////									fprintf(file,"全アドレス書き込み %04X ステート:なし\n",mbc7_buf);
 //									fprintf(file,"Write all addresses %04X State: No\n",mbc7_buf);
-									mbc7_state=5;
+								mbc7_state=5;
+							}
+							else if ((mbc7_adr>>6)==2){
+								if (mbc7_write_enable){
+									for (i=0;i<256;i++)
+										*(word*)(ref_gb->get_rom()->get_sram()+i*2)=0xffff;
 								}
-								else if ((mbc7_adr>>6)==2){
-									if (mbc7_write_enable){
-										for (i=0;i<256;i++)
-											*(word*)(ref_gb->get_rom()->get_sram()+i*2)=0xffff;
-									}
 ////									fprintf(file,"全アドレス消去 ステート:なし\n");
 //									fprintf(file,"erased state all addresses : None\n");
-									mbc7_state=5;
-								}
-								else if ((mbc7_adr>>6)==3){
+								mbc7_state=5;
+							}
+							else if ((mbc7_adr>>6)==3){
 ////									fprintf(file,"書き込み消去許可 ステート:なし\n");
 //									fprintf(file,"erasing the authorized state : No\n");
-									mbc7_write_enable=true;
-									mbc7_state=0;
-								}
-								mbc7_count=0;
+								mbc7_write_enable=true;
+								mbc7_state=0;
 							}
-							break;
-						case 1:
-							if (mbc7_count==16){
+							mbc7_count=0;
+						}
+						break;
+					case 1:
+						if (mbc7_count==16){
 ////								fprintf(file,"書き込み [%02X]<-%04X ステート:書き込み待ちフレーム\n",mbc7_adr,mbc7_buf);
 //								fprintf(file,"Writing [%02X]<-%04X State: Frame waiting to be written\n",mbc7_adr,mbc7_buf);
-								mbc7_count=0;
-								mbc7_state=5;
-								mbc7_ret=0;
-							}
-							break;
-						case 2:
-							if (mbc7_count==1){
+							mbc7_count=0;
+							mbc7_state=5;
+							mbc7_ret=0;
+						}
+						break;
+					case 2:
+						if (mbc7_count==1){
 ////								fprintf(file,"ダミー受信完了 ステート:読み出し可\n");
 //								fprintf(file,"Readable: State reception complete dummy\n");
-								mbc7_state=4;
-								mbc7_count=0;
-								mbc7_buf=(ref_gb->get_rom()->get_sram()[mbc7_adr*2]<<8)|(ref_gb->get_rom()->get_sram()[mbc7_adr*2+1]);
+							mbc7_state=4;
+							mbc7_count=0;
+							mbc7_buf=(ref_gb->get_rom()->get_sram()[mbc7_adr*2]<<8)|(ref_gb->get_rom()->get_sram()[mbc7_adr*2+1]);
 ////								fprintf(file,"受信データ %04X\n",mbc7_buf);
 //								fprintf(file,"Received data %04X\n",mbc7_buf);
-							}
-							break;
-						case 3:
-							if (mbc7_count==16){
+						}
+						break;
+					case 3:
+						if (mbc7_count==16){
 ////								fprintf(file,"消去 [%02X] ステート:書き込み待ちフレーム\n",mbc7_adr,mbc7_buf);
 //								fprintf(file,"Elimination [%02X] State: Frame waiting to be written\n",mbc7_adr,mbc7_buf);
-								mbc7_count=0;
-								mbc7_state=5;
-								mbc7_ret=0;
-								mbc7_buf=0xffff;
-							}
-							break;
+							mbc7_count=0;
+							mbc7_state=5;
+							mbc7_ret=0;
+							mbc7_buf=0xffff;
 						}
 						break;
 					}
+					break;
 				}
 			}
+		}
 
-			if (bef_sk&&!mbc7_sk){ // クロック立ち下り // Falling clock
-				if (mbc7_state==4){ // 読み出し中 // While reading
-					mbc7_ret=(mbc7_buf&0x8000)?1:0;
-					mbc7_buf<<=1;
-					mbc7_count++;
+		if (bef_sk&&!mbc7_sk){ // クロック立ち下り // Falling clock
+			if (mbc7_state==4){ // 読み出し中 // While reading
+				mbc7_ret=(mbc7_buf&0x8000)?1:0;
+				mbc7_buf<<=1;
+				mbc7_count++;
 ////					fprintf(file,"読み出し中 %d ビット目\n",mbc7_count);
 //					fprintf(file,"While reading %dth bit\n",mbc7_count);
-					if (mbc7_count==16){
-						mbc7_count=0;
-						mbc7_state=0;
+				if (mbc7_count==16){
+					mbc7_count=0;
+					mbc7_state=0;
 ////						fprintf(file,"読み出し完了 ステート:なし\n");
 //						fprintf(file,"Read state complete: No\n");
-					}
 				}
 			}
 		}
-
-		break;
 	}
+
+}
+
+byte mbc::tama5_ext_read(word /*adr*/)
+{
+//	extern FILE *file;
+//	fprintf(file,"%04X : TAMA5 ext_read %04X \n",ref_gb->get_cpu()->get_regs()->PC,adr);
+	return 1;
 }
 
 int mbc::get_state()
@@ -506,6 +422,75 @@ void mbc::set_page(int rom,int sram)
 static int rom_size_tbl[]={2,4,8,16,32,64,128,256,512};
 static int ram_size_tbl[]={0,1,1,4,16,8};
 
+void mbc::bind_handlers()
+{
+	// カートリッジ種別ごとの処理はロード時に一度だけ決める // pick the per-cartridge handlers once at load instead of switching on every access
+	rom *r=ref_gb->get_rom();
+
+	write_proc=&mbc::nop_write;
+	ext_read_proc=&mbc::nop_ext_read;
+	ext_write_proc=&mbc::nop_write;
+
+	if (!r->get_loaded())
+		return;
+
+	rom_base=r->get_rom();
+	sram_base=r->get_sram();
+	rom_mask=rom_size_tbl[r->get_info()->rom_size]-1;
+	ram_mask=ram_size_tbl[r->get_info()->ram_size]-1;
+
+	switch(r->get_info()->cart_type){
+	case 1:
+	case 2:
+	case 3:
+		write_proc=&mbc::mbc1_write;
+		break;
+	case 5:
+	case 6:
+		write_proc=&mbc::mbc2_write;
+		break;
+	case 0x0F:
+	case 0x10:
+	case 0x11:
+	case 0x12:
+	case 0x13:
+		write_proc=&mbc::mbc3_write;
+		ext_read_proc=&mbc::mbc3_ext_read;
+		ext_write_proc=&mbc::mbc3_ext_write;
+		break;
+	case 0x19:
+	case 0x1A:
+	case 0x1B:
+		write_proc=&mbc::mbc5_write;
+		break;
+	case 0x1C:
+	case 0x1D:
+	case 0x1E:
+		write_proc=&mbc::mbc5_rumble_write;
+		break;
+	case 0x22:
+		write_proc=&mbc::mbc7_write;
+		ext_read_proc=&mbc::mbc7_ext_read;
+		ext_write_proc=&mbc::mbc7_ext_write;
+		break;
+	case 0xFD:
+		write_proc=&mbc::tama5_write;
+		ext_read_proc=&mbc::tama5_ext_read;
+		break;
+	case 0xFE:
+		write_proc=&mbc::huc3_write;
+		ext_read_proc=&mbc::huc3_read;
+		ext_write_proc=&mbc::huc3_write;
+		break;
+	case 0xFF:
+		write_proc=&mbc::huc1_write;
+		break;
+	case 0x100:
+		write_proc=&mbc::mmm01_write;
+		break;
+	}
+}
+
 void mbc::mbc1_write(word adr,byte dat)
 {
 	if (mbc1_16_8){//16/8モード
@@ -514,11 +499,11 @@ void mbc::mbc1_write(word adr,byte dat)
 			break;
 		case 1:
 			mbc1_dat=(mbc1_dat&0x60)+(dat&0x1F);
-			rom_page=ref_gb->get_rom()->get_rom()+0x4000*((mbc1_dat==0?1:mbc1_dat)&(rom_size_tbl[ref_gb->get_rom()->get_info()->rom_size]-1))-0x4000;
+			rom_page=rom_base+0x4000*((mbc1_dat==0?1:mbc1_dat)&rom_mask)-0x4000;
 			break;
 		case 2:
 			mbc1_dat=((dat<<5)&0x60)+(mbc1_dat&0x1F);
-			rom_page=ref_gb->get_rom()->get_rom()+0x4000*((mbc1_dat==0?1:mbc1_dat)&(rom_size_tbl[ref_gb->get_rom()->get_info()->rom_size]-1))-0x4000;
+			rom_page=rom_base+0x4000*((mbc1_dat==0?1:mbc1_dat)&rom_mask)-0x4000;
 			break;
 		case 3:
 			if (dat&1)
@@ -534,10 +519,10 @@ void mbc::mbc1_write(word adr,byte dat)
 		case 0:
 			break;
 		case 1:
-			rom_page=ref_gb->get_rom()->get_rom()+0x4000*((dat==0?1:dat)&0x1F&(rom_size_tbl[ref_gb->get_rom()->get_info()->rom_size]-1))-0x4000;
+			rom_page=rom_base+0x4000*((dat==0?1:dat)&0x1F&rom_mask)-0x4000;
 			break;
 		case 2:
-			sram_page=ref_gb->get_rom()->get_sram()+0x2000*(dat&3);
+			sram_page=sram_base+0x2000*(dat&3);
 			break;
 		case 3:
 			if (dat&1)
@@ -553,7 +538,7 @@ void mbc::mbc1_write(word adr,byte dat)
 void mbc::mbc2_write(word adr,byte dat)
 {
 	if ((adr>=0x2000)&&(adr<=0x3FFF))
-		rom_page=ref_gb->get_rom()->get_rom()+0x4000*(((dat&0x0F)==0?1:dat&0x0F)-1);
+		rom_page=rom_base+0x4000*(((dat&0x0F)==0?1:dat&0x0F)-1);
 }
 
 void mbc::mbc3_write(word adr,byte dat)
@@ -568,11 +553,11 @@ void mbc::mbc3_write(word adr,byte dat)
 		}
 		break;
 	case 1:
-		rom_page=ref_gb->get_rom()->get_rom()+0x4000*((dat==0?1:dat)&0x7F&(rom_size_tbl[ref_gb->get_rom()->get_info()->rom_size]-1))-0x4000;
+		rom_page=rom_base+0x4000*((dat==0?1:dat)&0x7F&rom_mask)-0x4000;
 		break;
 	case 2:
 		if (dat<8){
-			sram_page=ref_gb->get_rom()->get_sram()+0x2000*(dat&7&(ram_size_tbl[ref_gb->get_rom()->get_info()->ram_size]-1));
+			sram_page=sram_base+0x2000*(dat&7&ram_mask);
 			ext_is_ram=true;
 		}
 		else{
@@ -608,40 +593,45 @@ void mbc::mbc5_write(word adr,byte dat)
 	case 2:
 		mbc5_dat&=0x0100;
 		mbc5_dat|=dat;
-		rom_page=ref_gb->get_rom()->get_rom()+0x4000*(mbc5_dat&(rom_size_tbl[ref_gb->get_rom()->get_info()->rom_size]-1))-0x4000;
+		rom_page=rom_base+0x4000*(mbc5_dat&rom_mask)-0x4000;
 		break;
 	case 3:
 		mbc5_dat&=0x00FF;
 		mbc5_dat|=(dat&1)<<8;
-		rom_page=ref_gb->get_rom()->get_rom()+0x4000*(mbc5_dat&(rom_size_tbl[ref_gb->get_rom()->get_info()->rom_size]-1))-0x4000;
+		rom_page=rom_base+0x4000*(mbc5_dat&rom_mask)-0x4000;
 		break;
 	case 4:
 	case 5:
-		if (ref_gb->get_rom()->get_info()->cart_type==0x1C||ref_gb->get_rom()->get_info()->cart_type==0x1D||ref_gb->get_rom()->get_info()->cart_type==0x1E){//Rumble カートリッジ
-			sram_page=ref_gb->get_rom()->get_sram()+0x2000*(dat&0x07&(ram_size_tbl[ref_gb->get_rom()->get_info()->ram_size]-1));
-			if (dat&0x8)
-				ref_gb->get_renderer()->set_bibrate(true);
-			else
-				ref_gb->get_renderer()->set_bibrate(false);
-		}
-		else
-			sram_page=ref_gb->get_rom()->get_sram()+0x2000*(dat&0x0f&(ram_size_tbl[ref_gb->get_rom()->get_info()->ram_size]-1));
+		sram_page=sram_base+0x2000*(dat&0x0f&ram_mask);
 		break;
 	}
 }
 
+void mbc::mbc5_rumble_write(word adr,byte dat)
+{
+	if ((adr>>12)==4||(adr>>12)==5){//Rumble カートリッジ // Rumble cartridge
+		sram_page=sram_base+0x2000*(dat&0x07&ram_mask);
+		if (dat&0x8)
+			ref_gb->get_renderer()->set_bibrate(true);
+		else
+			ref_gb->get_renderer()->set_bibrate(false);
+	}
+	else
+		mbc5_write(adr,dat);
+}
+
 void mbc::mbc7_write(word adr,byte dat)
 {
 	switch(adr>>13){
 	case 0:
 		break;
 	case 1:
-		rom_page=ref_gb->get_rom()->get_rom()+0x4000*((dat==0?1:dat)&0x7F&(rom_size_tbl[ref_gb->get_rom()->get_info()->rom_size]-1))-0x4000;
-//		rom_page=ref_gb->get_rom()->get_rom()+0x4000*(dat&0x3f)-0x4000;
+		rom_page=rom_base+0x4000*((dat==0?1:dat)&0x7F&rom_mask)-0x4000;
+//		rom_page=rom_base+0x4000*(dat&0x3f)-0x4000;
 		break;
 	case 2:
 		if (dat<8){
-			sram_page=ref_gb->get_rom()->get_sram()+0x2000*(dat&3);
+			sram_page=sram_base+0x2000*(dat&3);
 			ext_is_ram=false;
 		}
 		else
@@ -661,11 +651,11 @@ void mbc::huc1_write(word adr,byte dat)
 			break;
 		case 1:
 			huc1_dat=(huc1_dat&0x60)+(dat&0x3F);
-			rom_page=ref_gb->get_rom()->get_rom()+0x4000*((huc1_dat==0?1:huc1_dat)&(rom_size_tbl[ref_gb->get_rom()->get_info()->rom_size]-1))-0x4000;
+			rom_page=rom_base+0x4000*((huc1_dat==0?1:huc1_dat)&rom_mask)-0x4000;
 			break;
 		case 2:
 			huc1_dat=((dat<<5)&0x60)+(huc1_dat&0x3F);
-			rom_page=ref_gb->get_rom()->get_rom()+0x4000*((huc1_dat==0?1:huc1_dat)&(rom_size_tbl[ref_gb->get_rom()->get_info()->rom_size]-1))-0x4000;
+			rom_page=rom_base+0x4000*((huc1_dat==0?1:huc1_dat)&rom_mask)-0x4000;
 			break;
 		case 3:
 			if (dat&1)
@@ -681,10 +671,10 @@ void mbc::huc1_write(word adr,byte dat)
 		case 0:
 			break;
 		case 1:
-			rom_page=ref_gb->get_rom()->get_rom()+0x4000*((dat==0?1:dat)&0x3F&(rom_size_tbl[ref_gb->get_rom()->get_info()->rom_size]-1))-0x4000;
+			rom_page=rom_base+0x4000*((dat==0?1:dat)&0x3F&rom_mask)-0x4000;
 			break;
 		case 2:
-			sram_page=ref_gb->get_rom()->get_sram()+0x2000*(dat&3);
+			sram_page=sram_base+0x2000*(dat&3);
 			break;
 		case 3:
 			if (dat&1)
@@ -717,6 +707,7 @@ byte mbc::huc3_read(word adr)
 				huc_ir_last_received_light = !ref_gb->received_ir_signals[0]->light_on;
 
 				ref_gb->get_cpu()->next_ir_clock = ref_gb->get_cpu()->get_clock() + ref_gb->received_ir_signals[0]->duration;
+				delete ref_gb->received_ir_signals[0];
 				ref_gb->received_ir_signals.erase(ref_gb->received_ir_signals.begin());
 
 				return (0xC0 | (byte)huc_ir_last_received_light);
@@ -746,11 +737,11 @@ void mbc::huc3_write(word adr,byte dat)
 	}
 	
 	case 1:
-		rom_page=ref_gb->get_rom()->get_rom()+0x4000*((dat==0?1:dat)&0x7F&(rom_size_tbl[ref_gb->get_rom()->get_info()->rom_size]-1))-0x4000;
+		rom_page=rom_base+0x4000*((dat==0?1:dat)&0x7F&rom_mask)-0x4000;
 		break;
 	case 2:
 		if (dat<8){
-			sram_page=ref_gb->get_rom()->get_sram()+0x2000*(dat&3);
+			sram_page=sram_base+0x2000*(dat&3);
 			ext_is_ram=true;
 		}
 		else{
@@ -800,6 +791,7 @@ void mbc::huc3_write(word adr,byte dat)
 					ref_gb->get_cpu()->out_ir_signal_que[size - 1]->duration = ref_gb->get_cpu()->get_clock() - ref_gb->get_cpu()->out_ir_signal_que[size - 1]->duration;
 					ref_gb->get_cpu()->log_ir_traffic(ref_gb->get_cpu()->out_ir_signal_que[size - 1], false);
 					//ref_gb->send_ir_signal(ref_gb->get_cpu()->out_ir_signal_que[size - 1]);
+					ir_signal::release(ref_gb->get_cpu()->out_ir_signal_que);
 				}
 
 				//add signal to out queu
@@ -917,7 +909,7 @@ void mbc::huc3_copy_Scratch2RTC()
 	unsigned minute = (huc3_writingTime & 0xFFF) % 1440;
 	unsigned day = (huc3_writingTime & 0xFFF000) >> 12;
 
-	huc3_baseTime = std::time(0) - minute * 60 - day * 86400;
+	huc3_baseTime = ref_gb->get_rtc_time() - minute * 60 - day * 86400;
 	huc3_haltTime = huc3_baseTime;
 	
 }
@@ -946,7 +938,7 @@ void mbc::huc3_doLatch()
 {
 	huc3_updateTime();
 
-	uint64_t tmp = (huc3_halted ? huc3_haltTime : std::time(0)) - huc3_baseTime;
+	uint64_t tmp = (huc3_halted ? huc3_haltTime : ref_gb->get_rtc_time()) - huc3_baseTime;
 
 	unsigned minute = (tmp / 60) % 1440;
 	unsigned day = (tmp / 86400) & 0xFFF;
@@ -965,7 +957,7 @@ void mbc::huc3_doLatch()
 						(huc3_rtc_register[HUC3_RTC_DAYS_LO]);
 
 
-	unsigned long tmp = std::time(0) - huc3_baseTime;
+	unsigned long tmp = ref_gb->get_rtc_time() - huc3_baseTime;
 	//unsigned long minute_t = (tmp / 60) % 1440;
 	//unsigned long day_t = (tmp / 86400) & 0xFFF;
 
@@ -1002,7 +994,7 @@ void mbc::huc3_updateTime()
 {
 	unsigned minute = (huc3_writingTime & 0xFFF) % 1440;
 	unsigned day = (huc3_writingTime & 0xFFF000) >> 12;
-	huc3_baseTime = std::time(0) - minute * 60 - day * 86400;
+	huc3_baseTime = ref_gb->get_rtc_time() - minute * 60 - day * 86400;
 	huc3_haltTime = huc3_baseTime;
 
 	/*
@@ -1015,7 +1007,7 @@ void mbc::huc3_updateTime()
 		(huc3_rtc_register[HUC3_RTC_DAYS_LO]);
 
 
-	huc3_baseTime = std::time(0) - minute * 60 - day * 86400;
+	huc3_baseTime = ref_gb->get_rtc_time() - minute * 60 - day * 86400;
 	huc3_haltTime = huc3_baseTime;
 	*/
 }
@@ -1091,33 +1083,46 @@ void mbc::mmm01_write(word adr,byte dat)
 }
 
 
-void mbc::serialize(serializer &s)
+template <bool load> void mbc::transfer_state(mbc_state& st)
 {
 	byte*  rom = ref_gb->get_rom()->get_rom();
 	byte* sram = ref_gb->get_rom()->get_sram();
 
-	int tmp;
+	if (load) {
+		rom_page  =  rom + st.rom_bank*0x4000;
+		sram_page = sram + st.sram_bank*0x2000;
+		set_state(st.state); // the fields below overwrite what it sets
+	} else {
+		st.rom_bank  = ( rom_page- rom)/0x4000;
+		st.sram_bank = (sram_page-sram)/0x2000;
+		st.state     = get_state();
+	}
 
-	tmp = ( rom_page- rom)/0x4000; s_VAR(tmp);  rom_page =  rom + tmp*0x4000;
-	tmp = (sram_page-sram)/0x2000; s_VAR(tmp); sram_page = sram + tmp*0x2000;
+	s_FIELD(ext_is_ram);
 
-	tmp = get_state(); s_VAR(tmp); set_state(tmp);
+	// all of the below were originally not in the save state format.
+	s_FIELD(mbc1_16_8);  s_FIELD(mbc1_dat);
 
-	s_VAR(ext_is_ram);
+	s_FIELD(mbc3_latch); s_FIELD(mbc3_sec);  s_FIELD(mbc3_min); s_FIELD(mbc3_hour);
+	s_FIELD(mbc3_dayl);  s_FIELD(mbc3_dayh); s_FIELD(mbc3_timer);
 
-	// all of the below were originally not in the save state format.
-	s_VAR(mbc1_16_8);  s_VAR(mbc1_dat);
+	s_FIELD(mbc5_dat);
 
-	s_VAR(mbc3_latch); s_VAR(mbc3_sec);  s_VAR(mbc3_min); s_VAR(mbc3_hour);
-	s_VAR(mbc3_dayl);  s_VAR(mbc3_dayh); s_VAR(mbc3_timer);
+	s_FIELD(mbc7_write_enable);
+	s_FIELD(mbc7_idle);  s_FIELD(mbc7_cs);   s_FIELD(mbc7_sk);  s_FIELD(mbc7_op_code);
+	s_FIELD(mbc7_adr);   s_FIELD(mbc7_dat);  s_FIELD(mbc7_ret); s_FIELD(mbc7_state);
+	s_FIELD(mbc7_buf);   s_FIELD(mbc7_count);
 
-	s_VAR(mbc5_dat);
+	s_FIELD(huc1_16_8);  s_FIELD(huc1_dat);
+}
 
-	s_VAR(mbc7_write_enable);
-	s_VAR(mbc7_idle);  s_VAR(mbc7_cs);   s_VAR(mbc7_sk);  s_VAR(mbc7_op_code);
-	s_VAR(mbc7_adr);   s_VAR(mbc7_dat);  s_VAR(mbc7_ret); s_VAR(mbc7_state);
-	s_VAR(mbc7_buf);   s_VAR(mbc7_count);
+template <class S> void mbc::serialize(S& s)
+{
+	bind_handlers();
 
-	s_VAR(huc1_16_8);  s_VAR(huc1_dat);
+	mbc_state st;
+	s_BLOCK(st);
 }
 
+SERIALIZE_INSTANTIATE(mbc);
+
@@ -0,0 +1,388 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Input movie recording and verification playback
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <cores/GB/TGBDual/movie.h>
+#include "../common/linkcable/include/link_master_device.hpp"
+#include "../common/alloc_guard/include/alloc_guard.hpp"
+#include <cinttypes>
+#include <cstring>
+
+#define MOVIE_FLAG_HASH_VIDEO 1
+
+// FNV-1a style over 64-bit words, with a shift so high bits reach the low ones
+static uint64_t hash_words(uint64_t h, const void* data, size_t size)
+{
+	const byte* p = (const byte*)data;
+	for (size_t i = 0; i + 8 <= size; i += 8)
+	{
+		uint64_t w;
+		memcpy(&w, p + i, 8);
+		h = (h ^ w) * 0x100000001b3ULL;
+		h ^= h >> 29;
+	}
+	return h;
+}
+
+template <typename T>
+static void put(std::vector<byte>& out, T v)
+{
+	const byte* p = (const byte*)&v;
+	out.insert(out.end(), p, p + sizeof(T));
+}
+
+template <typename T>
+static bool get(const byte*& p, const byte* end, T& v)
+{
+	if ((size_t)(end - p) < sizeof(T))
+		return false;
+	memcpy(&v, p, sizeof(T));
+	p += sizeof(T);
+	return true;
+}
+
+gb_movie::gb_movie()
+{
+	mode = IDLE;
+	players = frames = cur_frame = 0;
+	first_mismatch = -1;
+	hash_video = true;
+	next_hotkey = 0;
+	hash_log = NULL;
+	// live hotkeys wait here for the next frame, retro_run never grows it
+	pending_hotkeys.reserve(16);
+}
+
+uint64_t gb_movie::hash_instance(gb* g, bool video)
+{
+	uint64_t h = 0xcbf29ce484222325ULL;
+	h = hash_words(h, g->get_cpu()->get_ram(), 0x2000 * 4);
+	if (video)
+		h = hash_words(h, g->get_vframe(), 160 * 144 * sizeof(word));
+	return h;
+}
+
+int gb_movie::read_players(const byte* data, size_t size)
+{
+	const byte* p = data;
+	const byte* end = data + size;
+	char magic[8];
+	uint32_t version, n;
+
+	if (!get(p, end, magic) || memcmp(magic, MOVIE_MAGIC, sizeof(MOVIE_MAGIC)) != 0)
+		return -1;
+	if (!get(p, end, version) || version != MOVIE_VERSION || !get(p, end, n))
+		return -1;
+	return (int)n;
+}
+
+void gb_movie::start_record(const std::vector<gb*>& gbs, I_savestate* link, bool video)
+{
+	stop();
+	v_gb = gbs;
+	players = (int)gbs.size();
+	hash_video = video;
+	hold_deferred();
+
+	anchor.clear();
+	anchor_size.clear();
+	for (int i = 0; i <= players; i++)
+	{
+		size_t size = i < players ? v_gb[i]->get_state_size() : (link ? link->get_state_size() : 0);
+		size_t at = anchor.size();
+		anchor.resize(at + size);
+		if (i < players)
+			v_gb[i]->save_state_mem(&anchor[at]);
+		else if (size)
+			link->save_state_mem(&anchor[at]);
+		anchor_size.push_back((uint32_t)size);
+	}
+
+	pads.clear();
+	hashes.clear();
+	hotkeys.clear();
+	pending_hotkeys.clear();
+	frames = cur_frame = 0;
+	first_mismatch = -1;
+	mode = RECORD;
+}
+
+bool gb_movie::start_playback(const byte* data, size_t size, const std::vector<gb*>& gbs, I_savestate* link)
+{
+	const byte* p = data;
+	const byte* end = data + size;
+	char magic[8];
+	uint32_t version, n, count, flags;
+
+	stop();
+	if (!get(p, end, magic) || memcmp(magic, MOVIE_MAGIC, sizeof(MOVIE_MAGIC)) != 0)
+		return false;
+	if (!get(p, end, version) || version != MOVIE_VERSION)
+		return false;
+	if (!get(p, end, n) || !get(p, end, count) || !get(p, end, flags))
+		return false;
+	if (n != gbs.size())
+		return false;
+
+	// ステートの大きさが合わなければ別の構成で記録されたもの
+	// a state size mismatch means the movie was recorded with a different setup
+	std::vector<uint32_t> sizes(n + 1);
+	size_t total = 0;
+	for (uint32_t i = 0; i <= n; i++)
+	{
+		if (!get(p, end, sizes[i]))
+			return false;
+		size_t expect = i < n ? gbs[i]->get_state_size() : (link ? link->get_state_size() : 0);
+		if (sizes[i] != expect)
+			return false;
+		total += sizes[i];
+	}
+	if ((size_t)(end - p) < total)
+		return false;
+	anchor.assign(p, p + total);
+	p += total;
+
+	uint32_t nkeys;
+	if (!get(p, end, nkeys))
+		return false;
+	hotkeys.resize(nkeys);
+	for (uint32_t i = 0; i < nkeys; i++)
+	{
+		int32_t frame, key;
+		if (!get(p, end, frame) || !get(p, end, key))
+			return false;
+		hotkeys[i].frame = frame;
+		hotkeys[i].key = key;
+	}
+
+	size_t records = (size_t)count * n;
+	if ((size_t)(end - p) < records * (1 + sizeof(uint64_t)))
+		return false;
+	pads.assign(p, p + records);
+	p += records;
+	hashes.resize(records);
+	if (records)
+		memcpy(&hashes[0], p, records * sizeof(uint64_t));
+
+	v_gb = gbs;
+	players = (int)n;
+	frames = (int)count;
+	hash_video = (flags & MOVIE_FLAG_HASH_VIDEO) != 0;
+	anchor_size = sizes;
+	hold_deferred();
+
+	size_t at = 0;
+	for (int i = 0; i < players; i++)
+	{
+		v_gb[i]->restore_state_mem(&anchor[at], anchor_size[i]);
+		at += anchor_size[i];
+	}
+	if (link && anchor_size[players])
+		link->restore_state_mem(&anchor[at]);
+
+	cur_frame = 0;
+	first_mismatch = -1;
+	next_hotkey = 0;
+	mode = PLAYBACK;
+	return true;
+}
+
+void gb_movie::attach(const std::vector<gb*>& gbs)
+{
+	stop();
+	v_gb = gbs;
+	players = (int)gbs.size();
+	frames = cur_frame = 0;
+}
+
+void gb_movie::stop()
+{
+	for (size_t i = 0; i < v_gb.size(); i++)
+		v_gb[i]->release_pad();
+	restore_deferred();
+	mode = IDLE;
+}
+
+// 遅延描画はフレームの途中のラインを後回しにしたり捨てたりするので、映像のハッシュと合わない
+// Deferred mode holds back or drops the lines the vframe hash covers
+void gb_movie::hold_deferred()
+{
+	was_deferred.clear();
+	for (size_t i = 0; i < v_gb.size(); i++)
+	{
+		was_deferred.push_back(v_gb[i]->get_lcd()->get_deferred());
+		if (hash_video)
+			v_gb[i]->get_lcd()->set_deferred(false);
+	}
+}
+
+void gb_movie::restore_deferred()
+{
+	for (size_t i = 0; i < was_deferred.size() && i < v_gb.size(); i++)
+		v_gb[i]->get_lcd()->set_deferred(was_deferred[i]);
+	was_deferred.clear();
+}
+
+void gb_movie::add_hotkey(int key)
+{
+	// 再生中は記録されたものだけ // a playing movie only replays its own
+	if (mode == PLAYBACK && cur_frame < frames)
+		return;
+	if (pending_hotkeys.size() < pending_hotkeys.capacity())
+		pending_hotkeys.push_back(key);
+}
+
+// 記録と同じくフレームの頭で渡す // delivered at the frame start, where playback replays them
+void gb_movie::deliver_hotkeys()
+{
+	for (size_t i = 0; i < pending_hotkeys.size(); i++)
+		if (hotkey_handler)
+			hotkey_handler(pending_hotkeys[i]);
+	pending_hotkeys.clear();
+}
+
+void gb_movie::begin_frame()
+{
+	if (mode == RECORD)
+	{
+		for (size_t i = 0; i < pending_hotkeys.size(); i++)
+		{
+			hotkey_event e = { cur_frame, pending_hotkeys[i] };
+			// 記録は伸び続けるので割り当てを許す // recording grows without bound, it may allocate
+			alloc_guard_exempt exempt;
+			hotkeys.push_back(e);
+		}
+		deliver_hotkeys();
+
+		for (int i = 0; i < players; i++)
+		{
+			int pad = v_gb[i]->get_renderer()->check_pad();
+			v_gb[i]->latch_pad(pad);
+			alloc_guard_exempt exempt;
+			pads.push_back((byte)pad);
+		}
+	}
+	else if (mode == PLAYBACK)
+	{
+		// 終わったらライブ入力に戻す // back to live input once the movie ends
+		if (cur_frame >= frames)
+		{
+			deliver_hotkeys();
+			for (int i = 0; i < players; i++)
+				v_gb[i]->latch_pad(v_gb[i]->get_renderer()->check_pad());
+			return;
+		}
+		for (; next_hotkey < hotkeys.size() && hotkeys[next_hotkey].frame <= cur_frame; next_hotkey++)
+			if (hotkey_handler)
+				hotkey_handler(hotkeys[next_hotkey].key);
+
+		const byte* frame_pads = &pads[(size_t)cur_frame * players];
+		for (int i = 0; i < players; i++)
+			v_gb[i]->latch_pad(frame_pads[i]);
+	}
+	else
+	{
+		// ライブ: フレームの頭で一度だけフロントエンドから読む
+		// live play: each pad is read from the frontend once, at the frame start
+		deliver_hotkeys();
+		for (size_t i = 0; i < v_gb.size(); i++)
+			v_gb[i]->latch_pad(v_gb[i]->get_renderer()->check_pad());
+	}
+}
+
+void gb_movie::end_frame()
+{
+	if (mode == RECORD)
+	{
+		for (int i = 0; i < players; i++)
+		{
+			uint64_t h = hash_instance(v_gb[i], hash_video);
+			alloc_guard_exempt exempt;
+			hashes.push_back(h);
+		}
+		frames = ++cur_frame;
+	}
+	else if (mode == PLAYBACK && cur_frame < frames)
+	{
+		for (int i = 0; i < players; i++)
+		{
+			uint64_t h = hash_instance(v_gb[i], hash_video);
+			if (h != get_hash(cur_frame, i) && first_mismatch < 0)
+				first_mismatch = cur_frame;
+			if (hash_log)
+				fprintf(hash_log, "%d %d %016" PRIx64 "\n", cur_frame, i, h);
+		}
+		cur_frame++;
+	}
+}
+
+void gb_movie::save(std::vector<byte>& out) const
+{
+	out.insert(out.end(), MOVIE_MAGIC, MOVIE_MAGIC + sizeof(MOVIE_MAGIC));
+	put(out, (uint32_t)MOVIE_VERSION);
+	put(out, (uint32_t)players);
+	put(out, (uint32_t)frames);
+	put(out, (uint32_t)(hash_video ? MOVIE_FLAG_HASH_VIDEO : 0));
+	for (size_t i = 0; i < anchor_size.size(); i++)
+		put(out, anchor_size[i]);
+	out.insert(out.end(), anchor.begin(), anchor.end());
+
+	put(out, (uint32_t)hotkeys.size());
+	for (size_t i = 0; i < hotkeys.size(); i++)
+	{
+		put(out, (int32_t)hotkeys[i].frame);
+		put(out, (int32_t)hotkeys[i].key);
+	}
+
+	size_t records = (size_t)frames * players;
+	out.insert(out.end(), pads.begin(), pads.begin() + records);
+	const byte* h = (const byte*)hashes.data();
+	out.insert(out.end(), h, h + records * sizeof(uint64_t));
+}
+
+int gb_movie::play_headless(link_master_device* link, FILE* log)
+{
+	hash_log = log;
+	while (mode == PLAYBACK && cur_frame < frames)
+	{
+		begin_frame();
+		// TGBDualCore::run() と同じ順序 // same order as TGBDualCore::run()
+		for (int line = 0; line < 154; line++)
+		{
+			for (int i = 0; i < players; i++)
+				v_gb[i]->run();
+			if (link)
+				link->process();
+		}
+		end_frame();
+	}
+	hash_log = NULL;
+	stop();
+	return first_mismatch;
+}
+
+byte headless_renderer::get_time(int type)
+{
+	return clock.get(type);
+}
+
+void headless_renderer::set_time(int type, byte dat)
+{
+	clock.set(type, dat);
+}
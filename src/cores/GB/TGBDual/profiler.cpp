@@ -0,0 +1,122 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Sampling profiler for emulated code
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <cores/GB/TGBDual/profiler.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+// .sym のバンク番号はメモリ領域ごとに別なので、ラベルは同じ領域の中でだけ探す
+// .sym bank numbers are per memory area, so a label only covers addresses in its own area
+static int area_of(int adr)
+{
+	if (adr < 0x4000) return 0;
+	if (adr < 0x8000) return 1;
+	if (adr < 0xA000) return 2;
+	if (adr < 0xC000) return 3;
+	if (adr < 0xD000) return 4;
+	if (adr < 0xE000) return 5;
+	if (adr >= 0xFF80) return 6;
+	return 7;
+}
+
+static const char* area_names[] = { "ROM0", "ROMX", "VRAM", "SRAM", "WRAM0", "WRAMX", "HRAM", "IO" };
+
+gb_profiler::gb_profiler(int period)
+{
+	this->period = period > 0 ? period : 1;
+	samples = 0;
+}
+
+bool gb_profiler::load_sym(const char* path)
+{
+	FILE* file = fopen(path, "r");
+	if (!file)
+		return false;
+
+	char line[512];
+	while (fgets(line, sizeof(line), file))
+	{
+		char* p = line;
+		while (*p == ' ' || *p == '\t')
+			p++;
+		if (*p == ';' || *p == '\0' || *p == '\n' || *p == '\r')
+			continue;
+
+		char* end;
+		unsigned long bank = strtoul(p, &end, 16);
+		if (end == p || *end != ':')
+			continue;
+		p = end + 1;
+		unsigned long adr = strtoul(p, &end, 16);
+		if (end == p || adr > 0xffff || bank > 0xffff)
+			continue;
+		p = end;
+		while (*p == ' ' || *p == '\t')
+			p++;
+		size_t len = strcspn(p, " \t\r\n;");
+		if (!len)
+			continue;
+		symbols[((uint32_t)bank << 16) | (uint32_t)adr].assign(p, len);
+	}
+	fclose(file);
+	return true;
+}
+
+std::string gb_profiler::label_for(uint32_t key) const
+{
+	int bank = key >> 16;
+	int adr = key & 0xffff;
+
+	auto it = symbols.upper_bound(key);
+	if (it != symbols.begin())
+	{
+		--it;
+		if ((int)(it->first >> 16) == bank && area_of(it->first & 0xffff) == area_of(adr))
+			return it->second;
+	}
+	char tmp[32];
+	snprintf(tmp, sizeof(tmp), "%s_%02X", area_names[area_of(adr)], bank);
+	return tmp;
+}
+
+bool gb_profiler::write_folded(FILE* out, const char* root) const
+{
+	std::vector<std::pair<uint32_t, uint64_t>> sorted(hist.begin(), hist.end());
+	std::sort(sorted.begin(), sorted.end());
+
+	for (size_t i = 0; i < sorted.size(); i++)
+	{
+		uint32_t key = sorted[i].first;
+		fprintf(out, "%s;%s;%02X:%04X %" PRIu64 "\n", root, label_for(key).c_str(), key >> 16, key & 0xffff, sorted[i].second);
+	}
+	return !ferror(out);
+}
+
+bool gb_profiler::write_folded(const char* path, const char* root) const
+{
+	FILE* file = fopen(path, "w");
+	if (!file)
+		return false;
+	bool ok = write_folded(file, root);
+	return fclose(file) == 0 && ok;
+}
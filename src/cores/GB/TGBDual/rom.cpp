@@ -120,9 +120,11 @@ bool rom::load_rom(byte *buf,int size,byte *ram,int ram_size, bool persistent)
 	return true;
 }
 
-void rom::serialize(serializer &s)
+template <class S> void rom::serialize(S &s)
 {
 	s_VAR(info);
 	s.process(sram, get_sram_size());
 }
 
+SERIALIZE_INSTANTIATE(rom);
+
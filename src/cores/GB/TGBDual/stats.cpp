@@ -0,0 +1,205 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Hot path instrumentation counters
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include <cores/GB/TGBDual/stats.h>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+
+static const char *stat_names[STAT_COUNT]={
+	"instructions","halt_clocks",
+	"read_rom0","read_romx","read_vram","read_sram","read_wram","read_oam","read_io","read_hram",
+	"bank_switches","oam_dma","hdma","serial_bytes","ir_edges",
+	"lines_rendered","lines_skipped",
+	"ns_cpu_exec","ns_lcd_render","ns_apu_render","ns_link_process",
+};
+
+const char *tgb_stats_name(int stat)
+{
+	return (stat>=0&&stat<STAT_COUNT)?stat_names[stat]:"";
+}
+
+#ifdef TGB_STATS
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+// 登録・削除、フレームごとの公開と C API がロックを取る。frame[] は各インスタンスのスレッドだけが書く
+// Registration, the per frame publish and the C API lock; frame[] itself is
+// only written by the instance's own thread.
+static std::mutex registry_lock;
+static std::vector<gb_stats*> registry;
+static void (*log_proc)(const char *line)=NULL;
+static int log_every=0;
+
+gb_stats::gb_stats()
+{
+	memset(frame,0,sizeof(frame));
+	reset();
+	discard_frame=false;
+	id=0;
+}
+
+// under the registry lock, frame[] belongs to the gb's thread
+void gb_stats::reset()
+{
+	memset(last_frame,0,sizeof(last_frame));
+	memset(total,0,sizeof(total));
+	frames=logged_frames=0;
+	discard_frame=true;
+}
+
+// snprintf style: the full length, buf holds what fits
+static size_t format_set(char *buf,size_t size,const uint64_t *v)
+{
+	size_t n=0;
+	for (int i=0;i<STAT_COUNT;i++){
+		int w=snprintf(buf+std::min(n,size),size-std::min(n,size),"%s\"%s\":%" PRIu64,i?",":"{",stat_names[i],v[i]);
+		n+=w>0?w:0;
+	}
+	n+=snprintf(buf+std::min(n,size),size-std::min(n,size),"}");
+	return n;
+}
+
+void gb_stats::end_frame()
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	if (!discard_frame){
+		for (int i=0;i<STAT_COUNT;i++){
+			total[i]+=frame[i];
+			last_frame[i]=frame[i];
+		}
+		frames++;
+	}
+	discard_frame=false;
+	memset(frame,0,sizeof(frame));
+}
+
+void tgb_stats_register(gb_stats *s)
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	s->id=(int)registry.size();
+	registry.push_back(s);
+}
+
+void tgb_stats_unregister(gb_stats *s)
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	registry.erase(std::remove(registry.begin(),registry.end(),s),registry.end());
+	for (size_t i=0;i<registry.size();i++)
+		registry[i]->id=(int)i;
+}
+
+int tgb_stats_instance_count(void)
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	return (int)registry.size();
+}
+
+uint64_t tgb_stats_get(int instance,int stat,int last_frame)
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	if (instance<0||instance>=(int)registry.size()||stat<0||stat>=STAT_COUNT)
+		return 0;
+	return last_frame?registry[instance]->last_frame[stat]:registry[instance]->total[stat];
+}
+
+uint64_t tgb_stats_frames(int instance)
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	if (instance<0||instance>=(int)registry.size())
+		return 0;
+	return registry[instance]->frames;
+}
+
+void tgb_stats_reset(void)
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	for (size_t i=0;i<registry.size();i++)
+		registry[i]->reset();
+}
+
+size_t tgb_stats_dump_json(char *buf,size_t size)
+{
+	if (!buf)
+		size=0;
+	// n は切り詰めない長さ、書き込みは size までで止まる // n is the untruncated length, writes stop at size
+	size_t n=0;
+	auto at=[&]() { return buf+std::min(n,size); };
+	auto left=[&]() { return size-std::min(n,size); };
+	auto add=[&](int w) { n+=w>0?w:0; };
+
+	std::lock_guard<std::mutex> guard(registry_lock);
+	add(snprintf(at(),left(),"{\"instances\":["));
+	for (size_t i=0;i<registry.size();i++){
+		add(snprintf(at(),left(),"%s{\"frames\":%" PRIu64 ",\"frame\":",i?",":"",registry[i]->frames));
+		n+=format_set(at(),left(),registry[i]->last_frame);
+		add(snprintf(at(),left(),",\"total\":"));
+		n+=format_set(at(),left(),registry[i]->total);
+		add(snprintf(at(),left(),"}"));
+	}
+	add(snprintf(at(),left(),"]}"));
+	return n;
+}
+
+void tgb_stats_set_log(void (*log)(const char *line),int every_frames)
+{
+	std::lock_guard<std::mutex> guard(registry_lock);
+	log_proc=log;
+	log_every=every_frames;
+}
+
+// ワーカーから呼ばれる end_frame() ではなくここでフロントエンドに出す
+// logs here, on the frontend thread, rather than from end_frame() on a worker
+void tgb_stats_flush_log(void)
+{
+	char line[64+STAT_COUNT*48];
+	std::lock_guard<std::mutex> guard(registry_lock);
+	if (!log_proc||log_every<=0)
+		return;
+	for (size_t i=0;i<registry.size();i++){
+		gb_stats *st=registry[i];
+		if (st->frames<st->logged_frames+log_every)
+			continue;
+		st->logged_frames=st->frames;
+		int n=snprintf(line,sizeof(line),"[stats] gb%d frame %" PRIu64 " ",st->id,st->frames);
+		format_set(line+n,sizeof(line)-n,st->last_frame);
+		log_proc(line);
+	}
+}
+
+#else
+
+int tgb_stats_instance_count(void) { return 0; }
+uint64_t tgb_stats_get(int,int,int) { return 0; }
+uint64_t tgb_stats_frames(int) { return 0; }
+void tgb_stats_reset(void) {}
+size_t tgb_stats_dump_json(char *buf,size_t size)
+{
+	static const char empty[]="{\"instances\":[]}";
+	if (buf&&size)
+		snprintf(buf,size,"%s",empty);
+	return sizeof(empty)-1;
+}
+void tgb_stats_set_log(void (*)(const char *),int) {}
+void tgb_stats_flush_log(void) {}
+
+#endif
@@ -1,28 +1,71 @@
 ﻿#include <cores/GB/TGBDual/TGBDualCore.hpp>
+#include "common/linkcable/include/link_master_device.hpp"
+#include "common/alloc_guard/include/alloc_guard.hpp"
+#include "libretro/dcgb_hotkey_target.hpp"
+#include <stdlib.h>
+#include <string.h>
+#include <fstream>
+
+extern retro_environment_t environ_cb;
+extern retro_input_state_t input_state_cb;
+extern retro_log_printf_t log_cb;
 
 void TGBDualCore::init() {
 	
-    //create gameboy instances
+    // a second init() must not leave v_gb pointing into the old pool
+    deinit();
+
+    //create gameboy instances, packed together in one pool
+    instancePool.reset(new gb_pool(max_gbs));
     for (byte i = 0; i < max_gbs; i++)
     {
 
         render.push_back(new dmy_renderer(i));
-        v_gb.push_back(new gb(render[i], true, true));
+        v_gb.push_back(instancePool->create(render[i], true, true));
         _serialize_size[i] = 0;
     }
 }
 
 // Deinitialize and clean up the core
-void TGBDualCore::deinit() {};
+void TGBDualCore::deinit() {
+
+    // nothing may keep a gb from the pool once it is gone
+    unloadGame();
+    linkTopology.set_instances(0);
+    linkScheduler.configure(linkTopology, std::vector<gb*>(), NULL);
+    v_gb.clear();
+    for (size_t i = 0; i < render.size(); i++) {
+        delete static_cast<dmy_renderer*>(render[i]);
+    }
+    render.clear();
+    instancePool.reset();
+};
 
 // Load a standard game
 bool TGBDualCore::loadGame(const struct retro_game_info* info)
 {
+    // IR signals come from a free list, fill it now so retro_run never grows it
+    ir_signal::reserve(64 * max_gbs);
+
     //load roms
     for (auto& gb : gameboyInstances) {
         if (!gb->load_rom(rom_data, rom_size, NULL, 0, libretro_supports_persistent_buffer))
             return false;
+        // lines are rasterised at the frame end, or dropped when nobody shows the frame
+        gb->get_lcd()->set_deferred(true);
+    }
+
+    std::vector<gb*> gbs;
+    for (auto& gb : gameboyInstances) {
+        gbs.push_back(gb);
     }
+    movie.attach(gbs);
+    movie.set_hotkey_handler([this](int key) { dispatchHotkey(key); });
+    // after attach(), which would stop a recording started here
+    checkOptions(true);
+
+    rewireLinks();
+    return true;
 
 };
 
@@ -32,6 +75,11 @@ bool TGBDualCore::loadGameSpecial() {};
 // Unload the currently loaded game
 void TGBDualCore::unloadGame() {
 
+    if (movie.get_mode() == gb_movie::RECORD)
+        saveMovie();
+    movie.attach(std::vector<gb*>());
+    asyncIrLinks.clear();
+    // only forgets the instances, they stay in instancePool until deinit()
     gameboyInstances.clear();
     gameboyRenderers.clear();
 
@@ -56,16 +104,195 @@ void TGBDualCore::reset() {
 
 
 
-void TGBDualCore::run() override {
+// Split the instances into independently running groups
+void TGBDualCore::rewireLinks() {
 
-    for (int line = 0; line < 154; line++)
-    {
-        //if (extra_inputpolling_enabled) performExtraInputPoll();
+    // Two instances that are each other's IR target, without a cable between them and
+    // without an IR master device, get an ir_async_link so each end can run on its own
+    // thread. An instance on an IR master device (Full Changer, Pocket Pikachu 2 GS, TV
+    // remote, Ubi Key) keeps it: the device answers its RP reads and runs with the
+    // instance on this thread. connectAsyncIr() replaces whatever IR wiring a pair had.
+    if (asyncIrSkewCycles > 0) {
+        for (size_t a = 0; a < gameboyInstances.size(); a++) {
+            for (size_t b = a + 1; b < gameboyInstances.size(); b++) {
+                gb* ga = gameboyInstances[a];
+                gb* gb_b = gameboyInstances[b];
+                if (ga->get_ir_target() == static_cast<I_ir_target*>(gb_b) &&
+                    gb_b->get_ir_target() == static_cast<I_ir_target*>(ga) &&
+                    ga->get_linked_target() != static_cast<I_linkcable_target*>(gb_b) &&
+                    !ga->get_ir_master_device() && !gb_b->get_ir_master_device())
+                    addAsyncIr((int)a, (int)b, asyncIrSkewCycles);
+            }
+        }
+    }
 
+    std::vector<gb*> gbs;
+    for (auto& gb : gameboyInstances) {
+        if (gb) gbs.push_back(gb);
+    }
+    std::vector<ir_async_link*> irLinks;
+    for (auto& link : asyncIrLinks) {
+        irLinks.push_back(link.get());
+    }
+    linkTopology.set_instances((int)gbs.size());
+    linkScheduler.configure(linkTopology, gbs, master_link, 0, irLinks);
+};
+
+// Replaces any IR wiring of a and b; not added to linkTopology, the scheduler
+// keeps the two ends apart when it has a thread for each
+void TGBDualCore::connectAsyncIr(int a, int b, int max_skew_cycles) {
+
+    if (addAsyncIr(a, b, max_skew_cycles))
+        rewireLinks();
+};
+
+bool TGBDualCore::addAsyncIr(int a, int b, int max_skew_cycles) {
+
+    if (a < 0 || b < 0 || a == b || a >= (int)gameboyInstances.size() || b >= (int)gameboyInstances.size())
+        return false;
+    // an instance has one IR port, drop a link it is already on (no frame runs until rewireLinks)
+    gb* ends[2] = { gameboyInstances[a], gameboyInstances[b] };
+    for (size_t i = asyncIrLinks.size(); i-- > 0;) {
+        ir_async_link* link = asyncIrLinks[i].get();
+        if (link->get_gb(0) == ends[0] || link->get_gb(0) == ends[1] ||
+            link->get_gb(1) == ends[0] || link->get_gb(1) == ends[1])
+            asyncIrLinks.erase(asyncIrLinks.begin() + i);
+    }
+    asyncIrLinks.emplace_back(new ir_async_link(gameboyInstances[a], gameboyInstances[b], max_skew_cycles));
+    return true;
+};
+
+// stats lines reach the frontend log from tgb_stats_flush_log(), on this thread
+static void logStatsLine(const char* line) {
+
+    if (log_cb)
+        log_cb(RETRO_LOG_INFO, "%s\n", line);
+};
+
+void TGBDualCore::checkOptions(bool loading) {
+
+    struct retro_variable var = { 0 };
+
+    // the RTC mode changes the savestate size, so it only applies at load
+    if (loading) {
+        var.key = "dcgb_rtc_mode";
+        var.value = NULL;
+        bool emulated = false, host_sync = true;
+        if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value) {
+            emulated = !strcmp(var.value, "emulated") || !strcmp(var.value, "emulated_zero");
+            host_sync = strcmp(var.value, "emulated_zero") != 0;
+        }
         for (auto& gb : gameboyInstances) {
-            if (gb) gb->run();
+            gb->set_rtc_mode(emulated, host_sync);
+        }
+    }
+
+    var.key = "dcgb_stats_log";
+    var.value = NULL;
+    int statsEvery = 0;
+    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value)
+        statsEvery = atoi(var.value);
+    tgb_stats_set_log(statsEvery > 0 ? logStatsLine : NULL, statsEvery);
+
+    var.key = "dcgb_movie_record";
+    var.value = NULL;
+    bool record = environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE, &var) && var.value && !strcmp(var.value, "enabled");
+    if (record != (movie.get_mode() == gb_movie::RECORD)) {
+        // the user switched it, the anchor and the file are one-off allocations
+        alloc_guard_exempt exempt;
+        if (record) {
+            std::vector<gb*> gbs;
+            for (auto& gb : gameboyInstances) {
+                gbs.push_back(gb);
+            }
+            movie.start_record(gbs, master_link);
+        }
+        else {
+            saveMovie();
         }
-        if (master_link)
-            master_link->process();
     }
 };
+
+void TGBDualCore::saveMovie() {
+
+    std::vector<byte> data;
+    movie.save(data);
+    std::vector<gb*> gbs;
+    for (auto& gb : gameboyInstances) {
+        gbs.push_back(gb);
+    }
+    movie.attach(gbs);
+
+    const char* dir = NULL;
+    if (gameboyInstances.empty() || !environ_cb(RETRO_ENVIRONMENT_GET_SAVE_DIRECTORY, &dir) || !dir)
+        return;
+    std::string path = std::string(dir) + "/" + gameboyInstances[0]->get_rom()->get_info()->cart_name + ".dcgbmov";
+    std::ofstream ofs(path.c_str(), std::ios::binary);
+    if (!ofs.write((const char*)data.data(), data.size()) && log_cb)
+        log_cb(RETRO_LOG_ERROR, "cannot write movie %s\n", path.c_str());
+};
+
+void TGBDualCore::pressHotkey(int key) {
+
+    movie.add_hotkey(key);
+};
+
+// L on port 1 steps the link device to its next item, like SELECT on the device menus
+void TGBDualCore::pollHotkeys() {
+
+    bool held = input_state_cb(0, RETRO_DEVICE_JOYPAD, 0, RETRO_DEVICE_ID_JOYPAD_L) != 0;
+    if (held && !hotkeyHeld)
+        pressHotkey(0x10);
+    hotkeyHeld = held;
+};
+
+// every device once, whether it hangs on a cable, an IR port or is the link master
+void TGBDualCore::dispatchHotkey(int key) {
+
+    I_dcgb_hotkey_target* targets[2 * 16 + 1];
+    int count = 0;
+    auto add = [&](I_dcgb_hotkey_target* target) {
+        if (!target)
+            return;
+        for (int i = 0; i < count; i++) {
+            if (targets[i] == target)
+                return;
+        }
+        targets[count++] = target;
+    };
+    for (auto& gb : gameboyInstances) {
+        add(dynamic_cast<I_dcgb_hotkey_target*>(gb->get_linked_target()));
+        add(dynamic_cast<I_dcgb_hotkey_target*>(gb->get_ir_master_device()));
+    }
+    add(dynamic_cast<I_dcgb_hotkey_target*>(master_link));
+    for (int i = 0; i < count; i++) {
+        targets[i]->handle_special_hotkey(key);
+    }
+};
+
+void TGBDualCore::run() override {
+
+    bool updated = false;
+    if (environ_cb(RETRO_ENVIRONMENT_GET_VARIABLE_UPDATE, &updated) && updated)
+        checkOptions(false);
+
+    // run-ahead: a frame the frontend hides is not rasterised
+    dmy_renderer::begin_frame();
+    for (auto& gb : gameboyInstances) {
+        gb->update_frame_wanted();
+    }
+    pollHotkeys();
+
+    movie.begin_frame();
+
+    //if (extra_inputpolling_enabled) performExtraInputPoll();
+    linkScheduler.run_frame();
+
+    // audio and video reach the frontend from this thread, in instance order
+    for (auto& gb : gameboyInstances) {
+        gb->get_renderer()->flush_output();
+    }
+
+    movie.end_frame();
+    tgb_stats_flush_log();
+};
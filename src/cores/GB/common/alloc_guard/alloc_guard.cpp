@@ -0,0 +1,94 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Allocation guard for the frame loop
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "include/alloc_guard.hpp"
+
+#ifdef DCGB_ALLOC_GUARD
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// armed > 0 while a guard is alive and no exemption is, per thread so the
+// batch runner and the frontend's own threads are never counted
+static thread_local int armed = 0;
+static thread_local int exempt = 0;
+static thread_local unsigned long allocations = 0;
+
+static void* counted_alloc(size_t size)
+{
+	if (armed && !exempt)
+		allocations++;
+	return malloc(size ? size : 1);
+}
+
+alloc_guard::alloc_guard(const char* where)
+{
+	this->where = where;
+	start = allocations;
+	armed++;
+}
+
+alloc_guard::~alloc_guard()
+{
+	armed--;
+	unsigned long count = allocations - start;
+	if (count)
+	{
+		fprintf(stderr, "alloc_guard: %lu heap allocation(s) in %s\n", count, where);
+		abort();
+	}
+}
+
+alloc_guard_exempt::alloc_guard_exempt() { exempt++; }
+alloc_guard_exempt::~alloc_guard_exempt() { exempt--; }
+
+// aligned new/delete are left to the runtime, they never pair with these
+void* operator new(size_t size)
+{
+	void* p = counted_alloc(size);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+	return counted_alloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+	return counted_alloc(size);
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete[](void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+void operator delete[](void* p, size_t) noexcept { free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { free(p); }
+
+#endif
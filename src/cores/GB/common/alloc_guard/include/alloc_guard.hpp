@@ -0,0 +1,76 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Allocation guard for the frame loop
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#pragma once
+
+// Everything a session needs is allocated in loadGame (the gb_pool arenas,
+// the ir_signal free list, reserved device buffers), so retro_run should never
+// reach the heap. With -DDCGB_ALLOC_GUARD the global operator new counts calls
+// made on the current thread while an alloc_guard is alive, and the guard
+// aborts with the count when it goes out of scope.
+// The count is per thread, so link_scheduler workers open their own guard
+// around every frame they run.
+// Without the flag both classes are empty and cost nothing.
+//
+// alloc_guard_exempt pauses the count for paths that are allowed to allocate:
+// frontend messages (display_message takes a std::string), printing a page,
+// movie recording.
+
+#ifdef DCGB_ALLOC_GUARD
+
+class alloc_guard
+{
+public:
+	alloc_guard(const char* where);
+	~alloc_guard();
+
+	alloc_guard(const alloc_guard&) = delete;
+	alloc_guard& operator=(const alloc_guard&) = delete;
+
+private:
+	const char* where;
+	unsigned long start;
+};
+
+class alloc_guard_exempt
+{
+public:
+	alloc_guard_exempt();
+	~alloc_guard_exempt();
+
+	alloc_guard_exempt(const alloc_guard_exempt&) = delete;
+	alloc_guard_exempt& operator=(const alloc_guard_exempt&) = delete;
+};
+
+#else
+
+class alloc_guard
+{
+public:
+	alloc_guard(const char*) {}
+};
+
+class alloc_guard_exempt
+{
+public:
+	alloc_guard_exempt() {}
+};
+
+#endif
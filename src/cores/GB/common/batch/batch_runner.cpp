@@ -0,0 +1,307 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Headless batch runner
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "include/batch_runner.hpp"
+#include "../linkcable/include/link_master_device.hpp"
+#include "../capture/include/frame_capture.hpp"
+#include "../../libretro/dcgb_hotkey_target.hpp"
+#include <cores/GB/TGBDual/movie.h>
+#include <cores/GB/TGBDual/profiler.h>
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <thread>
+
+static bool read_file(const std::string& path, std::vector<byte>& out)
+{
+	std::ifstream ifs(path.c_str(), std::ios::binary);
+	if (!ifs)
+		return false;
+	out.assign(std::istreambuf_iterator<char>(ifs), std::istreambuf_iterator<char>());
+	return !out.empty();
+}
+
+static void bgr555_to_rgb888(const word* src, std::vector<uint8_t>& dst)
+{
+	dst.resize(160 * 144 * 3);
+	for (int i = 0; i < 160 * 144; i++)
+	{
+		word c = src[i];
+		dst[i * 3 + 0] = (uint8_t)(((c & 0x1f) * 255) / 31);
+		dst[i * 3 + 1] = (uint8_t)((((c >> 5) & 0x1f) * 255) / 31);
+		dst[i * 3 + 2] = (uint8_t)((((c >> 10) & 0x1f) * 255) / 31);
+	}
+}
+
+void run_tgbdual_job(const batch_job& job, const std::vector<byte>& rom, batch_result& result)
+{
+	std::vector<byte> movie;
+	int players = 1;
+	if (!job.movie_path.empty())
+	{
+		if (!read_file(job.movie_path, movie) || (players = gb_movie::read_players(movie.data(), movie.size())) <= 0)
+		{
+			result.error = "not a movie: " + job.movie_path;
+			return;
+		}
+	}
+
+	// ジョブごとに gb とレンダラを持つので、スレッド間で共有する状態はない
+	// every job owns its gbs and renderers, nothing is shared between threads
+	std::vector<std::unique_ptr<headless_renderer>> renderers;
+	gb_pool pool(players);
+	std::vector<gb*> gbs;
+	// 自由実行では最後のフレームだけ描く (スクリーンショット用)。キャプチャは gb が自分で描かせる
+	// free runs only rasterise the final frame for the screenshot; a capture keeps every frame wanted
+	bool render_all = !movie.empty();
+	for (int i = 0; i < players; i++)
+	{
+		renderers.emplace_back(new headless_renderer(render_all));
+		gbs.push_back(pool.create(renderers[i].get(), true, true));
+		if (!gbs[i]->load_rom((byte*)rom.data(), (int)rom.size(), NULL, 0, false))
+		{
+			result.error = "rom not supported";
+			return;
+		}
+		gbs[i]->set_rtc_mode(true, false);
+		gbs[i]->get_lcd()->set_deferred(true);
+	}
+
+	if (!job.profile_path.empty())
+		gbs[0]->set_profiler(job.profile_period);
+
+	// headless_renderer の map_color は素通しなので vframe は GBC の BGR555 のまま
+	// headless_renderer maps colours 1:1, so vframe holds plain GBC BGR555
+	frame_capture capture;
+	if (!job.capture_path.empty())
+	{
+		if (!capture.open(job.capture_path.c_str(), job.capture_every))
+		{
+			result.error = "cannot create " + job.capture_path;
+			return;
+		}
+		for (int i = 0; i < players; i++)
+			gbs[i]->set_capture(&capture, i, CAPTURE_BGR555);
+	}
+
+	std::unique_ptr<link_master_device> link;
+	if (job.make_link)
+		link.reset(job.make_link(gbs));
+	// 記録も再生も同じ経路でホットキーを渡す // recorded and replayed hotkeys take the same path
+	I_dcgb_hotkey_target* hotkey_target = dynamic_cast<I_dcgb_hotkey_target*>(link.get());
+	auto apply_hotkey = [hotkey_target](int key) {
+		if (hotkey_target)
+			hotkey_target->handle_special_hotkey(key);
+	};
+
+	auto start = std::chrono::steady_clock::now();
+	if (!movie.empty())
+	{
+		gb_movie m;
+		m.set_hotkey_handler(apply_hotkey);
+		if (!m.start_playback(movie.data(), movie.size(), gbs, link.get()))
+		{
+			result.error = "movie does not match this setup";
+			return;
+		}
+		result.frames = m.get_frames();
+		result.movie_mismatch = m.play_headless(link.get());
+	}
+	else
+	{
+		gb_movie rec;
+		rec.set_hotkey_handler(apply_hotkey);
+		if (!job.record_path.empty())
+			rec.start_record(gbs, link.get());
+		else
+			rec.attach(gbs);
+		size_t next_hotkey = 0;
+		for (int frame = 0; frame < job.frames; frame++)
+		{
+			// フレームの切れ目は 154 回の run() の途中にあるので 1 回前から描く
+			// the frame boundary falls somewhere inside the 154 runs, so start one pass early
+			if (frame == std::max(job.frames - 2, 0))
+			{
+				for (int i = 0; i < players; i++)
+				{
+					renderers[i]->set_render_lcd(true);
+					gbs[i]->update_frame_wanted();
+				}
+			}
+			for (; next_hotkey < job.hotkeys.size() && job.hotkeys[next_hotkey].first <= frame; next_hotkey++)
+				rec.add_hotkey(job.hotkeys[next_hotkey].second);
+			rec.begin_frame();
+			for (int line = 0; line < 154; line++)
+			{
+				for (int i = 0; i < players; i++)
+					gbs[i]->run();
+				if (link)
+					link->process();
+			}
+			rec.end_frame();
+		}
+		result.frames = job.frames;
+		if (!job.record_path.empty())
+		{
+			std::vector<byte> out;
+			rec.save(out);
+			std::ofstream ofs(job.record_path.c_str(), std::ios::binary);
+			if (!ofs.write((const char*)out.data(), out.size()))
+				result.error = "cannot write " + job.record_path;
+		}
+		rec.stop();
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	capture.close();
+	result.frames_captured = capture.get_written();
+	result.frames_dropped = capture.get_dropped();
+	bgr555_to_rgb888(gbs[0]->get_vframe(), result.screenshot);
+	result.ok = result.movie_mismatch < 0 && result.error.empty();
+	if (result.movie_mismatch >= 0)
+		result.error = "movie desync at frame " + std::to_string(result.movie_mismatch);
+
+	if (gb_profiler* prof = gbs[0]->get_profiler())
+	{
+		if (!job.sym_path.empty() && !prof->load_sym(job.sym_path.c_str()))
+			result.error += (result.error.empty() ? "" : ", ") + std::string("cannot read ") + job.sym_path;
+		if (!prof->write_folded(job.profile_path.c_str(), gbs[0]->get_rom()->get_info()->cart_name))
+		{
+			result.ok = false;
+			result.error += (result.error.empty() ? "" : ", ") + std::string("cannot write ") + job.profile_path;
+		}
+	}
+}
+
+batch_result run_batch_job(const batch_job& job)
+{
+	batch_result result;
+	std::vector<byte> rom;
+	if (!read_file(job.rom_path, rom) || rom.size() < 0x150)
+	{
+		result.error = "cannot read rom: " + job.rom_path;
+		return result;
+	}
+
+	if (job.core == BATCH_GAMBATTE)
+		run_gambatte_job(job, rom, result);
+	else
+		run_tgbdual_job(job, rom, result);
+
+	if (result.seconds > 0.0)
+		result.fps = result.frames / result.seconds;
+	return result;
+}
+
+batch_runner::batch_runner(int threads)
+{
+	thread_count = threads > 0 ? threads : (int)std::thread::hardware_concurrency();
+	if (thread_count <= 0)
+		thread_count = 1;
+}
+
+bool batch_runner::take_job(size_t worker, size_t& job)
+{
+	{
+		std::lock_guard<std::mutex> guard(queues[worker].lock);
+		if (!queues[worker].jobs.empty())
+		{
+			job = queues[worker].jobs.back();
+			queues[worker].jobs.pop_back();
+			return true;
+		}
+	}
+	for (size_t i = 1; i < queues.size(); i++)
+	{
+		work_queue& victim = queues[(worker + i) % queues.size()];
+		std::lock_guard<std::mutex> guard(victim.lock);
+		if (!victim.jobs.empty())
+		{
+			job = victim.jobs.front();
+			victim.jobs.pop_front();
+			return true;
+		}
+	}
+	return false;
+}
+
+std::vector<batch_result> batch_runner::run(const std::vector<batch_job>& jobs)
+{
+	std::vector<batch_result> results(jobs.size());
+	size_t workers = std::min((size_t)thread_count, jobs.size());
+	if (!workers)
+		return results;
+
+	// jobs are only ever removed, so a worker that finds every queue empty is done
+	queues = std::vector<work_queue>(workers);
+	for (size_t i = 0; i < jobs.size(); i++)
+		queues[i % workers].jobs.push_back(i);
+
+	std::vector<std::thread> threads;
+	for (size_t w = 0; w < workers; w++)
+	{
+		threads.emplace_back([this, w, &jobs, &results]() {
+			size_t job;
+			while (take_job(w, job))
+				results[job] = run_batch_job(jobs[job]);
+		});
+	}
+	for (size_t w = 0; w < threads.size(); w++)
+		threads[w].join();
+
+	queues.clear();
+	return results;
+}
+
+bool batch_runner::write_ppm(const batch_result& result, const std::string& path)
+{
+	if (result.screenshot.size() != 160 * 144 * 3)
+		return false;
+	std::ofstream ofs(path.c_str(), std::ios::binary);
+	if (!ofs)
+		return false;
+	ofs << "P6\n160 144\n255\n";
+	ofs.write((const char*)result.screenshot.data(), result.screenshot.size());
+	return (bool)ofs;
+}
+
+void batch_runner::print_report(FILE* out, const std::vector<batch_job>& jobs, const std::vector<batch_result>& results)
+{
+	double total_frames = 0.0, total_seconds = 0.0;
+	int failed = 0;
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		const batch_result& r = results[i];
+		fprintf(out, "%s\t%s\t%d frames\t%.1f fps\t%s\n", r.ok ? "OK" : "FAIL", jobs[i].rom_path.c_str(),
+			r.frames, r.fps, r.error.c_str());
+		if (!jobs[i].capture_path.empty())
+			fprintf(out, "\tcaptured %llu frames to %s, %llu dropped\n", (unsigned long long)r.frames_captured,
+				jobs[i].capture_path.c_str(), (unsigned long long)r.frames_dropped);
+		total_frames += r.frames;
+		total_seconds += r.seconds;
+		if (!r.ok)
+			failed++;
+	}
+	fprintf(out, "%d jobs, %d failed, %.0f frames in %.1f thread seconds\n",
+		(int)results.size(), failed, total_frames, total_seconds);
+}
@@ -0,0 +1,107 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Headless batch runner, libgambatte jobs
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "include/batch_runner.hpp"
+#include "../../libgambatte/include/gambatte.h"
+#include "../capture/include/frame_capture.hpp"
+
+#include <chrono>
+#include <memory>
+
+static void gambatte_to_rgb888(const gambatte::video_pixel_t* src, std::vector<uint8_t>& dst)
+{
+	dst.resize(160 * 144 * 3);
+	for (int i = 0; i < 160 * 144; i++)
+	{
+		uint32_t c = src[i];
+		if (sizeof(gambatte::video_pixel_t) == 2)
+		{
+			dst[i * 3 + 0] = (uint8_t)((((c >> 11) & 0x1f) * 255) / 31);
+			dst[i * 3 + 1] = (uint8_t)((((c >> 5) & 0x3f) * 255) / 63);
+			dst[i * 3 + 2] = (uint8_t)(((c & 0x1f) * 255) / 31);
+		}
+		else
+		{
+			dst[i * 3 + 0] = (uint8_t)(c >> 16);
+			dst[i * 3 + 1] = (uint8_t)(c >> 8);
+			dst[i * 3 + 2] = (uint8_t)c;
+		}
+	}
+}
+
+namespace {
+	class no_input : public gambatte::InputGetter {
+	public:
+		unsigned operator()() { return 0; }
+	};
+}
+
+void run_gambatte_job(const batch_job& job, const std::vector<uint8_t>& rom, batch_result& result)
+{
+	if (!job.movie_path.empty())
+	{
+		result.error = "movies are TGBDual only";
+		return;
+	}
+
+	std::unique_ptr<gambatte::GB> g(new gambatte::GB());
+	no_input input;
+	g->setInputGetter(&input);
+	if (g->load(rom.data(), (unsigned)rom.size()) != 0)
+	{
+		result.error = "rom not supported";
+		return;
+	}
+
+	const std::size_t sound_size = 35112 + 2064;
+	std::vector<gambatte::video_pixel_t> video(160 * 144);
+	std::vector<gambatte::uint_least32_t> sound(sound_size);
+
+	frame_capture capture;
+	if (!job.capture_path.empty() && !capture.open(job.capture_path.c_str(), job.capture_every))
+	{
+		result.error = "cannot create " + job.capture_path;
+		return;
+	}
+	const capture_format format = sizeof(gambatte::video_pixel_t) == 2 ? CAPTURE_RGB565 : CAPTURE_XRGB8888;
+
+	auto start = std::chrono::steady_clock::now();
+	for (int frame = 0; frame < job.frames; frame++)
+	{
+		// runFor() returns early once a frame is done, so keep going until one was drawn
+		long drawn = -1;
+		while (drawn < 0)
+		{
+			unsigned samples = 35112;
+			drawn = g->runFor(video.data(), 160, sound.data(), sound_size, samples);
+		}
+		if (capture.is_open())
+			capture.submit(0, video.data(), 160, 144, 160 * sizeof(gambatte::video_pixel_t), format);
+	}
+	result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	result.frames = job.frames;
+
+	capture.close();
+	result.frames_captured = capture.get_written();
+	result.frames_dropped = capture.get_dropped();
+
+	gambatte_to_rgb888(video.data(), result.screenshot);
+	result.ok = true;
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// no core headers here: TGBDual and libgambatte both define I_linkcable_target,
+// so each core is driven from its own translation unit
+class gb;
+class link_master_device;
+
+// Headless batch runner: every job is an independent emulation (its own gb
+// or gambatte::GB, renderer and buffers) so jobs can run on any thread.
+// Nothing here touches the libretro callbacks or the frontend globals.
+
+enum batch_core
+{
+	BATCH_TGBDUAL,
+	BATCH_GAMBATTE
+};
+
+struct batch_job {
+	std::string rom_path;
+	std::string movie_path;  // TGBDual only: play and verify this movie instead of free running
+	batch_core core = BATCH_TGBDUAL;
+	int frames = 60 * 60;    // ignored for movies, they run to their end
+	// TGBDual only: record the free run (and the link device) as a movie here
+	std::string record_path;
+	// TGBDual only: link-device hotkeys of a free run as (frame, key), sorted by
+	// frame; each is applied at the start of its frame and recorded with it
+	std::vector<std::pair<int, int>> hotkeys;
+	// TGBDual only: write player 1's PC profile here (folded stacks), labels from sym_path if set
+	std::string profile_path;
+	std::string sym_path;
+	int profile_period = 997;
+	// write every player's frames to this capture file (.dcap), one frame in capture_every
+	std::string capture_path;
+	int capture_every = 1;
+	// builds the link device for multi player movies (the gbs are already loaded)
+	std::function<link_master_device*(std::vector<gb*>&)> make_link;
+};
+
+struct batch_result {
+	bool ok = false;
+	std::string error;
+	int frames = 0;
+	double seconds = 0.0;
+	double fps = 0.0;
+	int movie_mismatch = -1;      // first frame that differs from the movie, -1 if none
+	std::vector<uint8_t> screenshot; // 160x144 RGB888 of player 1's last frame
+	uint64_t frames_captured = 0;
+	uint64_t frames_dropped = 0;  // capture queue was full
+};
+
+class batch_runner
+{
+public:
+	// threads <= 0 uses every hardware thread
+	batch_runner(int threads = 0);
+
+	// runs every job and returns the results in job order
+	std::vector<batch_result> run(const std::vector<batch_job>& jobs);
+
+	static bool write_ppm(const batch_result& result, const std::string& path);
+	static void print_report(FILE* out, const std::vector<batch_job>& jobs, const std::vector<batch_result>& results);
+
+private:
+	// one deque per worker: the owner pops from the back, idle workers steal from the front
+	struct work_queue {
+		std::mutex lock;
+		std::deque<size_t> jobs;
+	};
+
+	bool take_job(size_t worker, size_t& job);
+
+	int thread_count;
+	std::vector<work_queue> queues;
+};
+
+batch_result run_batch_job(const batch_job& job);
+
+// per core drivers, rom already read and checked
+void run_tgbdual_job(const batch_job& job, const std::vector<uint8_t>& rom, batch_result& result);
+void run_gambatte_job(const batch_job& job, const std::vector<uint8_t>& rom, batch_result& result);
@@ -0,0 +1,357 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Capture container: mapped writer, reader, PNG/Y4M output
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "include/frame_capture.hpp"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+// ファイルはこの単位で伸ばす // the file grows by this much at a time
+#define CAPTURE_CHUNK (16 * 1024 * 1024)
+
+int capture_bytes_per_pixel(int format)
+{
+	switch (format)
+	{
+	case CAPTURE_RGB565:
+	case CAPTURE_BGR555:
+		return 2;
+	case CAPTURE_XRGB8888:
+		return 4;
+	}
+	return 0;
+}
+
+uint32_t capture_pixel_rgb(int format, const uint8_t* p)
+{
+	uint32_t c;
+	switch (format)
+	{
+	case CAPTURE_RGB565:
+		c = p[0] | (p[1] << 8);
+		return ((((c >> 11) & 0x1f) * 255 / 31) << 16) | ((((c >> 5) & 0x3f) * 255 / 63) << 8) | ((c & 0x1f) * 255 / 31);
+	case CAPTURE_BGR555:
+		c = p[0] | (p[1] << 8);
+		return (((c & 0x1f) * 255 / 31) << 16) | ((((c >> 5) & 0x1f) * 255 / 31) << 8) | (((c >> 10) & 0x1f) * 255 / 31);
+	case CAPTURE_XRGB8888:
+		return (p[0] | (p[1] << 8) | (p[2] << 16)) & 0xffffff;
+	}
+	return 0;
+}
+
+capture_file::capture_file()
+{
+	used = mapped = 0;
+	map = NULL;
+#ifdef _WIN32
+	file = INVALID_HANDLE_VALUE;
+	mapping = NULL;
+#else
+	fd = -1;
+#endif
+}
+
+capture_file::~capture_file()
+{
+	close();
+}
+
+bool capture_file::open(const char* path)
+{
+	close();
+#ifdef _WIN32
+	file = CreateFileA(path, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+#else
+	fd = ::open(path, O_RDWR | O_CREAT | O_TRUNC, 0644);
+	if (fd < 0)
+		return false;
+#endif
+	if (!map_size(CAPTURE_CHUNK))
+	{
+		close();
+		return false;
+	}
+
+	capture_file_header header;
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, CAPTURE_FILE_MAGIC, 8);
+	header.version = 1;
+	header.header_size = sizeof(header);
+	return append(&header, sizeof(header));
+}
+
+void capture_file::unmap()
+{
+	if (!map)
+		return;
+#ifdef _WIN32
+	UnmapViewOfFile(map);
+	CloseHandle(mapping);
+	mapping = NULL;
+#else
+	munmap(map, mapped);
+#endif
+	map = NULL;
+}
+
+bool capture_file::map_size(size_t size)
+{
+	unmap();
+#ifdef _WIN32
+	mapping = CreateFileMappingA(file, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, NULL);
+	if (!mapping)
+		return false;
+	map = (uint8_t*)MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, size);
+	if (!map)
+	{
+		CloseHandle(mapping);
+		mapping = NULL;
+		return false;
+	}
+#else
+	if (ftruncate(fd, (off_t)size) != 0)
+		return false;
+	void* p = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (p == MAP_FAILED)
+		return false;
+	map = (uint8_t*)p;
+#endif
+	mapped = size;
+	return true;
+}
+
+bool capture_file::append(const void* data, size_t size)
+{
+	if (!map)
+		return false;
+	if (used + size > mapped)
+	{
+		size_t want = mapped;
+		while (used + size > want)
+			want += CAPTURE_CHUNK;
+		if (!map_size(want))
+			return false;
+	}
+	memcpy(map + used, data, size);
+	used += size;
+	return true;
+}
+
+void capture_file::close()
+{
+	unmap();
+#ifdef _WIN32
+	if (file != INVALID_HANDLE_VALUE)
+	{
+		// 使っていない末尾を切り詰める // trim the unused tail
+		LARGE_INTEGER end;
+		end.QuadPart = (LONGLONG)used;
+		SetFilePointerEx(file, end, NULL, FILE_BEGIN);
+		SetEndOfFile(file);
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (fd >= 0)
+	{
+		if (ftruncate(fd, (off_t)used) != 0) {}
+		::close(fd);
+		fd = -1;
+	}
+#endif
+	used = mapped = 0;
+}
+
+bool capture_reader::open(const char* path)
+{
+	close();
+	file = fopen(path, "rb");
+	if (!file)
+		return false;
+
+	capture_file_header header;
+	if (fread(&header, sizeof(header), 1, file) != 1 || memcmp(header.magic, CAPTURE_FILE_MAGIC, 8) != 0 ||
+		header.header_size < sizeof(header) || fseek(file, header.header_size, SEEK_SET) != 0)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+bool capture_reader::next(capture_record& record, std::vector<uint8_t>& pixels)
+{
+	if (!file || fread(&record, sizeof(record), 1, file) != 1 || record.magic != CAPTURE_RECORD_MAGIC)
+		return false;
+
+	int bpp = capture_bytes_per_pixel(record.format);
+	if (!bpp || record.size != (uint32_t)record.width * record.height * bpp)
+		return false;
+
+	pixels.resize(record.size);
+	if (fread(pixels.data(), 1, record.size, file) != record.size)
+		return false;
+	return fseek(file, (8 - (record.size & 7)) & 7, SEEK_CUR) == 0;
+}
+
+void capture_reader::close()
+{
+	if (file)
+		fclose(file);
+	file = NULL;
+}
+
+static uint32_t crc32_update(uint32_t crc, const uint8_t* p, size_t n)
+{
+	static uint32_t table[256];
+	if (!table[1])
+	{
+		for (uint32_t i = 0; i < 256; i++)
+		{
+			uint32_t c = i;
+			for (int k = 0; k < 8; k++)
+				c = (c & 1) ? 0xedb88320u ^ (c >> 1) : c >> 1;
+			table[i] = c;
+		}
+	}
+	crc = ~crc;
+	for (size_t i = 0; i < n; i++)
+		crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+	return ~crc;
+}
+
+static void put_be32(std::vector<uint8_t>& out, uint32_t v)
+{
+	out.push_back(v >> 24);
+	out.push_back(v >> 16);
+	out.push_back(v >> 8);
+	out.push_back(v);
+}
+
+static void png_chunk(FILE* out, const char* type, const std::vector<uint8_t>& data)
+{
+	std::vector<uint8_t> buf;
+	put_be32(buf, (uint32_t)data.size());
+	buf.insert(buf.end(), type, type + 4);
+	buf.insert(buf.end(), data.begin(), data.end());
+	put_be32(buf, crc32_update(0, buf.data() + 4, buf.size() - 4));
+	fwrite(buf.data(), 1, buf.size(), out);
+}
+
+bool capture_write_png(const char* path, const capture_record& record, const std::vector<uint8_t>& pixels)
+{
+	int bpp = capture_bytes_per_pixel(record.format);
+	if (!bpp)
+		return false;
+
+	// 各行: フィルタ 0 + RGB // every row: filter type 0, then RGB
+	std::vector<uint8_t> raw;
+	raw.reserve((size_t)record.height * (record.width * 3 + 1));
+	for (int y = 0; y < record.height; y++)
+	{
+		raw.push_back(0);
+		for (int x = 0; x < record.width; x++)
+		{
+			uint32_t c = capture_pixel_rgb(record.format, &pixels[((size_t)y * record.width + x) * bpp]);
+			raw.push_back(c >> 16);
+			raw.push_back(c >> 8);
+			raw.push_back(c);
+		}
+	}
+
+	// zlib stream of stored (uncompressed) deflate blocks
+	std::vector<uint8_t> z;
+	z.push_back(0x78);
+	z.push_back(0x01);
+	uint32_t a = 1, b = 0;
+	for (size_t pos = 0; pos < raw.size() || pos == 0;)
+	{
+		size_t n = raw.size() - pos < 65535 ? raw.size() - pos : 65535;
+		z.push_back(pos + n == raw.size() ? 1 : 0);
+		z.push_back(n & 0xff);
+		z.push_back(n >> 8);
+		z.push_back(~n & 0xff);
+		z.push_back((~n >> 8) & 0xff);
+		for (size_t i = 0; i < n; i++)
+		{
+			a = (a + raw[pos + i]) % 65521;
+			b = (b + a) % 65521;
+		}
+		z.insert(z.end(), raw.begin() + pos, raw.begin() + pos + n);
+		pos += n;
+		if (!n)
+			break;
+	}
+	put_be32(z, (b << 16) | a);
+
+	FILE* out = fopen(path, "wb");
+	if (!out)
+		return false;
+	static const uint8_t signature[8] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1a, '\n' };
+	fwrite(signature, 1, 8, out);
+
+	std::vector<uint8_t> ihdr;
+	put_be32(ihdr, record.width);
+	put_be32(ihdr, record.height);
+	ihdr.push_back(8); // bit depth
+	ihdr.push_back(2); // RGB
+	ihdr.push_back(0);
+	ihdr.push_back(0);
+	ihdr.push_back(0);
+	png_chunk(out, "IHDR", ihdr);
+	png_chunk(out, "IDAT", z);
+	png_chunk(out, "IEND", std::vector<uint8_t>());
+
+	bool ok = !ferror(out);
+	return fclose(out) == 0 && ok;
+}
+
+bool capture_write_y4m(FILE* out, const capture_record& record, const std::vector<uint8_t>& pixels, bool header)
+{
+	int bpp = capture_bytes_per_pixel(record.format);
+	if (!bpp)
+		return false;
+
+	// Game Boy のフレームレート 4194304/70224 Hz // the Game Boy frame rate, 4194304/70224 Hz
+	if (header)
+		fprintf(out, "YUV4MPEG2 W%d H%d F4194304:70224 Ip A1:1 C444\n", record.width, record.height);
+	fputs("FRAME\n", out);
+
+	size_t n = (size_t)record.width * record.height;
+	std::vector<uint8_t> planes(n * 3);
+	for (size_t i = 0; i < n; i++)
+	{
+		uint32_t c = capture_pixel_rgb(record.format, &pixels[i * bpp]);
+		int r = (c >> 16) & 0xff, g = (c >> 8) & 0xff, b = c & 0xff;
+		// BT.601 limited range
+		planes[i] = (uint8_t)(16 + ((66 * r + 129 * g + 25 * b + 128) >> 8));
+		planes[n + i] = (uint8_t)(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+		planes[2 * n + i] = (uint8_t)(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+	}
+	return fwrite(planes.data(), 1, planes.size(), out) == planes.size();
+}
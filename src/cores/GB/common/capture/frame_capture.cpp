@@ -0,0 +1,144 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Headless frame capture
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "include/frame_capture.hpp"
+#include <cstring>
+
+#define CAPTURE_MAX_INSTANCES 64
+
+frame_capture::frame_capture()
+{
+	slot_bytes = 0;
+	head = count = 0;
+	every = 1;
+	running = false;
+	quit = false;
+	written = 0;
+	dropped = 0;
+}
+
+frame_capture::~frame_capture()
+{
+	close();
+}
+
+bool frame_capture::open(const char* path, int every, int queue_frames, size_t max_frame_bytes)
+{
+	close();
+	if (!file.open(path))
+		return false;
+
+	this->every = every > 0 ? every : 1;
+	slot_bytes = max_frame_bytes;
+	slots = std::vector<slot>(queue_frames > 0 ? queue_frames : 1);
+	for (size_t i = 0; i < slots.size(); i++)
+		slots[i].pixels.resize(slot_bytes);
+	frame_counter.assign(CAPTURE_MAX_INSTANCES, 0);
+	head = count = 0;
+	written = 0;
+	dropped = 0;
+	quit = false;
+	running = true;
+	writer = std::thread(&frame_capture::writer_main, this);
+	return true;
+}
+
+void frame_capture::close()
+{
+	if (!running)
+		return;
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		quit = true;
+	}
+	ready.notify_all();
+	writer.join();
+	file.close();
+	slots.clear();
+	running = false;
+}
+
+bool frame_capture::submit(int instance, const void* pixels, int width, int height, int pitch, capture_format format)
+{
+	if (!running || instance < 0 || instance >= CAPTURE_MAX_INSTANCES)
+		return false;
+
+	size_t row = (size_t)width * capture_bytes_per_pixel(format);
+	size_t size = row * height;
+
+	std::unique_lock<std::mutex> guard(lock);
+	uint32_t frame = frame_counter[instance]++;
+	if (frame % every)
+		return false;
+	if (count == slots.size() || size > slot_bytes || !row)
+	{
+		dropped++;
+		return false;
+	}
+
+	// 書き込み待ちのスロットには触らないので、コピー中もロックを持ったままでよい (1 フレーム数十 KB)
+	// a few tens of KB per frame, cheap enough to copy under the lock
+	slot& s = slots[(head + count) % slots.size()];
+	s.record.magic = CAPTURE_RECORD_MAGIC;
+	s.record.instance = (uint16_t)instance;
+	s.record.format = (uint16_t)format;
+	s.record.frame = frame;
+	s.record.width = (uint16_t)width;
+	s.record.height = (uint16_t)height;
+	s.record.size = (uint32_t)size;
+	s.record.reserved = 0;
+	const uint8_t* src = (const uint8_t*)pixels;
+	for (int y = 0; y < height; y++)
+		memcpy(&s.pixels[y * row], src + (size_t)y * pitch, row);
+	count++;
+
+	guard.unlock();
+	ready.notify_one();
+	return true;
+}
+
+void frame_capture::writer_main()
+{
+	static const uint8_t zero[8] = { 0 };
+	std::unique_lock<std::mutex> guard(lock);
+
+	for (;;)
+	{
+		ready.wait(guard, [this]() { return quit || count != 0; });
+		if (count == 0)
+			return;
+
+		// 先頭のスロットは書き終わるまで submit() から見えない // the head slot is not reused until it has been written
+		slot& s = slots[head];
+		guard.unlock();
+
+		bool ok = file.append(&s.record, sizeof(s.record)) &&
+			file.append(s.pixels.data(), s.record.size) &&
+			file.append(zero, (8 - (s.record.size & 7)) & 7);
+
+		guard.lock();
+		head = (head + 1) % slots.size();
+		count--;
+		if (ok)
+			written++;
+		else
+			dropped++;
+	}
+}
@@ -0,0 +1,162 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Headless frame capture
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Capture container (.dcap), little endian, append only:
+//   capture_file_header
+//   capture_record + payload (rows packed, padded to 8 bytes), repeated
+// The writer maps the file in chunks, so the tail after the last record is
+// zero filled until close() trims it; readers stop at the first record whose
+// magic does not match, which also makes a file from a crashed run readable.
+
+#define CAPTURE_FILE_MAGIC "DCGBCAP1"
+#define CAPTURE_RECORD_MAGIC 0x4d415246u // "FRAM"
+
+enum capture_format
+{
+	CAPTURE_RGB565 = 1,   // libretro RGB565 (TGBDual's libretro renderer, gambatte built with VIDEO_RGB565)
+	CAPTURE_BGR555 = 2,   // Game Boy Color native (TGBDual with an identity map_color, e.g. headless_renderer)
+	CAPTURE_XRGB8888 = 3, // gambatte's default video_pixel_t
+};
+
+struct capture_file_header {
+	char magic[8];
+	uint32_t version;
+	uint32_t header_size;
+	uint32_t reserved[4];
+};
+
+struct capture_record {
+	uint32_t magic;
+	uint16_t instance;
+	uint16_t format;
+	uint32_t frame;    // frame number of this instance, counting every submitted frame
+	uint16_t width;
+	uint16_t height;
+	uint32_t size;     // payload bytes without padding
+	uint32_t reserved;
+};
+
+int capture_bytes_per_pixel(int format);
+// one pixel to 0xRRGGBB
+uint32_t capture_pixel_rgb(int format, const uint8_t* p);
+
+// Append-only memory mapped file, used by the writer thread only.
+class capture_file
+{
+public:
+	capture_file();
+	~capture_file();
+
+	bool open(const char* path);
+	bool append(const void* data, size_t size);
+	void close();
+	bool is_open() const { return map != NULL; }
+
+private:
+	bool map_size(size_t size);
+	void unmap();
+
+	size_t used;
+	size_t mapped;
+	uint8_t* map;
+#ifdef _WIN32
+	void* file;
+	void* mapping;
+#else
+	int fd;
+#endif
+};
+
+// Collects frames from any number of instances (and threads) and writes
+// them on a background thread. submit() copies the frame into a preallocated
+// slot; when every slot is waiting for the writer the frame is dropped and
+// counted instead of stalling emulation.
+class frame_capture
+{
+public:
+	frame_capture();
+	~frame_capture();
+
+	// every: keep one frame in 'every' per instance
+	bool open(const char* path, int every = 1, int queue_frames = 32, size_t max_frame_bytes = 160 * 144 * 4);
+	void close();
+	bool is_open() const { return running; }
+
+	// pitch in bytes; returns false if the frame was skipped or dropped
+	bool submit(int instance, const void* pixels, int width, int height, int pitch, capture_format format);
+
+	uint64_t get_written() const { return written; }
+	uint64_t get_dropped() const { return dropped; }
+
+private:
+	struct slot {
+		capture_record record;
+		std::vector<uint8_t> pixels;
+	};
+
+	void writer_main();
+
+	capture_file file;
+	std::vector<slot> slots;
+	size_t slot_bytes;
+	size_t head, count;
+	int every;
+	std::vector<uint32_t> frame_counter;
+
+	std::mutex lock;
+	std::condition_variable ready;
+	std::thread writer;
+	bool running;
+	bool quit;
+	std::atomic<uint64_t> written, dropped;
+};
+
+// Reads a capture back, for the offline converter.
+class capture_reader
+{
+public:
+	capture_reader() { file = NULL; }
+	~capture_reader() { close(); }
+
+	bool open(const char* path);
+	// false at the end of the file or at a damaged record
+	bool next(capture_record& record, std::vector<uint8_t>& pixels);
+	void close();
+
+private:
+	FILE* file;
+};
+
+// one record as an 8 bit RGB PNG (stored deflate blocks, no zlib needed)
+bool capture_write_png(const char* path, const capture_record& record, const std::vector<uint8_t>& pixels);
+// appends one frame to a 4:4:4 Y4M stream, writes the stream header if 'header'
+bool capture_write_y4m(FILE* out, const capture_record& record, const std::vector<uint8_t>& pixels, bool header);
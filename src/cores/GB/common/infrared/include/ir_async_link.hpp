@@ -0,0 +1,71 @@
+#pragma once
+#include <cores/GB/TGBDual/gb.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+// IR link between two instances that may run on different threads.
+//
+// Every light edge is stamped with the scanline of the frame it was sent in
+// and queued for the partner. An RP read on line L waits until the partner
+// has finished line L-1 and then takes the edges stamped before L, so what
+// an instance sees does not depend on how the threads were scheduled.
+// link_scheduler calls line_done() after every line; an instance that gets
+// more than the allowed skew ahead of its partner waits there.
+//
+// Without link_scheduler (set_paced(false), the default) edges are handed
+// over at once, like a plain set_ir_target() pair.
+class ir_async_link
+{
+public:
+	// max_skew_cycles: how far one side may run ahead, rounded up to whole lines (456 clocks, at least one)
+	ir_async_link(gb* a, gb* b, int max_skew_cycles = 456 * 8);
+	~ir_async_link();
+
+	gb* get_gb(int side) const { return ports[side].g; }
+	void set_paced(bool paced) { this->paced = paced; }
+
+	// link_scheduler: before a frame, while no instance runs
+	void begin_frame();
+	// link_scheduler: 'side' finished a line, may block until the partner catches up
+	void line_done(int side);
+
+private:
+	struct stamped_signal {
+		ir_signal* signal;
+		int line;
+	};
+
+	// gb 側から見た相手: 送信先 (I_ir_target) と RP 読み出し時の受信 (process_ir)
+	// what one gb is wired to: its send target (I_ir_target) and its receive hook on RP reads (process_ir)
+	class port : public I_ir_target, public I_ir_master_device
+	{
+	public:
+		void receive_ir_signal(ir_signal* signal) override;
+		void send_ir_signal(ir_signal* signal) override;
+		void process_ir() override;
+		dword* get_rp_que() override { return rp_que; }
+		void reset() override;
+
+		ir_async_link* link;
+		int side;
+		gb* g;
+		dword rp_que[2];
+
+		std::atomic<int> lines; // 今のフレームで終えたライン数 // lines finished in this frame
+		std::vector<stamped_signal> inbox; // 相手から届いた信号、link->lock で守る // edges from the partner, guarded by link->lock
+		std::atomic<int> pending;
+	};
+
+	void wait_for(int side, int lines);
+
+	port ports[2];
+	int skew_lines;
+	bool paced;
+
+	std::mutex lock;
+	std::condition_variable moved;
+	std::atomic<int> waiters;
+};
@@ -0,0 +1,141 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   IR link between instances on different threads
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+
+*/
+
+#include "./include/ir_async_link.hpp"
+
+ir_async_link::ir_async_link(gb* a, gb* b, int max_skew_cycles)
+{
+	skew_lines = (max_skew_cycles + 455) / 456;
+	if (skew_lines < 1)
+		skew_lines = 1;
+	paced = false;
+	waiters = 0;
+
+	gb* gbs[2] = { a, b };
+	for (int i = 0; i < 2; i++)
+	{
+		port& p = ports[i];
+		p.link = this;
+		p.side = i;
+		p.g = gbs[i];
+		p.rp_que[0] = 0x000001cc;
+		p.rp_que[1] = 0;
+		p.lines = 0;
+		p.pending = 0;
+		p.inbox.reserve(0x400);
+
+		p.g->set_ir_target(&p);
+		p.g->set_ir_master_device(&p);
+	}
+}
+
+ir_async_link::~ir_async_link()
+{
+	for (int i = 0; i < 2; i++)
+	{
+		if (ports[i].g->get_ir_target() == &ports[i])
+			ports[i].g->set_ir_target(NULL);
+		if (ports[i].g->get_ir_master_device() == &ports[i])
+			ports[i].g->set_ir_master_device(NULL);
+		ports[i].reset();
+	}
+}
+
+void ir_async_link::begin_frame()
+{
+	// 前のフレームの残りは次の最初の RP 読み出しで受け取る // leftovers of the last frame arrive on the first RP read
+	for (int i = 0; i < 2; i++)
+	{
+		ports[i].lines = 0;
+		for (size_t n = 0; n < ports[i].inbox.size(); n++)
+			ports[i].inbox[n].line = -1;
+	}
+}
+
+void ir_async_link::wait_for(int side, int lines)
+{
+	if (ports[side].lines.load() >= lines)
+		return;
+
+	waiters++;
+	{
+		std::unique_lock<std::mutex> guard(lock);
+		moved.wait(guard, [&]() { return ports[side].lines.load() >= lines; });
+	}
+	waiters--;
+}
+
+void ir_async_link::line_done(int side)
+{
+	int done = ports[side].lines.load(std::memory_order_relaxed) + 1;
+	ports[side].lines.store(done);
+	if (waiters.load())
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		moved.notify_all();
+	}
+
+	wait_for(1 - side, done - skew_lines);
+}
+
+// 自分の gb が光らせた // our gb switched its light
+void ir_async_link::port::receive_ir_signal(ir_signal* signal)
+{
+	port& to = link->ports[1 - side];
+	stamped_signal s = { signal, link->paced ? lines.load(std::memory_order_relaxed) : -1 };
+
+	std::lock_guard<std::mutex> guard(link->lock);
+	to.inbox.push_back(s);
+	to.pending++;
+}
+
+void ir_async_link::port::send_ir_signal(ir_signal* signal)
+{
+	g->receive_ir_signal(signal);
+}
+
+// 自分の gb が RP を読んだ: 相手がこのラインの前まで進んだら、それまでの信号を渡す
+// our gb reads RP: once the partner has finished the lines before ours, hand over what it sent in them
+void ir_async_link::port::process_ir()
+{
+	int now = lines.load(std::memory_order_relaxed);
+	if (link->paced)
+		link->wait_for(1 - side, now);
+
+	if (!pending.load())
+		return;
+
+	std::lock_guard<std::mutex> guard(link->lock);
+	size_t n = 0;
+	while (n < inbox.size() && (!link->paced || inbox[n].line < now))
+		send_ir_signal(inbox[n++].signal);
+	inbox.erase(inbox.begin(), inbox.begin() + n);
+	pending -= (int)n;
+}
+
+void ir_async_link::port::reset()
+{
+	std::lock_guard<std::mutex> guard(link->lock);
+	for (size_t n = 0; n < inbox.size(); n++)
+		delete inbox[n].signal;
+	inbox.clear();
+	pending = 0;
+}
@@ -34,6 +34,8 @@ pikachu_2_gs::pikachu_2_gs(std::vector<gb*> gbs)
 {
 
 	v_gb.insert(v_gb.begin(), std::begin(gbs), std::end(gbs));
+	in_ir_signals.reserve(0x400);
+	out_ir_signals.reserve(0x400);
 	reset();
 }
 
@@ -62,7 +64,7 @@ void pikachu_2_gs::receive_ir_signal(ir_signal* signal)
 
 					}
 
-					in_ir_signals.clear();
+					ir_signal::release(in_ir_signals);
 				}
 				break;
 			}
@@ -135,7 +137,7 @@ void pikachu_2_gs::receive_ir_signal(ir_signal* signal)
 						
 					}
 
-					in_ir_signals.clear();
+					ir_signal::release(in_ir_signals);
 				}
 				break; 
 			}
@@ -145,7 +147,7 @@ void pikachu_2_gs::receive_ir_signal(ir_signal* signal)
 				{
 					current_state = RECEIVE_HELLO;
 					is_master = false; 
-					in_ir_signals.clear();
+					ir_signal::release(in_ir_signals);
 
 					//Build Empty Packets
 					add_preamble_to_out_signals();
@@ -193,7 +195,7 @@ void pikachu_2_gs::receive_ir_signal(ir_signal* signal)
 
 				}
 
-				in_ir_signals.clear();
+				ir_signal::release(in_ir_signals);
 			}
 			break;
 		}
@@ -206,7 +208,7 @@ void pikachu_2_gs::receive_ir_signal(ir_signal* signal)
 				//in_data_length = in_bytes[1];
 				in_data_length = 1;
 				current_state = RECEIVE_DATA;
-				in_ir_signals.clear();
+				ir_signal::release(in_ir_signals);
 			};
 
 			break;
@@ -218,7 +220,7 @@ void pikachu_2_gs::receive_ir_signal(ir_signal* signal)
 			{
 				//translate_signals_to_bytes();
 				current_state = RECEIVE_DATA_CHECKSUM;
-				in_ir_signals.clear();
+				ir_signal::release(in_ir_signals);
 			}
 			break;
 		}
@@ -229,7 +231,7 @@ void pikachu_2_gs::receive_ir_signal(ir_signal* signal)
 			{
 				//translate_signals_to_bytes();
 				current_state = RECEICE_DATA_EMPTY;
-				in_ir_signals.clear();
+				ir_signal::release(in_ir_signals);
 
 				build_ack_msg();
 
@@ -243,7 +245,7 @@ void pikachu_2_gs::receive_ir_signal(ir_signal* signal)
 			{
 				//translate_signals_to_bytes();
 				//current_state = RECEICE_DATA_EMPTY;
-				in_ir_signals.clear();
+				ir_signal::release(in_ir_signals);
 
 				build_ack_msg();
 
@@ -310,7 +312,7 @@ void pikachu_2_gs::check_hello_msg()
 		
 	}
 
-	in_ir_signals.clear();
+	ir_signal::release(in_ir_signals);
 	*/
 }
 
@@ -363,8 +365,8 @@ void pikachu_2_gs::reset()
 	sending_delay = 0;
 	in_data_length = 0;
 	current_state = RECEIVE_HELLO;
-	in_ir_signals.clear();
-	out_ir_signals.clear();
+	ir_signal::release(in_ir_signals);
+	ir_signal::release(out_ir_signals);
 	in_bytes.clear();
 	
 	clock_at_last_sended_signal = 0;
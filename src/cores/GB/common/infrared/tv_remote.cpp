@@ -39,6 +39,7 @@ extern bool auto_random_tv_remote;
 tv_remote::tv_remote(std::vector<gb*> gbs)
 {
 	v_gb.insert(v_gb.begin(), std::begin(gbs), std::end(gbs));
+	out_ir_signals.reserve(0x400);
 	reset();
 
 	build_predefined_remotes();
@@ -86,7 +87,7 @@ void tv_remote::reset()
 void tv_remote::handle_special_hotkey(int key)
 {
 
-	out_ir_signals.clear();
+	ir_signal::release(out_ir_signals);
 
 	//Pressed SELECT
 	if (key == 0x10) 
@@ -237,7 +238,7 @@ void tv_remote::build_predefined_remotes()
 
 void tv_remote::build_signal_frame(byte code)
 {
-	out_ir_signals.clear();
+	ir_signal::release(out_ir_signals);
 	total_transmission_time = 0;
 	v_gb[0]->get_cpu()->next_ir_clock = -2147483648;
 
@@ -35,6 +35,8 @@ ubikey_unlocker::ubikey_unlocker(std::vector<gb*> gbs)
 {
 
 	v_gb.insert(v_gb.begin(), std::begin(gbs), std::end(gbs));
+	in_ir_signals.reserve(0x400);
+	out_ir_signals.reserve(0x400);
 	reset();
 
 	if (is_master) {
@@ -74,12 +76,12 @@ void ubikey_unlocker::receive_ir_signal(ir_signal* signal)
 			{
 				if (got_hello_msg())
 				{
-					out_ir_signals.clear();
+					ir_signal::release(out_ir_signals);
 					build_data_packet();
 
 				}
 
-				in_ir_signals.clear();
+				ir_signal::release(in_ir_signals);
 			}
 			break;
 			
@@ -126,7 +128,7 @@ void ubikey_unlocker::receive_ir_signal(ir_signal* signal)
 
 				}
 
-				in_ir_signals.clear();
+				ir_signal::release(in_ir_signals);
 			}
 			break;
 		}
@@ -160,7 +162,7 @@ void ubikey_unlocker::receive_ir_signal(ir_signal* signal)
 
 				}
 
-				in_ir_signals.clear();
+				ir_signal::release(in_ir_signals);
 			}
 			
 			break;
@@ -218,8 +220,8 @@ void ubikey_unlocker::reset()
 	sending_delay = 0;
 	in_data_length = 0;
 	current_state = UBIKEY_WAIT_FOR_HELLO;
-	in_ir_signals.clear();
-	out_ir_signals.clear();
+	ir_signal::release(in_ir_signals);
+	ir_signal::release(out_ir_signals);
 	in_bytes.clear();
 	is_master = true;
 	log_answer_delay = true;
@@ -315,7 +317,7 @@ void ubikey_unlocker::check_hello_msg()
 
 	}
 
-	in_ir_signals.clear();
+	ir_signal::release(in_ir_signals);
 	*/
 }
 
@@ -25,7 +25,7 @@
 
 extern void display_message(std::string msg_str);
 
-barcodeboy::barcodeboy(std::vector<gb*> g_gb, char cart_name[18]) {
+barcodeboy::barcodeboy(const std::vector<gb*>& g_gb, char cart_name[18]) {
 	
 	memcpy(this->cart_name, cart_name, 18 * sizeof(char));
 	init_barcodes(cart_name);
@@ -30,15 +30,18 @@
 #include <string>
 
 
-dmg07::dmg07(std::vector<gb*> g_gb)  {
+dmg07::dmg07(const std::vector<gb*>& g_gb)  {
 
 	v_gb.insert(v_gb.begin(), std::begin(g_gb), std::end(g_gb));
 
+	// the largest packet is 255 bytes per player, reserving it keeps the link
+	// transfers off the heap
 	for (size_t i = 0; i < 4; i++)
 	{
-		trans_buffer[i] = std::vector<byte>();
-		ans_buffer[i] = std::vector<byte>();
+		trans_buffer[i].reserve(256);
+		ans_buffer[i].reserve(256);
 	}
+	bytes_to_send.reserve(4 * 256);
 	reset();
 }
 
@@ -72,7 +75,7 @@ void dmg07::reset()
 	//ready_to_sync_others = false;
 	//others_are_synced = false;
 
-	bytes_to_send = std::vector<byte>();
+	bytes_to_send.clear();
 
 	for (byte i = 0; i < dmg07::v_gb.size(); i++)
 	{
@@ -138,7 +141,7 @@ void dmg07::restart_pingphase()
 	delay = 0;
 	//ready_to_sync_others = false; 
 
-	bytes_to_send = std::vector<byte>();
+	bytes_to_send.clear();
 
 	for (byte i = 0; i < dmg07::v_gb.size(); i++)
 	{
@@ -334,7 +337,7 @@ void dmg07::handle_answer(int i, byte dat)
 				{
 
 					ans_buffer[i].clear();
-					bytes_to_send = std::vector<byte>();
+					bytes_to_send.clear();
 					restart_in = packet_size * 4;
 
 					for (int i = 0; i < (packet_size * 4); i++)
@@ -605,15 +608,15 @@ size_t dmg07::get_state_size(void)
 	{
 		size = trans_buffer[i].size();
 		s_VAR(size);
-		s_ARRAY(trans_buffer[i].data());
+		s.process(trans_buffer[i].data(), size);
 		size = ans_buffer[i].size();
 		s_VAR(size);
-		s_ARRAY(ans_buffer[i].data());
+		s.process(ans_buffer[i].data(), size);
 	}
 
 	size = bytes_to_send.size();
 	s_VAR(size);
-	s_ARRAY(bytes_to_send.data());
+	s.process(bytes_to_send.data(), size);
 
 
 	serialize(s);
@@ -630,68 +633,40 @@ void dmg07::save_state_mem(void* buf)
 	{
 		size = trans_buffer[i].size();
 		s_VAR(size);
-		if(size) s_ARRAY(trans_buffer[i].data());
+		s.process(trans_buffer[i].data(), size);
 		size = ans_buffer[i].size();
 		s_VAR(size);
-		if (size) s_ARRAY(ans_buffer[i].data());
+		s.process(ans_buffer[i].data(), size);
 	}
 	size = bytes_to_send.size();
 	s_VAR(size);
-	if (size) s_ARRAY(bytes_to_send.data());
+	s.process(bytes_to_send.data(), size);
 
 	serialize(s);
 }
 
+// the buffers are read in place, within the capacity reserved by the constructor
 void dmg07::restore_state_mem(void* buf)
 {
 	serializer s(buf, serializer::LOAD_BUF);
 
 	int size;
-	byte* tmp;
 	
 	for (int i = 0; i < 4; i++)
 	{
-		trans_buffer[i] = std::vector<byte>();
-		ans_buffer[i] = std::vector<byte>();
-
 		s_VAR(size);
-		if (size) {
-			tmp = new byte[size];
-			s_ARRAY(tmp);
-
-			for (int j = 0; j < size; j++)
-			{
-				trans_buffer[i].push_back(tmp[j]);
-			}
-		}
+		trans_buffer[i].resize(size);
+		s.process(trans_buffer[i].data(), size);
 		
 		s_VAR(size);
-		if (size) {
-			tmp = new byte[size];
-			s_ARRAY(tmp);
-
-
-			for (int k = 0; k < size; k++)
-			{
-				ans_buffer[i].push_back(tmp[k]);
-			};
-		}
-	
+		ans_buffer[i].resize(size);
+		s.process(ans_buffer[i].data(), size);
 	}
 
-	bytes_to_send = std::vector<byte>();
 	s_VAR(size);
-	if (size) {
-		tmp = new byte[size];
-		s_ARRAY(tmp);
-
-		for (size_t i = 0; i < size; i++)
-		{
-			bytes_to_send.push_back(tmp[i]);
-		};
-	}
+	bytes_to_send.resize(size);
+	s.process(bytes_to_send.data(), size);
 	
-	//delete tmp; 
 	serialize(s);
 }
 
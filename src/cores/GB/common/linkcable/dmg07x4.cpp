@@ -24,214 +24,19 @@
 #include "./include/dmg07x4.hpp"
 
 
-dmg07x4::dmg07x4(std::vector<gb*> v_gb, int players) {
+dmg07x4::dmg07x4(const std::vector<gb*>& v_gb, int players) {
 
-	switch (players) {
-	case 1:
-	case 2:
-	case 3:
-	case 4:
-	case 5: 
-	{
-		
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 3);
-		v_dmg07.push_back(new dmg07(_gbs1));
-
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 3, std::begin(v_gb) + 5);
-		v_dmg07.push_back(new dmg07(_gbs2));
-		break;
-	}
-		  
-	case 6:
-	{
-	
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 3);
-		v_dmg07.push_back(new dmg07(_gbs1));
-
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 3, std::begin(v_gb) + 6);
-		v_dmg07.push_back(new dmg07(_gbs2));
-		break;
-	}
-	
-	case 7:
-	{
-		//emulated_dmg07s = 2;
-
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 4);
-		v_dmg07.push_back(new dmg07(_gbs1));
-
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 4, std::begin(v_gb) + 7);
-		v_dmg07.push_back(new dmg07(_gbs2));
-		break;
-	}
-	case 8: {
-		//emulated_dmg07s = 2;
-
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 4);
-		v_dmg07.push_back(new dmg07(_gbs1));
-
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 4, std::begin(v_gb) + 8);
-		v_dmg07.push_back(new dmg07(_gbs2));
-		break;
-	}
-	
-	case 9: {
-	//	emulated_dmg07s = 3;
-
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 3);
-		v_dmg07.push_back(new dmg07(_gbs1));
-
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 3, std::begin(v_gb) + 6);
-		v_dmg07.push_back(new dmg07(_gbs2));
-
-		std::vector<gb*> _gbs3;
-		_gbs3.insert(_gbs3.begin(), std::begin(v_gb) + 6, std::begin(v_gb) + 9);
-		v_dmg07.push_back(new dmg07(_gbs3));
-		break;
-	}
-	case 10:{
-		//emulated_dmg07s = 3;
-
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 4);
-		v_dmg07.push_back(new dmg07(_gbs1));
-
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 4, std::begin(v_gb) + 7);
-		v_dmg07.push_back(new dmg07(_gbs2));
-
-		std::vector<gb*> _gbs3;
-		_gbs3.insert(_gbs3.begin(), std::begin(v_gb) + 7, std::begin(v_gb) + 10);
-		v_dmg07.push_back(new dmg07(_gbs3));
-		break;
-	}
-	case 11: {
-		//emulated_dmg07s = 3;
-
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 4);
-		v_dmg07.push_back(new dmg07(_gbs1));
+	std::vector<std::vector<int>> groups = link_topology::dmg07_groups(players);
 
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 4, std::begin(v_gb) + 8);
-		v_dmg07.push_back(new dmg07(_gbs2));
-
-		std::vector<gb*> _gbs3;
-		_gbs3.insert(_gbs3.begin(), std::begin(v_gb) + 8, std::begin(v_gb) + 11);
-		v_dmg07.push_back(new dmg07(_gbs3));
-		break;
-	}
-	case 12:
+	for (size_t h = 0; h < groups.size(); h++)
 	{
-		//emulated_dmg07s = 3;
-
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 4);
-		v_dmg07.push_back(new dmg07(_gbs1));
-
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 4, std::begin(v_gb) + 8);
-		v_dmg07.push_back(new dmg07(_gbs2));
-
-		std::vector<gb*> _gbs3;
-		_gbs3.insert(_gbs3.begin(), std::begin(v_gb) + 8, std::begin(v_gb) + 12);
-		v_dmg07.push_back(new dmg07(_gbs3));
-		break;
-	}
-	case 13:
-	{
-		//emulated_dmg07s = 4;
-
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 4);
-		v_dmg07.push_back(new dmg07(_gbs1));
-
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 4, std::begin(v_gb) + 7);
-		v_dmg07.push_back(new dmg07(_gbs2));
-
-		std::vector<gb*> _gbs3;
-		_gbs3.insert(_gbs3.begin(), std::begin(v_gb) + 7, std::begin(v_gb) + 10);
-		v_dmg07.push_back(new dmg07(_gbs3));
-
-		std::vector<gb*> _gbs4;
-		_gbs4.insert(_gbs4.begin(), std::begin(v_gb) + 10, std::begin(v_gb) + 13);
-		v_dmg07.push_back(new dmg07(_gbs4));
-		break;
-	}
-	case 14:
-	{
-		//emulated_dmg07s = 4;
-
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 4);
-		v_dmg07.push_back(new dmg07(_gbs1));
-
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 4, std::begin(v_gb) + 8);
-		v_dmg07.push_back(new dmg07(_gbs2));
-
-		std::vector<gb*> _gbs3;
-		_gbs3.insert(_gbs3.begin(), std::begin(v_gb) + 8, std::begin(v_gb) + 11);
-		v_dmg07.push_back(new dmg07(_gbs3));
-
-		std::vector<gb*> _gbs4;
-		_gbs4.insert(_gbs4.begin(), std::begin(v_gb) + 11, std::begin(v_gb) + 14);
-		v_dmg07.push_back(new dmg07(_gbs4));
-		break;
-	}
-	case 15:
-	{
-		//emulated_dmg07s = 4;
-
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 4);
-		v_dmg07.push_back(new dmg07(_gbs1));
-
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 4, std::begin(v_gb) + 8);
-		v_dmg07.push_back(new dmg07(_gbs2));
-
-		std::vector<gb*> _gbs3;
-		_gbs3.insert(_gbs3.begin(), std::begin(v_gb) + 8, std::begin(v_gb) + 12);
-		v_dmg07.push_back(new dmg07(_gbs3));
-
-		std::vector<gb*> _gbs4;
-		_gbs4.insert(_gbs4.begin(), std::begin(v_gb) + 12, std::begin(v_gb) + 15);
-		v_dmg07.push_back(new dmg07(_gbs4));
-		break;
-	}
-	case 16:
-	{
-
-		std::vector<gb*> _gbs1;
-		_gbs1.insert(_gbs1.begin(), std::begin(v_gb), std::begin(v_gb) + 4);
-		v_dmg07.push_back(new dmg07(_gbs1));
-
-		std::vector<gb*> _gbs2;
-		_gbs2.insert(_gbs2.begin(), std::begin(v_gb) + 4, std::begin(v_gb) + 8);
-		v_dmg07.push_back(new dmg07(_gbs2));
-
-		std::vector<gb*> _gbs3;
-		_gbs3.insert(_gbs3.begin(), std::begin(v_gb) + 8, std::begin(v_gb) + 12);
-		v_dmg07.push_back(new dmg07(_gbs3));
-
-		std::vector<gb*> _gbs4;
-		_gbs4.insert(_gbs4.begin(), std::begin(v_gb) + 12, std::begin(v_gb) + 16);
-		v_dmg07.push_back(new dmg07(_gbs4));
-		break;
-	}
-	
+		std::vector<gb*> _gbs;
+		for (size_t i = 0; i < groups[h].size(); i++)
+		{
+			if (groups[h][i] < (int)v_gb.size())
+				_gbs.push_back(v_gb[groups[h][i]]);
+		}
+		v_dmg07.push_back(new dmg07(_gbs));
 	}
 
 	for (int i = 0; i < v_dmg07.size(); i++)
@@ -249,6 +54,14 @@ void dmg07x4::process() {
 	}	
 }
 
+void dmg07x4::get_parts(std::vector<link_master_device*>& parts) {
+
+	for (size_t i = 0; i < v_dmg07.size(); i++)
+	{
+		parts.push_back(v_dmg07[i]);
+	}
+}
+
 void dmg07x4::reset() {
 
 	for (int i = 0; i < v_dmg07.size(); i++)
@@ -24,7 +24,7 @@
 
 extern int emulated_gbs; 
 
-faceball2000_cable::faceball2000_cable(std::vector<gb*> g_gb) {
+faceball2000_cable::faceball2000_cable(const std::vector<gb*>& g_gb) {
 	v_gb.insert(v_gb.begin(), std::begin(g_gb), std::end(g_gb));
 }
 
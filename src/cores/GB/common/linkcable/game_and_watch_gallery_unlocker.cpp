@@ -36,7 +36,7 @@
 
 extern int emulated_gbs;
 
-game_and_watch_gallery_unlocker::game_and_watch_gallery_unlocker(std::vector<gb*> g_gb) {
+game_and_watch_gallery_unlocker::game_and_watch_gallery_unlocker(const std::vector<gb*>& g_gb) {
 	v_gb.insert(v_gb.begin(), std::begin(g_gb), std::end(g_gb));
 }
 
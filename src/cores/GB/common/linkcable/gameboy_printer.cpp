@@ -20,19 +20,72 @@
 #include <fstream>
 #include <vector>
 #include <algorithm>
+#include <cstring>
 
 
 extern ScaleTarget gb_printer_png_scale_mode;
 extern Alignment gb_printer_png_alignment;
 
 
+//Each 2bpp tile byte spread to one bit per output byte, pixel 0 (bit 7) in the lowest byte
+static uint64_t tile_row_lut[256];
+
+static void build_tile_row_lut()
+{
+	static bool built = false;
+	if (built) return;
+
+	for (unsigned int b = 0; b < 256; b++)
+	{
+		uint64_t row = 0;
+		for (unsigned int z = 0; z < 8; z++)
+		{
+			if (b & (0x80 >> z)) { row |= (uint64_t)1 << (z * 8); }
+		}
+		tile_row_lut[b] = row;
+	}
+	built = true;
+}
+
 gameboy_printer::gameboy_printer()
 {
+	build_tile_row_lut();
+
+	//Reserve the worst case up front so printing never allocates while a frame runs
+	packet_buffer.reserve(0x400);
+	strip_pixels.reserve(0x5A00 + 2560);
+	full_buffer.reserve(0x119400 + 0x5A00);
+	dot_data.reserve(0x280);
+	for (unsigned int x = 0; x < PRINT_QUEUE_SIZE; x++) { jobs[x].pixels.reserve(0x5A00 + 2560); }
+
+	job_head = job_count = 0;
+	worker_quit = false;
+	prints_done = prints_failed = 0;
+	prints_reported = failures_reported = 0;
+
 	reset();
+
+	//The worker lives as long as the printer, creating a thread allocates
+	worker = std::thread(&gameboy_printer::print_worker, this);
+}
+
+gameboy_printer::~gameboy_printer()
+{
+	if (worker.joinable())
+	{
+		{
+			std::lock_guard<std::mutex> guard(job_lock);
+			worker_quit = true;
+		}
+		job_ready.notify_all();
+		worker.join();
+	}
 }
 
 byte gameboy_printer::receive_from_linkcable(byte data)
 {
+	report_prints();
+
 	//Check for magic bytes at any time during initial transfer
 	//Pokemon Pinball sometimes sends 0x10 0x33. Needs hardware verification on how this works. Treat it as valid for now.
 	if (((last_transfer == 0x88) || (last_transfer == 0x10)) && (data == 0x33) && (packet_size <= 6))
@@ -247,8 +300,7 @@ void gameboy_printer::execute_command()
 		strip_count = 0;
 
 		//Clear internal scanline data
-		scanline_buffer.clear();
-		scanline_buffer.resize(0x5A00, 0x0);
+		strip_pixels.assign(0x5A00, 0x0);
 
 		break;
 
@@ -285,70 +337,38 @@ void gameboy_printer::execute_command()
 
 void gameboy_printer::data_process()
 {
-	unsigned int data_pointer = 6;
-	unsigned int pixel_counter = strip_count * 2560;
-	byte tile_pixel = 0;
+	//Nothing to decode, the strip count stays where it is
+	if (data_length == 0) { return; }
 
-	if (strip_count >= 9)
+	//Strips past the 9th (and strips before any init command) extend the buffer
+	if (strip_pixels.size() < (strip_count + 1) * 2560u)
 	{
-		for (unsigned int x = 0; x < 2560; x++) { scanline_buffer.push_back(0x0); }
+		strip_pixels.resize((strip_count + 1) * 2560u, 0x0);
 	}
 
+	const byte* tiles;
+
 	//Process uncompressed dot data
 	if (!compression_flag)
 	{
-		//Cycle through all tiles given in the data, 40 in all
-		for (unsigned int x = 0; x < 40; x++)
+		if (packet_buffer.size() >= 6 + 0x280) { tiles = &packet_buffer[6]; }
+		else
 		{
-			//Grab 16-bytes representing each tile, 2 bytes at a time
-			for (unsigned int y = 0; y < 8; y++)
-			{
-				//Move pixel counter down one row in the tile
-				pixel_counter = (strip_count * 2560) + ((x % 20) * 8) + (160 * y);
-				if (x >= 20) { pixel_counter += 1280; }
-
-				//Grab 2-bytes representing 8x1 section
-				word tile_data = (packet_buffer[data_pointer + 1] << 8) | packet_buffer[data_pointer];
-				data_pointer += 2;
-
-				//Determine color of each pixel in that 8x1 section
-				for (int z = 7; z >= 0; z--)
-				{
-					//Calculate raw value of the tile's pixel
-					tile_pixel = ((tile_data >> 8) & (1 << z)) ? 2 : 0;
-					tile_pixel |= (tile_data & (1 << z)) ? 1 : 0;
-
-					switch (tile_pixel)
-					{
-					case 0:
-						scanline_buffer[pixel_counter++] = DMG_BG_PAL[0];
-						break;
-
-					case 1:
-						scanline_buffer[pixel_counter++] = DMG_BG_PAL[1];
-						break;
-
-					case 2:
-						scanline_buffer[pixel_counter++] = DMG_BG_PAL[2];
-						break;
-
-					case 3:
-						scanline_buffer[pixel_counter++] = DMG_BG_PAL[3];
-						break;
-					}
-				}
-			}
+			//Short strip, decode what was sent and leave the rest blank
+			dot_data.assign(packet_buffer.begin() + 6, packet_buffer.end());
+			dot_data.resize(0x280, 0x0);
+			tiles = dot_data.data();
 		}
 	}
 
 	//Process compressed dot data
 	else
 	{
-		std::vector<byte> dot_data;
-		byte data = 0;
+		unsigned int data_pointer = 6;
+		dot_data.clear();
 
 		//Cycle through all the compressed data and calculate the RLE
-		while (data_pointer < (data_length + 6))
+		while (data_pointer < (data_length + 6u) && data_pointer < packet_buffer.size())
 		{
 			//Grab MSB of 1st byte in the run, if 1 the run is compressed, otherwise it is an uncompressed run
 			byte data = packet_buffer[data_pointer++];
@@ -357,207 +377,151 @@ void gameboy_printer::data_process()
 			if (data & 0x80)
 			{
 				byte length = (data & 0x7F) + 2;
-				data = packet_buffer[data_pointer++];
+				data = data_pointer < packet_buffer.size() ? packet_buffer[data_pointer++] : 0;
 
-				for (unsigned int x = 0; x < length; x++) { dot_data.push_back(data); }
+				dot_data.insert(dot_data.end(), length, data);
 			}
 
 			//Uncompressed run
 			else
 			{
 				byte length = (data & 0x7F) + 1;
+				if (data_pointer + length > packet_buffer.size()) { length = packet_buffer.size() - data_pointer; }
 
-				for (unsigned int x = 0; x < length; x++)
-				{
-					data = packet_buffer[data_pointer++];
-					dot_data.push_back(data);
-				}
+				dot_data.insert(dot_data.end(), packet_buffer.begin() + data_pointer, packet_buffer.begin() + data_pointer + length);
+				data_pointer += length;
 			}
 		}
 
-		data_pointer = 0;
+		if (dot_data.size() < 0x280) { dot_data.resize(0x280, 0x0); }
+		tiles = dot_data.data();
+	}
+
+	decode_strip(tiles);
 
-		//Cycle through all tiles given in the data, 40 in all
-		for (unsigned int x = 0; x < 40; x++)
+	strip_count++;
+}
+
+//Cycle through all tiles given in the data, 40 in all (2 rows of 20), and store the 2-bit index of every pixel
+void gameboy_printer::decode_strip(const byte* tiles)
+{
+	byte* strip = &strip_pixels[strip_count * 2560];
+
+	for (unsigned int x = 0; x < 40; x++)
+	{
+		byte* tile = strip + ((x % 20) * 8) + ((x >= 20) ? 1280 : 0);
+
+		//Grab 16-bytes representing each tile, 2 bytes (low plane, high plane) per 8x1 row
+		for (unsigned int y = 0; y < 8; y++)
 		{
-			//Grab 16-bytes representing each tile, 2 bytes at a time
-			for (unsigned int y = 0; y < 8; y++)
-			{
-				//Move pixel counter down one row in the tile
-				pixel_counter = (strip_count * 2560) + ((x % 20) * 8) + (160 * y);
-				if (x >= 20) { pixel_counter += 1280; }
-
-				//Grab 2-bytes representing 8x1 section
-				word tile_data = (dot_data[data_pointer + 1] << 8) | dot_data[data_pointer];
-				data_pointer += 2;
-
-				//Determine color of each pixel in that 8x1 section
-				for (int z = 7; z >= 0; z--)
-				{
-					//Calculate raw value of the tile's pixel
-					tile_pixel = ((tile_data >> 8) & (1 << z)) ? 2 : 0;
-					tile_pixel |= (tile_data & (1 << z)) ? 1 : 0;
-
-					switch (tile_pixel)
-					{
-					case 0:
-						scanline_buffer[pixel_counter++] = DMG_BG_PAL[0];
-						break;
-
-					case 1:
-						scanline_buffer[pixel_counter++] = DMG_BG_PAL[1];
-						break;
-
-					case 2:
-						scanline_buffer[pixel_counter++] = DMG_BG_PAL[2];
-						break;
-
-					case 3:
-						scanline_buffer[pixel_counter++] = DMG_BG_PAL[3];
-						break;
-					}
-				}
-			}
+			uint64_t row = tile_row_lut[tiles[0]] | (tile_row_lut[tiles[1]] << 1);
+			memcpy(tile + (160 * y), &row, 8);
+			tiles += 2;
 		}
 	}
-
-	//Only increment strip count if we actually received data
-	if (data_length != 0) { strip_count++; }
 }
 
 void gameboy_printer::print_image()
 {
 	unsigned int height = (16 * strip_count);
-	unsigned int img_size = 160 * height;
 
 	byte margin_top = (packet_buffer[7] & 0xF0);
-	byte margin_bottom = (packet_buffer[7] & 0x0F);
-	bool print_full_pix = (!margin_top && margin_bottom) ? true : false;
-
-	//Clear full printer buffer if new strip detected or it gets way too large (50 160x144 strips)
-	if ((margin_top) || (full_buffer.size() >= 0x119400)) { full_buffer.clear(); }
 
-	//Set up printing palette
-	byte data_pal = packet_buffer[8];
-
-	pal[0] = data_pal & 0x3;
-	pal[1] = (data_pal >> 2) & 0x3;
-	pal[2] = (data_pal >> 4) & 0x3;
-	pal[3] = (data_pal >> 6) & 0x3;
-
-	//Calculate printing exposure (contrast for final pixels) and set color accordingly
-	short exposure = (packet_buffer[9] & 0x7F);
-	unsigned int print_color_0 = (DMG_BG_PAL[0] & 0xFF);
-	unsigned int print_color_1 = (DMG_BG_PAL[1] & 0xFF);
-	unsigned int print_color_2 = (DMG_BG_PAL[2] & 0xFF);
-	unsigned int print_color_3 = (DMG_BG_PAL[3] & 0xFF);
-
-	double diff = (0x40 - exposure) * (25.0 / 64);
-	diff = ((100 + diff) / 100);
+	//Hand the strips over, the worker maps palette and exposure and writes the image
+	queue_print(height, packet_buffer[8], (packet_buffer[9] & 0x7F), margin_top != 0);
 
+	strip_count = 0;
+}
 
-	print_color_0 = std::min(std::max(int(print_color_0 * diff), 0), 255);
-	print_color_1 = std::min(std::max(int(print_color_1 * diff), 0), 255);
-	print_color_2 = std::min(std::max(int(print_color_2 * diff), 0), 255);
-	print_color_3 = std::min(std::max(int(print_color_3 * diff), 0), 255);
+void gameboy_printer::queue_print(unsigned int height, byte palette, byte exposure, bool new_image)
+{
+	std::unique_lock<std::mutex> guard(job_lock);
 
-	/*
-	if ((print_color_0 * diff) > 255) { print_color_0 = 255; }
-	else if ((print_color_0 * diff) < 0) { print_color_0 = 0; }
-	else { print_color_0 *= diff; }
-	print_color_0 = 0xFF000000 | (print_color_0 << 16) | (print_color_0 << 8) | print_color_0;
+	//Backpressure: a full queue stalls the emulation until the oldest print is written
+	job_space.wait(guard, [this]() { return job_count < PRINT_QUEUE_SIZE; });
 
-	if ((print_color_1 * diff) > 255) { print_color_1 = 255; }
-	else if ((print_color_1 * diff) < 0) { print_color_1 = 0; }
-	else { print_color_1 *= diff; }
-	print_color_1 = 0xFF000000 | (print_color_1 << 16) | (print_color_1 << 8) | print_color_1;
+	print_job& job = jobs[(job_head + job_count) % PRINT_QUEUE_SIZE];
+	job.pixels.assign(strip_pixels.begin(), strip_pixels.begin() + std::min<size_t>(160 * height, strip_pixels.size()));
+	job.height = height;
+	job.palette = palette;
+	job.exposure = exposure;
+	job.new_image = new_image;
+	job_count++;
 
-	if ((print_color_2 * diff) > 255) { print_color_2 = 255; }
-	else if ((print_color_2 * diff) < 0) { print_color_2 = 0; }
-	else { print_color_2 *= diff; }
-	print_color_2 = 0xFF000000 | (print_color_2 << 16) | (print_color_2 << 8) | print_color_2;
+	guard.unlock();
+	job_ready.notify_one();
+}
 
-	if ((print_color_3 * diff) > 255) { print_color_3 = 255; }
-	else if ((print_color_3 * diff) < 0) { print_color_3 = 0; }
-	else { print_color_3 *= diff; }
-	print_color_3 = 0xFF000000 | (print_color_3 << 16) | (print_color_3 << 8) | print_color_3;
-	*/
+void gameboy_printer::print_worker()
+{
+	std::unique_lock<std::mutex> guard(job_lock);
 
-	for (unsigned int x = 0; x < img_size; x++)
+	for (;;)
 	{
-		//Convert pixels to printer palette if necessary
-		byte tile_pixel = 0;
-
-		if (scanline_buffer[x] == DMG_BG_PAL[0]) { tile_pixel = 0; }
-		else if (scanline_buffer[x] == DMG_BG_PAL[1]) { tile_pixel = 1; }
-		else if (scanline_buffer[x] == DMG_BG_PAL[2]) { tile_pixel = 2; }
-		else if (scanline_buffer[x] == DMG_BG_PAL[3]) { tile_pixel = 3; }
-
-		switch (pal[tile_pixel])
-		{
-		case 0:
-			scanline_buffer[x] = print_color_0;
-			break;
-
-		case 1:
-			scanline_buffer[x] = print_color_1;
-			break;
+		job_ready.wait(guard, [this]() { return worker_quit || job_count != 0; });
+		if (job_count == 0) { return; }
 
-		case 2:
-			scanline_buffer[x] = print_color_2;
-			break;
+		//The slot stays reserved while it is written, the emulation thread only fills free ones
+		print_job& job = jobs[job_head];
+		guard.unlock();
 
-		case 3:
-			scanline_buffer[x] = print_color_3;
-			break;
-		}
+		bool ok = write_job(job);
 
-		//Fill full print buffer continuously
-		full_buffer.push_back(scanline_buffer[x]);
+		guard.lock();
+		job_head = (job_head + 1) % PRINT_QUEUE_SIZE;
+		job_count--;
+		if (ok) { prints_done++; }
+		else { prints_failed++; }
+		job_space.notify_one();
 	}
+}
 
-	
-
-	strip_count = 0;
+bool gameboy_printer::write_job(const print_job& job)
+{
+	//Clear full printer buffer if new strip detected or it gets way too large (50 160x144 strips)
+	if ((job.new_image) || (full_buffer.size() >= 0x119400)) { full_buffer.clear(); }
 
-	/*
+	//Calculate printing exposure (contrast for final pixels) and set color accordingly
+	double diff = (0x40 - job.exposure) * (25.0 / 64);
+	diff = ((100 + diff) / 100);
 
-	//Print full combined strip if detected
-	if (print_full_pix)
+	//Printer palette, index -> shade -> exposed gray level
+	unsigned int colors[4];
+	for (unsigned int x = 0; x < 4; x++)
 	{
-		height = full_buffer.size() / 160;
-		SDL_Surface* full_screen = SDL_CreateRGBSurface(SDL_SWSURFACE, 160, height, 32, 0, 0, 0, 0);
-
-		if (SDL_MUSTLOCK(full_screen)) { SDL_LockSurface(full_screen); }
-		unsigned int* full_pixel_data = (unsigned int*)full_screen->pixels;
-
-		for (unsigned int x = 0; x < full_buffer.size(); x++) { full_pixel_data[x] = full_buffer[x]; }
-		full_buffer.clear();
-
-		//Unlock source surface
-		if (SDL_MUSTLOCK(full_screen)) { SDL_UnlockSurface(full_screen); }
-
-		filename = "full_" + filename;
+		byte shade = (job.palette >> (x * 2)) & 0x3;
+		colors[x] = std::min(std::max(int((DMG_BG_PAL[shade] & 0xFF) * diff), 0), 255);
+	}
 
-		SDL_SaveBMP(full_screen, filename.c_str());
-		SDL_FreeSurface(full_screen);
+	//Fill full print buffer continuously
+	size_t start = full_buffer.size();
+	full_buffer.resize(start + job.pixels.size());
+	for (size_t x = 0; x < job.pixels.size(); x++)
+	{
+		full_buffer[start + x] = colors[job.pixels[x] & 0x3];
 	}
 
-	*/
+	if (full_buffer.empty()) { return false; }
 
+	return PrinterRegistry::current()->print(reinterpret_cast<const uint32_t*>(full_buffer.data()), 160, job.height, gb_printer_png_scale_mode, gb_printer_png_alignment);
+}
 
-	unsigned int width = 160;
-	unsigned int gb_height = full_buffer.size() / width;
+//Results come back from the worker, the OSD message is shown from the emulation thread
+void gameboy_printer::report_prints()
+{
+	unsigned int done = prints_done;
+	unsigned int failed = prints_failed;
 
+	if (done == prints_reported && failed == failures_reported) { return; }
 
-	if (
-		PrinterRegistry::current()->print(reinterpret_cast<const uint32_t*>(full_buffer.data()), width, height, gb_printer_png_scale_mode, gb_printer_png_alignment)
-		)
-		display_message("Printed successfull to ./Screenshots");
-	else
-		display_message("Something went wrong.");
+	//The OSD message is a std::string
+	alloc_guard_exempt exempt;
 
+	if (failed != failures_reported) { display_message("Something went wrong."); }
+	else { display_message("Printed successfull to ./Screenshots"); }
 
+	prints_reported = done;
+	failures_reported = failed;
 }
 
 void gameboy_printer::reset()
@@ -34,9 +34,10 @@
 #include "./include/hack_4p_burger_time_deluxe.hpp"
 
 
-hack_4p_burger_time_deluxe::hack_4p_burger_time_deluxe(std::vector<gb*> g_gb) {
+hack_4p_burger_time_deluxe::hack_4p_burger_time_deluxe(const std::vector<gb*>& g_gb) {
 
 	v_gb.insert(v_gb.begin(), std::begin(g_gb), std::end(g_gb));
+	use_v_gb_size = true;
 
 	game_state = BURGERTIME_TITLE_SCREEN;
 
@@ -128,15 +129,6 @@ void hack_4p_burger_time_deluxe::fill_send_data_queue(char sequence[])
 	}
 }
 
-void hack_4p_burger_time_deluxe::get_all_SC_reg_data()
-{
-	for (int i = 0; i < v_gb.size(); i++)
-	{
-		byte data = v_gb[i]->get_regs()->SC;
-		in_data_buffer[i] = data;
-	}
-};
-
 void hack_4p_burger_time_deluxe::get_all_SB_reg_data()
 {
 	for (int i = 0; i < v_gb.size(); i++)
@@ -157,18 +149,12 @@ bool hack_4p_burger_time_deluxe::is_expected_data(byte data)
 
 bool hack_4p_burger_time_deluxe::is_ready_to_process() {
 
-	get_all_SC_reg_data();
-	return is_expected_data(0x80) && all_IE_are_handled();
+	return gbs_are_ready_to_process();
 }
 
 bool hack_4p_burger_time_deluxe::all_IE_are_handled()
 {
-	for (int i = 0; i < v_gb.size(); i++)
-	{
-		if ((v_gb[i]->get_regs()->IF & v_gb[i]->get_regs()->IE & INT_SERIAL)) return false;
-	}
-	return true;
-
+	return link_master_device::all_IE_are_handled();
 }
 
 void hack_4p_burger_time_deluxe::save_state_mem(void* buf)
@@ -25,12 +25,14 @@
 #include <fstream>
 
 
-hack_4p_kwirk::hack_4p_kwirk(std::vector<gb*> g_gb)
+hack_4p_kwirk::hack_4p_kwirk(const std::vector<gb*>& g_gb)
 {
 	v_gb = g_gb;
 	for (int i = 0; i < v_gb.size(); i++)
 	{
 		v_gb[i]->set_linked_target(this);
+		// the gbs publish their SC state, the master is the one clocking
+		if (i < 32) v_gb[i]->set_link_readiness(&ready, i);
 	}
 	reset();
 	
@@ -61,12 +63,11 @@ byte hack_4p_kwirk::receive_from_linkcable(byte data)
 
 	if (master_id == -1)
 	{
-		get_all_SC_reg_data();
+		uint32_t clocking = ready.get_clocking();
 
-		for (int i = 0; i < v_gb.size(); i++)
+		for (int i = 0; i < v_gb.size() && i < 32; i++)
 		{
-			if (in_data_buffer[i] == 0x81) master_id = i;
-			log_traffic(i, in_data_buffer[i]);
+			if (clocking & (1u << i)) master_id = i;
 		}
 	}
 
@@ -186,15 +187,6 @@ void hack_4p_kwirk::get_all_SB_reg_data()
 	}
 }
 
-void hack_4p_kwirk::get_all_SC_reg_data()
-{
-	for (int i = 0; i < v_gb.size(); i++)
-	{
-		byte data = v_gb[i]->get_regs()->SC;
-		in_data_buffer[i] = data;
-	}
-}
-
 void hack_4p_kwirk::redirect_data(byte data)
 {
 
@@ -24,7 +24,7 @@
 #include "./include/hack_4p_tetris.hpp"
 #include <libretro.h>
 #include <string>
-#include <sstream>
+#include <cstdio>
 #include <vector>
 #include <queue>
 #include <ctime>
@@ -36,10 +36,17 @@ extern int emulated_gbs;
 extern retro_environment_t environ_cb;
 extern unsigned libretro_msg_interface_version;
 
-hack_4p_tetris::hack_4p_tetris(std::vector<gb*> g_gb) {
+hack_4p_tetris::hack_4p_tetris(const std::vector<gb*>& g_gb) {
 
 	v_gb.insert(v_gb.begin(), std::begin(g_gb), std::end(g_gb));
 
+	// sized for a whole round (100 height blocks, 256 falling blocks and their
+	// trailers) so the link transfers stay off the heap
+	out_height_blocks.reserve(128);
+	out_falling_blocks.reserve(288);
+	send_data_vec.reserve(64);
+	lines_vec.reserve(64);
+
 	tetris_state = TITLE_SCREEN;
 
 	seri_occer = 4096 * 1024 * 4;
@@ -87,7 +94,7 @@ void hack_4p_tetris::reset()
 	//process_occer = 5;
 
 	clear_data_for_next_round();
-	send_data_vec = std::vector<byte>();
+	send_data_vec.clear();
 	init_send_data_vec();
 
 	for (int i = 0; i < 16; i++)
@@ -197,24 +204,6 @@ void hack_4p_tetris::log_traffic(byte id, byte b)
 
 }
 
-/*
-bool hack_4p_tetris::is_ready_to_process() {
-
-	get_all_SC_reg_data();
-	return is_expected_data(0x80) && all_IE_are_handled();
-}
-
-bool hack_4p_tetris::all_IE_are_handled() 
-{
-	for (int i = 0; i < emulated_gbs; i++)
-	{
-		if ((v_gb[i]->get_regs()->IF & v_gb[i]->get_regs()->IE & INT_SERIAL)) return false;
-	}
-	return true;
-
-}
-*/
-
 void hack_4p_tetris::process() {
 
 
@@ -241,12 +230,6 @@ void hack_4p_tetris::process() {
 		}
 		
 	
-		/*
-		if (++process_counter < 5) return 0;
-		process_counter = 0;
-		if (!is_ready_to_process()) return 0;
-		*/
-		//if (!is_ready_to_process()) return;
 
 			
 		
@@ -258,7 +241,6 @@ void hack_4p_tetris::process() {
 		if (++process_counter < 5) return 0;
 		process_counter = 0;
 		*/
-		//if (!is_ready_to_process()) return;
 
 		if (!send_data_vec.empty())
 		{
@@ -276,10 +258,6 @@ void hack_4p_tetris::process() {
 	}
 	case HEIGHT_SELECT:
 	{
-		/*
-		if (++process_counter < 5 && !is_ready_to_process()) return 0;
-		process_counter = 0;
-		*/
 		transfer_speed = 4096;
 		
 		if (!out_height_blocks.empty())
@@ -312,14 +290,7 @@ void hack_4p_tetris::process() {
 	{
 
 		transfer_speed = 4096 * 1024 / 8;
-		/*
-		if (++process_counter < 5) return 0;
-		process_counter = 0;
-		if (!is_ready_to_process()) return 0;
-		*/
-
-
-		get_all_SC_reg_data();
+		// the ready gate at the top of process() already covers SC, IF and IE
 		handle_ingame_data();
 		break;
 
@@ -350,10 +321,6 @@ void hack_4p_tetris::process() {
 	}
 	case START_NEXT:
 	{
-		/*
-		if (++process_counter < 5 && !is_ready_to_process()) return 0;
-		process_counter = 0;
-		*/
 
 		if (!send_data_vec.empty())
 		{
@@ -422,36 +389,6 @@ void hack_4p_tetris::generate_falling_blocks()
 };
 
 
-/*
-void hack_4p_tetris::get_all_SC_reg_data()
-{
-	for (int i = 0; i < emulated_gbs; i++)
-	{
-		byte data = v_gb[i]->get_regs()->SC;
-		in_data_buffer[i] = data;
-	}
-};
-
-void hack_4p_tetris::get_all_SB_reg_data()
-{
-	for (int i = 0; i < emulated_gbs; i++)
-	{
-		byte data = v_gb[i]->get_regs()->SB;
-		in_data_buffer[i] = data;
-	}
-};
-
-bool hack_4p_tetris::is_expected_data(byte data)
-{
-	for (int i = 0; i < emulated_gbs; i++)
-	{
-		if (in_data_buffer[i] != data) return false; 
-	}
-	return true;
-}
-
-*/
-
 void hack_4p_tetris::handle_ingame_data() 
 {
 	get_all_SB_reg_data();
@@ -536,14 +473,13 @@ void hack_4p_tetris::update_ingame_states()
 				win_counter[i]++;
 				next_bytes_to_send[i] = 0x43;
 
-				std::ostringstream oss;
-				oss << (i + 1);
-				std::string msg_str = "congrats to player " + oss.str() + "!";
+				char msg_str[32];
+				snprintf(msg_str, sizeof(msg_str), "congrats to player %d!", (int)(i + 1));
 
 				if (libretro_msg_interface_version >= 1)
 				{	
 					struct retro_message_ext msg = {
-					   msg_str.data(),
+					   msg_str,
 					   1000,
 					   1,
 					   RETRO_LOG_INFO,
@@ -556,7 +492,7 @@ void hack_4p_tetris::update_ingame_states()
 				else
 				{
 					struct retro_message msg = {
-						msg_str.data(),
+						msg_str,
 					   120
 					};
 					environ_cb(RETRO_ENVIRONMENT_SET_MESSAGE, &msg);
@@ -600,19 +536,15 @@ void hack_4p_tetris::update_ingame_states()
 				players_state[i] = IS_KO;
 				next_bytes_to_send[i] = 0xaa; // send ko for draw, cause only winning counts
 
-				std::ostringstream oss;
-				oss << (i + 1);
-				std::string msg_str = "Player " + oss.str() + " KO! ";
-				oss.str("");
-				oss << player_alive_count();
-				msg_str = msg_str + oss.str() + " players left";
+				char msg_str[48];
+				snprintf(msg_str, sizeof(msg_str), "Player %d KO! %d players left", (int)(i + 1), (int)player_alive_count());
 
 
 				if (libretro_msg_interface_version >= 1)
 				{
 					
 					struct retro_message_ext msg = {
-					   msg_str.data(),
+					   msg_str,
 					   1000,
 					   1,
 					   RETRO_LOG_INFO,
@@ -625,7 +557,7 @@ void hack_4p_tetris::update_ingame_states()
 				else
 				{
 					struct retro_message msg = {
-						msg_str.data(),
+						msg_str,
 					   120
 					};
 					environ_cb(RETRO_ENVIRONMENT_SET_MESSAGE, &msg);
@@ -749,19 +681,19 @@ size_t hack_4p_tetris::get_state_size(void)
 	int size;
 	size = out_height_blocks.size();
 	s_VAR(size);
-	s_ARRAY(out_height_blocks.data());
+	s.process(out_height_blocks.data(), size);
 
 	size = out_falling_blocks.size();
 	s_VAR(size);
-	s_ARRAY(out_falling_blocks.data());
+	s.process(out_falling_blocks.data(), size);
 
 	size = send_data_vec.size();
 	s_VAR(size);
-	s_ARRAY(send_data_vec.data());
+	s.process(send_data_vec.data(), size);
 
 	size = lines_vec.size();
 	s_VAR(size);
-	s_ARRAY(lines_vec.data());
+	s.process(lines_vec.data(), size * sizeof(hack_4p_tetris_lines_packet));
 
 	return ret;
 }
@@ -777,70 +709,46 @@ void hack_4p_tetris::save_state_mem(void* buf)
 
 	size = out_height_blocks.size();
 	s_VAR(size);
-	if(size)s_ARRAY(out_height_blocks.data());
+	s.process(out_height_blocks.data(), size);
 
 	size = out_falling_blocks.size();
 	s_VAR(size);
-	if (size)s_ARRAY(out_falling_blocks.data());
+	s.process(out_falling_blocks.data(), size);
 	
 	size = send_data_vec.size();
 	s_VAR(size);
-	if (size)s_ARRAY(send_data_vec.data());
+	s.process(send_data_vec.data(), size);
 
 	size = lines_vec.size();
 	s_VAR(size);
-	if (size)s_ARRAY(lines_vec.data());
+	s.process(lines_vec.data(), size * sizeof(hack_4p_tetris_lines_packet));
 
 	
 }
 
+// the queues are read in place, within the capacity reserved by the constructor
 void hack_4p_tetris::restore_state_mem(void* buf)
 {
 	serializer s(buf, serializer::LOAD_BUF);
 	serialize(s);
 
 	int size;
-	byte* tmp;
-	out_height_blocks = std::vector<byte>();
-	out_falling_blocks = std::vector<byte>();
-	send_data_vec = std::vector<byte>();
-	lines_vec = std::vector<hack_4p_tetris_lines_packet>();
 
 	s_VAR(size);
-	if (size) {
-		tmp = new byte[size];
-		s_ARRAY(tmp);
-
-		for (int i = 0; i < size; i++)
-			out_height_blocks.push_back(tmp[i]);
-	}
+	out_height_blocks.resize(size);
+	s.process(out_height_blocks.data(), size);
 	
 	s_VAR(size);
-	if (size) {
-		tmp = new byte[size];
-		s_ARRAY(tmp);
-		for (int i = 0; i < size; i++)
-			out_falling_blocks.push_back(tmp[i]);
-	}
+	out_falling_blocks.resize(size);
+	s.process(out_falling_blocks.data(), size);
 
 	s_VAR(size);
-	if (size) {
-		tmp = new byte[size];
-		s_ARRAY(tmp);
-
-		for (int i = 0; i < size; i++)
-			send_data_vec.push_back(tmp[i]);
-	}
-
+	send_data_vec.resize(size);
+	s.process(send_data_vec.data(), size);
 
 	s_VAR(size);
-	if (size) {
-		hack_4p_tetris_lines_packet* lp = new hack_4p_tetris_lines_packet[size];
-		s_ARRAY(lp);
-
-		for (int i = 0; i < size; i++)
-			lines_vec.push_back(lp[i]);
-	}
+	lines_vec.resize(size);
+	s.process(lines_vec.data(), size * sizeof(hack_4p_tetris_lines_packet));
 	
 }
 
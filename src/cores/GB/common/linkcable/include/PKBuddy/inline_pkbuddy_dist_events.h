@@ -22,13 +22,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 6:
 		case 7:
 		{
-			display_message("Pokemon Stadium RBY Starters Week");
+			show_message("Pokemon Stadium RBY Starters Week");
 
 			int len = 3;
 			int dex_no[] = { 0,3,6 };
 			int levels[] = { 5,5,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -40,7 +40,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			}
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 
 
@@ -53,13 +53,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("Stadium Fighters Week");
+			show_message("Stadium Fighters Week");
 
 			int len = 2;
 			int dex_no[] = { 105,106 };
 			int levels[] = { 20,20 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -71,7 +71,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			}
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -82,13 +82,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 20:
 		case 21:
 		{
-			display_message("Stadium EEVEE WeekK");
+			show_message("Stadium EEVEE WeekK");
 
 			int len = 1;
 			int dex_no[] = { 132 };
 			int levels[] = { 25 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -100,7 +100,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			}
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -111,13 +111,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 27:
 		case 28:
 		{
-			display_message("Stadium Water WEEK");
+			show_message("Stadium Water WEEK");
 
 			int len = 2;
 			int dex_no[] = { 137,139 };
 			int levels[] = { 20, 20 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -129,20 +129,20 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			}
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("Stadium AMNESIA PSYDUCK Days");
+			show_message("Stadium AMNESIA PSYDUCK Days");
 
 			int len = 1;
 			int dex_no[] = { 53 };
 			int levels[] = { 15 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -155,7 +155,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 
 			DATA_BLOCK.pokemons[0].move2 = 0x85;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 
 		}
@@ -176,17 +176,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 6:
 		case 7:
 		{
-			display_message("FIGHT TYPE WEEK");
+			show_message("FIGHT TYPE WEEK");
 
 			int len = 5;
 			int dex_no[] = { 56,61,65,66,67};
 			int levels[] = { 25,40,5,28,40 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -197,13 +197,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("Valentin's Weeks");
+			show_message("Valentin's Weeks");
 
 			int len = 2;
 			int dex_no[] = { 28,31 };
 			int levels[] = { 5, 5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -217,7 +217,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			DATA_BLOCK.pokemons[0].move3 = 0x85;
 			DATA_BLOCK.pokemons[1].move3 = 0x85;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 
 		}
@@ -229,13 +229,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 20:
 		case 21:
 		{
-			display_message("Legendary Birds Week");
+			show_message("Legendary Birds Week");
 
 			int len = 3;
 			int dex_no[] = { 143, 144, 145 };
 			int levels[] = { 50, 50, 50 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -246,7 +246,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -258,13 +258,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 28:
 		case 29:
 		{
-			display_message("Rare Pokemon Week");
+			show_message("Rare Pokemon Week");
 
 			int len = 3;
 			int dex_no[] = { 142, 132, 136 };
 			int levels[] = { 5, 5, 5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -280,7 +280,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			DATA_BLOCK.pokemons[2].move4 = 0x70;
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 30:
@@ -302,13 +302,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 6:
 		case 7:
 		{
-			display_message("Bug Type Week");
+			show_message("Bug Type Week");
 
 			int len = 2;
 			int dex_no[] = { 122, 126};
 			int levels[] = { 5, 5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -324,7 +324,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -335,13 +335,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("RED Exclusives Week");
+			show_message("RED Exclusives Week");
 
 			int len = 5;
 			int dex_no[] = { 22,42,55,57,124};
 			int levels[] = { 5, 5, 5,5,30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -352,7 +352,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -363,13 +363,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 20:
 		case 21:
 		{
-			display_message("BLUE Exclusives Week");
+			show_message("BLUE Exclusives Week");
 
 			int len = 5;
 			int dex_no[] = { 26,36,51,68,125 };
 			int levels[] = { 5, 5, 5,5,30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -380,7 +380,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -391,13 +391,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 27:
 		case 28:
 		{
-			display_message("Safari Week");
+			show_message("Safari Week");
 
 			int len = 5;
 			int dex_no[] = { 114,127,112,29,32 };
 			int levels[] = { 30, 5, 23,31,31 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -415,27 +415,27 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			DATA_BLOCK.pokemons[1].move3 = 0x62;
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("Psychic Jynx Days");
+			show_message("Psychic Jynx Days");
 
 			int len = 1;
 			int dex_no[] = { 123 };
 			int levels[] = { 5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
 			//modify default stats
 			DATA_BLOCK.pokemons[0].move3 = 0x5E;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		default:
@@ -455,13 +455,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 6:
 		case 7:
 		{
-			display_message("Team Brock Week");
+			show_message("Team Brock Week");
 
 			int len = 2;
 			int dex_no[] = { 73, 93 };
 			int levels[] = { 12, 14 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -472,7 +472,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -483,13 +483,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("Team Misty Week");
+			show_message("Team Misty Week");
 
 			int len = 2;
 			int dex_no[] = { 119, 120 };
 			int levels[] = { 18, 21 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -500,7 +500,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -511,13 +511,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 20:
 		case 21:
 		{
-			display_message("Team Lt. Surge Week");
+			show_message("Team Lt. Surge Week");
 
 			int len = 3;
 			int dex_no[] = { 99, 24, 25 };
 			int levels[] = { 21, 18, 24 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -528,7 +528,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -539,13 +539,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 27:
 		case 28:
 		{
-			display_message("Team Erika Week");
+			show_message("Team Erika Week");
 
 			int len = 3;
 			int dex_no[] = { 70,113,44 };
 			int levels[] = { 29,24,29 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -556,19 +556,19 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		{
-			display_message("Blizzard Lapras Days");
+			show_message("Blizzard Lapras Days");
 
 			int len = 1;
 			int dex_no[] = { 130 };
 			int levels[] = { 5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -576,7 +576,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			DATA_BLOCK.pokemons[0].move3 = 0x3B;
 		
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 31:
@@ -596,13 +596,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 6:
 		case 7:
 		{
-			display_message("Team Koga Week");
+			show_message("Team Koga Week");
 
 			int len = 4;
 			int dex_no[] = { 108,108,88,109 };
 			int levels[] = { 37,37,39,43};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -613,7 +613,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -624,13 +624,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("Team Sabrina Week");
+			show_message("Team Sabrina Week");
 
 			int len = 4;
 			int dex_no[] = { 63,111,48,64 };
 			int levels[] = { 38,37,38,43};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -641,7 +641,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -652,13 +652,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 20:
 		case 21:
 		{
-			display_message("Team Blaine Week");
+			show_message("Team Blaine Week");
 
 			int len = 4;
 			int dex_no[] = { 57,76,77,58 };
 			int levels[] = { 42,40,42,47 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -669,7 +669,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -680,13 +680,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 27:
 		case 28:
 		{
-			display_message("Team Giovanni Week");
+			show_message("Team Giovanni Week");
 
 			int len = 4;
 			int dex_no[] = { 57,76,77,58 };
 			int levels[] = { 42,40,42,47 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -697,27 +697,27 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("Psychic Starmie Days");
+			show_message("Psychic Starmie Days");
 
 			int len = 1;
 			int dex_no[] = { 120 };
 			int levels[] = { 30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
 			//modify default stats
 			DATA_BLOCK.pokemons[0].move4 = 0x5E;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		default:
@@ -737,13 +737,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 7:
 		{
 			
-			display_message("Team Lorelei Week");
+			show_message("Team Lorelei Week");
 
 			int len = 5;
 			int dex_no[] = { 86,90,79,123,130 };
 			int levels[] = { 54,43,54,56,56};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -754,7 +754,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		
 		}
@@ -766,13 +766,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("Team Bruno Week");
+			show_message("Team Bruno Week");
 
 			int len = 5;
 			int dex_no[] = { 94,106,105,94,67 };
 			int levels[] = { 53,55,55,56,58};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -783,7 +783,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -794,13 +794,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 20:
 		case 21:
 		{
-			display_message("Team Agatha Week");
+			show_message("Team Agatha Week");
 
 			int len = 5;
 			int dex_no[] = { 93,41,92,23,93 };
 			int levels[] = { 56,56,55,58,60 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -811,7 +811,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -822,13 +822,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 27:
 		case 28:
 		{
-			display_message("Team Lance Week");
+			show_message("Team Lance Week");
 
 			int len = 5;
 			int dex_no[] = { 129,147,147,141,148 };
 			int levels[] = { 58,56,56,60,62 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -839,20 +839,20 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("Fireblast Hyper Beam Ninetales Days");
+			show_message("Fireblast Hyper Beam Ninetales Days");
 
 			int len = 1;
 			int dex_no[] = { 37 };
 			int levels[] = { 40 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -860,7 +860,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			DATA_BLOCK.pokemons[0].move1 = 0x7E;
 			DATA_BLOCK.pokemons[0].move3 = 0x3F;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		default:
@@ -880,13 +880,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 6:
 		case 7:
 		{
-			display_message("University Magikarp Week");
+			show_message("University Magikarp Week");
 
 			int len = 1;
 			int dex_no[] = { 128 };
 			int levels[] = { 15 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -900,7 +900,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			//modify default stats
 			DATA_BLOCK.pokemons[0].move2 = 0x52;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -911,13 +911,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("Tropical Promotion to Summer Festival 2");
+			show_message("Tropical Promotion to Summer Festival 2");
 
 			int len = 3;
 			int dex_no[] = { 53,71,130 };
 			int levels[] = { 5,5,5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -933,7 +933,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			DATA_BLOCK.pokemons[2].move4 = 0x2C;
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -944,13 +944,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 20:
 		case 21:
 		{
-			display_message("ICE IN THE SUNSHINE WEEK");
+			show_message("ICE IN THE SUNSHINE WEEK");
 
 			int len = 4;
 			int dex_no[] = { 86,90,129,6 };
 			int levels[] = { 34,25,20,5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -960,7 +960,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			DATA_BLOCK.pokemons[2].move3 = 0x3A;
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -971,17 +971,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 27:
 		case 28:
 		{
-			display_message("GRASS TYPE WEEK");
+			show_message("GRASS TYPE WEEK");
 
 			int len = 4;
 			int dex_no[] = { 113,2,44,102};
 			int levels[] = { 5,32,32,32};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29: 
@@ -989,17 +989,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 31:
 		
 		{
-			display_message("Earthquake Rhydon Days");
+			show_message("Earthquake Rhydon Days");
 
 			int len = 1;
 			int dex_no[] = { 111 };
 			int levels[] = { 42 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		default:
@@ -1019,13 +1019,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 6:
 		case 7:
 		{
-			display_message("Pokemon Stamp Week");
+			show_message("Pokemon Stamp Week");
 
 			int len = 2;
 			int dex_no[] = { 21,77};
 			int levels[] = { 25,40 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -1040,7 +1040,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			DATA_BLOCK.pokemons[0].move4 = 0x06;
 			DATA_BLOCK.pokemons[1].move4 = 0x06;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -1051,13 +1051,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("EEVEE EVOLUTION WEEK");
+			show_message("EEVEE EVOLUTION WEEK");
 
 			int len = 3;
 			int dex_no[] = { 133,134,135 };
 			int levels[] = { 20,20,20 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -1067,7 +1067,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			DATA_BLOCK.pokemons[2].move1 = 0x7E;
 			
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -1078,17 +1078,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 20:
 		case 21:
 		{
-			display_message("ROCKSTAR WEEK");
+			show_message("ROCKSTAR WEEK");
 
 			int len = 3;
 			int dex_no[] = { 138,140,75 };
 			int levels[] = { 40,40,40 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -1099,17 +1099,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 27:
 		case 28:
 		{
-			display_message("PSYCH Week");
+			show_message("PSYCH Week");
 
 			int len = 5;
 			int dex_no[] = { 62,63,64,95,96 };
 			int levels[] = { 5,15,40,5,5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
@@ -1121,8 +1121,8 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			// from August 30 to September 30, 1997; September 13 to October 14, 1997.
 			
 
-			display_message("Surfing Pikachu CoroCoro Comic Special Event from August 30 to September 30");
-			display_message("Get your SURFING PIKACHU!");
+			show_message("Surfing Pikachu CoroCoro Comic Special Event from August 30 to September 30");
+			show_message("Get your SURFING PIKACHU!");
 
 			pokemon pikachu = generate_pk_from_base_table(24, 5);
 			pikachu.move3 = 0x39;
@@ -1152,17 +1152,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 6:
 		case 7:
 		{
-			display_message("YELLOW MISSING WEEK");
+			show_message("YELLOW MISSING WEEK");
 
 			int len = 6;
 			int dex_no[] = { 123,124,125,25,51,12 };
 			int levels[] = { 30,30,30,30,5,5,5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -1173,17 +1173,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("WATER TYPE WEEK");
+			show_message("WATER TYPE WEEK");
 
 			int len = 5;
 			int dex_no[] = { 6,117,119,130,54 };
 			int levels[] = { 5,5,5,5,30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -1198,8 +1198,8 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 			// This Pokmon was available in Japan
 			// from August 30 to September 30, 1997; September 13 to October 14, 1997.
 		
-			display_message("Surfing Pikachu CoroCoro Comic Special Event");
-			display_message("Get your SURFING PIKACHU!");
+			show_message("Surfing Pikachu CoroCoro Comic Special Event");
+			show_message("Get your SURFING PIKACHU!");
 
 			pokemon pikachu = generate_pk_from_base_table(24, 5);
 			pikachu.move3 = 0x39;
@@ -1217,25 +1217,25 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 27:
 		case 28:
 		{
-			display_message("NORMAL TYPE WEEK");
+			show_message("NORMAL TYPE WEEK");
 
 			int len = 4;
 			int dex_no[] = { 51,83,127,142 };
 			int levels[] = { 5,5,20,20 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		{
 
-			display_message("SOLAR BEAM VICTREEBEL DAYS");
-			display_message("Get your SOLAR BEAM VICTREEBEL!");
+			show_message("SOLAR BEAM VICTREEBEL DAYS");
+			show_message("Get your SOLAR BEAM VICTREEBEL!");
 
 			pokemon pikachu = generate_pk_from_base_table(70, 40);
 			pikachu.move4 = 0x4C;
@@ -1259,17 +1259,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 6:
 		case 7:
 		{
-			display_message("GROUND TYPE WEEK");
+			show_message("GROUND TYPE WEEK");
 
 			int len = 4;
 			int dex_no[] = { 110,50,33,30 };
 			int levels[] = { 5,26,30,30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -1280,17 +1280,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("POISON TYPE WEEK");
+			show_message("POISON TYPE WEEK");
 
 			int len = 4;
 			int dex_no[] = { 22,108,0,68 };
 			int levels[] = { 5,5,5,5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -1306,8 +1306,8 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		// from August 30 to September 30, 1997; September 13 to October 14, 1997.
 
 
-			display_message("Flying Pikachu CoroCoro Comic Special Event");
-			display_message("Get your FLYING PIKACHU!");
+			show_message("Flying Pikachu CoroCoro Comic Special Event");
+			show_message("Get your FLYING PIKACHU!");
 
 			pokemon pikachu = generate_pk_from_base_table(24, 5);
 			pikachu.move3 = 0x13;
@@ -1329,34 +1329,34 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 27:
 		case 28:
 		{
-			display_message("FLYING TYPE WEEK");
+			show_message("FLYING TYPE WEEK");
 
 			int len = 5;
 			int dex_no[] = { 17,141,21,11,82 };
 			int levels[] = { 36,5,2,10,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("HALLOWEEN GHOST SPECIAL");
+			show_message("HALLOWEEN GHOST SPECIAL");
 
 			int len = 3;
 			int dex_no[] = { 91,92,93 };
 			int levels[] = { 5,25,40};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		default:
@@ -1376,17 +1376,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 6:
 		case 7:
 		{
-			display_message("COZY WEEK");
+			show_message("COZY WEEK");
 
 			int len = 4;
 			int dex_no[] = { 142,78,79,35 };
 			int levels[] = { 15,5,37,5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -1397,17 +1397,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("RBY Starters Evolutions WEEK");
+			show_message("RBY Starters Evolutions WEEK");
 
 			int len = 3;
 			int dex_no[] = { 2,5,8 };
 			int levels[] = { 32,36,36 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -1418,13 +1418,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 20:
 		case 21:
 		{
-			display_message("RED Exclusives Week");
+			show_message("RED Exclusives Week");
 
 			int len = 5;
 			int dex_no[] = { 22,42,55,57,124 };
 			int levels[] = { 5, 5, 5,5,30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -1435,7 +1435,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -1446,13 +1446,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 27:
 		case 28:
 		{
-			display_message("BLUE Exclusives Week");
+			show_message("BLUE Exclusives Week");
 
 			int len = 5;
 			int dex_no[] = { 26,36,51,68,125 };
 			int levels[] = { 5, 5, 5,5,30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -1463,22 +1463,22 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		{
-			display_message("DRAGON DAYS");
+			show_message("DRAGON DAYS");
 
 			int len = 3;
 			int dex_no[] = { 146,147,149 };
 			int levels[] = { 5,30,55 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 31:
@@ -1499,13 +1499,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 6:
 		case 7:
 		{
-			display_message("Legendary Birds Week");
+			show_message("Legendary Birds Week");
 
 			int len = 3;
 			int dex_no[] = { 143, 144, 145 };
 			int levels[] = { 50, 50, 50 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
@@ -1516,7 +1516,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -1527,17 +1527,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 13:
 		case 14:
 		{
-			display_message("FIRE TYPE WEEK");
+			show_message("FIRE TYPE WEEK");
 
 			int len = 5;
 			int dex_no[] = { 125,58,3,36,76 };
 			int levels[] = { 30,30,5,5,5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -1548,17 +1548,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 20:
 		case 21:
 		{
-			display_message("ELECTRIC TYPE WEEK");
+			show_message("ELECTRIC TYPE WEEK");
 
 			int len = 3;
 			int dex_no[] = { 100,81,25 };
 			int levels[] = { 30,30,30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -1569,25 +1569,25 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock() {
 		case 27:
 		case 28:
 		{
-			display_message("FAIRY TYPE WEEK");
+			show_message("FAIRY TYPE WEEK");
 
 			int len = 5;
 			int dex_no[] = { 121,39,35,37,77 };
 			int levels[] = { 40,40,40,40,40 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("New YEARS MEW");
-			display_message("Get your MEW!");
+			show_message("New YEARS MEW");
+			show_message("Get your MEW!");
 
 			pokemon pikachu = generate_pk_from_base_table(150, 5);
 		
@@ -1625,13 +1625,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 6:
 		case 7:
 		{
-			display_message("Grass Type Week");
+			show_message("Grass Type Week");
 
 			int len = 5;
 			int dex_no[] = { 191,3,6 };
 			int levels[] = { 5,5,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -1643,7 +1643,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			}
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 
 
@@ -1656,13 +1656,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("Stadium Fighters Week");
+			show_message("Stadium Fighters Week");
 
 			int len = 2;
 			int dex_no[] = { 105,106 };
 			int levels[] = { 20,20 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -1674,7 +1674,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			}
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -1685,13 +1685,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 20:
 		case 21:
 		{
-			display_message("Stadium EEVEE WeekK");
+			show_message("Stadium EEVEE WeekK");
 
 			int len = 1;
 			int dex_no[] = { 132 };
 			int levels[] = { 25 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -1703,7 +1703,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			}
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -1714,13 +1714,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 27:
 		case 28:
 		{
-			display_message("Stadium Water WEEK");
+			show_message("Stadium Water WEEK");
 
 			int len = 2;
 			int dex_no[] = { 137,139 };
 			int levels[] = { 20, 20 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -1732,20 +1732,20 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			}
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("Stadium AMNESIA PSYDUCK Days");
+			show_message("Stadium AMNESIA PSYDUCK Days");
 
 			int len = 1;
 			int dex_no[] = { 53 };
 			int levels[] = { 15 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -1758,7 +1758,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 
 			DATA_BLOCK_gen2.pokemons[0].move2 = 0x85;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 
 		}
@@ -1779,17 +1779,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 6:
 		case 7:
 		{
-			display_message("FIGHT TYPE WEEK");
+			show_message("FIGHT TYPE WEEK");
 
 			int len = 5;
 			int dex_no[] = { 56,61,65,66,67 };
 			int levels[] = { 25,40,5,28,40 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -1800,13 +1800,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("Valentin's Weeks");
+			show_message("Valentin's Weeks");
 
 			int len = 2;
 			int dex_no[] = { 28,31 };
 			int levels[] = { 5, 5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -1820,7 +1820,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[0].move3 = 0x85;
 			DATA_BLOCK_gen2.pokemons[1].move3 = 0x85;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 
 		}
@@ -1832,13 +1832,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 20:
 		case 21:
 		{
-			display_message("Legendary Birds Week");
+			show_message("Legendary Birds Week");
 
 			int len = 3;
 			int dex_no[] = { 143, 144, 145 };
 			int levels[] = { 50, 50, 50 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -1849,7 +1849,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -1861,13 +1861,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 28:
 		case 29:
 		{
-			display_message("Rare Pokemon Week");
+			show_message("Rare Pokemon Week");
 
 			int len = 3;
 			int dex_no[] = { 142, 132, 136 };
 			int levels[] = { 5, 5, 5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -1883,7 +1883,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[2].move4 = 0x70;
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 30:
@@ -1905,13 +1905,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 6:
 		case 7:
 		{
-			display_message("Bug Type Week");
+			show_message("Bug Type Week");
 
 			int len = 2;
 			int dex_no[] = { 122, 126 };
 			int levels[] = { 5, 5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -1927,7 +1927,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -1938,13 +1938,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("RED Exclusives Week");
+			show_message("RED Exclusives Week");
 
 			int len = 5;
 			int dex_no[] = { 22,42,55,57,124 };
 			int levels[] = { 5, 5, 5,5,30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -1955,7 +1955,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -1966,13 +1966,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 20:
 		case 21:
 		{
-			display_message("BLUE Exclusives Week");
+			show_message("BLUE Exclusives Week");
 
 			int len = 5;
 			int dex_no[] = { 26,36,51,68,125 };
 			int levels[] = { 5, 5, 5,5,30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -1983,7 +1983,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -1994,13 +1994,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 27:
 		case 28:
 		{
-			display_message("Safari Week");
+			show_message("Safari Week");
 
 			int len = 5;
 			int dex_no[] = { 114,127,112,29,32 };
 			int levels[] = { 30, 5, 23,31,31 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2018,27 +2018,27 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[1].move3 = 0x62;
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("Psychic Jynx Days");
+			show_message("Psychic Jynx Days");
 
 			int len = 1;
 			int dex_no[] = { 123 };
 			int levels[] = { 5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
 			//modify default stats
 			DATA_BLOCK_gen2.pokemons[0].move3 = 0x5E;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		default:
@@ -2058,13 +2058,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 6:
 		case 7:
 		{
-			display_message("Team Brock Week");
+			show_message("Team Brock Week");
 
 			int len = 2;
 			int dex_no[] = { 73, 93 };
 			int levels[] = { 12, 14 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2075,7 +2075,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -2086,13 +2086,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("Team Misty Week");
+			show_message("Team Misty Week");
 
 			int len = 2;
 			int dex_no[] = { 119, 120 };
 			int levels[] = { 18, 21 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2103,7 +2103,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -2114,13 +2114,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 20:
 		case 21:
 		{
-			display_message("Team Lt. Surge Week");
+			show_message("Team Lt. Surge Week");
 
 			int len = 3;
 			int dex_no[] = { 99, 24, 25 };
 			int levels[] = { 21, 18, 24 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2131,7 +2131,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -2142,13 +2142,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 27:
 		case 28:
 		{
-			display_message("Team Erika Week");
+			show_message("Team Erika Week");
 
 			int len = 3;
 			int dex_no[] = { 70,113,44 };
 			int levels[] = { 29,24,29 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2159,19 +2159,19 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		{
-			display_message("Blizzard Lapras Days");
+			show_message("Blizzard Lapras Days");
 
 			int len = 1;
 			int dex_no[] = { 130 };
 			int levels[] = { 5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2179,7 +2179,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[0].move3 = 0x3B;
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 31:
@@ -2199,13 +2199,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 6:
 		case 7:
 		{
-			display_message("Team Koga Week");
+			show_message("Team Koga Week");
 
 			int len = 4;
 			int dex_no[] = { 108,108,88,109 };
 			int levels[] = { 37,37,39,43 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2216,7 +2216,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -2227,13 +2227,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("Team Sabrina Week");
+			show_message("Team Sabrina Week");
 
 			int len = 4;
 			int dex_no[] = { 63,111,48,64 };
 			int levels[] = { 38,37,38,43 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2244,7 +2244,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -2255,13 +2255,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 20:
 		case 21:
 		{
-			display_message("Team Blaine Week");
+			show_message("Team Blaine Week");
 
 			int len = 4;
 			int dex_no[] = { 57,76,77,58 };
 			int levels[] = { 42,40,42,47 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2272,7 +2272,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -2283,13 +2283,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 27:
 		case 28:
 		{
-			display_message("Team Giovanni Week");
+			show_message("Team Giovanni Week");
 
 			int len = 4;
 			int dex_no[] = { 57,76,77,58 };
 			int levels[] = { 42,40,42,47 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2300,27 +2300,27 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("Psychic Starmie Days");
+			show_message("Psychic Starmie Days");
 
 			int len = 1;
 			int dex_no[] = { 120 };
 			int levels[] = { 30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
 			//modify default stats
 			DATA_BLOCK_gen2.pokemons[0].move4 = 0x5E;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		default:
@@ -2340,13 +2340,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 7:
 		{
 
-			display_message("Team Lorelei Week");
+			show_message("Team Lorelei Week");
 
 			int len = 5;
 			int dex_no[] = { 86,90,79,123,130 };
 			int levels[] = { 54,43,54,56,56 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2357,7 +2357,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 
 		}
@@ -2369,13 +2369,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("Team Bruno Week");
+			show_message("Team Bruno Week");
 
 			int len = 5;
 			int dex_no[] = { 94,106,105,94,67 };
 			int levels[] = { 53,55,55,56,58 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2386,7 +2386,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -2397,13 +2397,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 20:
 		case 21:
 		{
-			display_message("Team Agatha Week");
+			show_message("Team Agatha Week");
 
 			int len = 5;
 			int dex_no[] = { 93,41,92,23,93 };
 			int levels[] = { 56,56,55,58,60 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2414,7 +2414,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -2425,13 +2425,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 27:
 		case 28:
 		{
-			display_message("Team Lance Week");
+			show_message("Team Lance Week");
 
 			int len = 5;
 			int dex_no[] = { 129,147,147,141,148 };
 			int levels[] = { 58,56,56,60,62 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2442,20 +2442,20 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				set_unint16_to_bytes2(std::rand(), DATA_BLOCK_gen2.pokemons[i].originalTrainerId);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("Fireblast Hyper Beam Ninetales Days");
+			show_message("Fireblast Hyper Beam Ninetales Days");
 
 			int len = 1;
 			int dex_no[] = { 37 };
 			int levels[] = { 40 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2463,7 +2463,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[0].move1 = 0x7E;
 			DATA_BLOCK_gen2.pokemons[0].move3 = 0x3F;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		default:
@@ -2483,13 +2483,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 6:
 		case 7:
 		{
-			display_message("University Magikarp Week");
+			show_message("University Magikarp Week");
 
 			int len = 1;
 			int dex_no[] = { 128 };
 			int levels[] = { 15 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2503,7 +2503,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			//modify default stats
 			DATA_BLOCK_gen2.pokemons[0].move2 = 0x52;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -2514,13 +2514,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("Tropical Promotion to Summer Festival 2");
+			show_message("Tropical Promotion to Summer Festival 2");
 
 			int len = 3;
 			int dex_no[] = { 53,71,130 };
 			int levels[] = { 5,5,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2536,7 +2536,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[2].move4 = 0x2C;
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -2547,13 +2547,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 20:
 		case 21:
 		{
-			display_message("ICE IN THE SUNSHINE WEEK");
+			show_message("ICE IN THE SUNSHINE WEEK");
 
 			int len = 4;
 			int dex_no[] = { 86,90,129,6 };
 			int levels[] = { 34,25,20,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2563,7 +2563,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[2].move3 = 0x3A;
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -2574,17 +2574,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 27:
 		case 28:
 		{
-			display_message("GRASS TYPE WEEK");
+			show_message("GRASS TYPE WEEK");
 
 			int len = 4;
 			int dex_no[] = { 113,2,44,102 };
 			int levels[] = { 5,32,32,32 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
@@ -2592,17 +2592,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 31:
 
 		{
-			display_message("Earthquake Rhydon Days");
+			show_message("Earthquake Rhydon Days");
 
 			int len = 1;
 			int dex_no[] = { 111 };
 			int levels[] = { 42 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		default:
@@ -2622,13 +2622,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 6:
 		case 7:
 		{
-			display_message("Pokemon Stamp Week");
+			show_message("Pokemon Stamp Week");
 
 			int len = 2;
 			int dex_no[] = { 21,77 };
 			int levels[] = { 25,40 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2643,7 +2643,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[0].move4 = 0x06;
 			DATA_BLOCK_gen2.pokemons[1].move4 = 0x06;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -2654,13 +2654,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("EEVEE EVOLUTION WEEK");
+			show_message("EEVEE EVOLUTION WEEK");
 
 			int len = 3;
 			int dex_no[] = { 133,134,135 };
 			int levels[] = { 20,20,20 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -2670,7 +2670,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[2].move1 = 0x7E;
 
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -2681,17 +2681,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 20:
 		case 21:
 		{
-			display_message("ROCKSTAR WEEK");
+			show_message("ROCKSTAR WEEK");
 
 			int len = 3;
 			int dex_no[] = { 138,140,75 };
 			int levels[] = { 40,40,40 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -2702,17 +2702,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 27:
 		case 28:
 		{
-			display_message("PSYCH Week");
+			show_message("PSYCH Week");
 
 			int len = 5;
 			int dex_no[] = { 62,63,64,95,96 };
 			int levels[] = { 5,15,40,5,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
@@ -2724,8 +2724,8 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			// from August 30 to September 30, 1997; September 13 to October 14, 1997.
 
 
-			display_message("Surfing Pikachu CoroCoro Comic Special Event from August 30 to September 30");
-			display_message("Get your SURFING PIKACHU!");
+			show_message("Surfing Pikachu CoroCoro Comic Special Event from August 30 to September 30");
+			show_message("Get your SURFING PIKACHU!");
 
 			pokemon pikachu = generate_pk_from_base_table(24, 5);
 			pikachu.move3 = 0x39;
@@ -2755,17 +2755,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 6:
 		case 7:
 		{
-			display_message("YELLOW MISSING WEEK");
+			show_message("YELLOW MISSING WEEK");
 
 			int len = 6;
 			int dex_no[] = { 123,124,125,25,51,12 };
 			int levels[] = { 30,30,30,30,5,5,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -2776,17 +2776,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("WATER TYPE WEEK");
+			show_message("WATER TYPE WEEK");
 
 			int len = 5;
 			int dex_no[] = { 6,117,119,130,54 };
 			int levels[] = { 5,5,5,5,30 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -2801,8 +2801,8 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			// This Pokmon was available in Japan
 			// from August 30 to September 30, 1997; September 13 to October 14, 1997.
 
-			display_message("Surfing Pikachu CoroCoro Comic Special Event");
-			display_message("Get your SURFING PIKACHU!");
+			show_message("Surfing Pikachu CoroCoro Comic Special Event");
+			show_message("Get your SURFING PIKACHU!");
 
 			pokemon pikachu = generate_pk_from_base_table(24, 5);
 			pikachu.move3 = 0x39;
@@ -2820,25 +2820,25 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 27:
 		case 28:
 		{
-			display_message("NORMAL TYPE WEEK");
+			show_message("NORMAL TYPE WEEK");
 
 			int len = 4;
 			int dex_no[] = { 51,83,127,142 };
 			int levels[] = { 5,5,20,20 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		{
 
-			display_message("SOLAR BEAM VICTREEBEL DAYS");
-			display_message("Get your SOLAR BEAM VICTREEBEL!");
+			show_message("SOLAR BEAM VICTREEBEL DAYS");
+			show_message("Get your SOLAR BEAM VICTREEBEL!");
 
 			pokemon pikachu = generate_pk_from_base_table(70, 40);
 			pikachu.move4 = 0x4C;
@@ -2862,13 +2862,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 6:
 		case 7:
 		{
-			display_message("Power Plant Pokemon Week");
+			show_message("Power Plant Pokemon Week");
 
 			int len = 4;
 			int dex_no[] = { 172,81,239,100 };
 			int levels[] = { 5,5,5,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 			DATA_BLOCK_gen2.pokemons[0].move3 = 0x92;
@@ -2876,7 +2876,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[2].move3 = 0x92;
 			DATA_BLOCK_gen2.pokemons[3].move2 = 0x61;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -2887,17 +2887,17 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("Celebi WEEK");
+			show_message("Celebi WEEK");
 
 			int len = 1;
 			int dex_no[] = { 251};
 			int levels[] = { 5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -2913,8 +2913,8 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		// from August 30 to September 30, 1997; September 13 to October 14, 1997.
 
 
-			display_message("Flying Pikachu CoroCoro Comic Special Event");
-			display_message("Get your FLYING PIKACHU!");
+			show_message("Flying Pikachu CoroCoro Comic Special Event");
+			show_message("Get your FLYING PIKACHU!");
 
 			pokemon pikachu = generate_pk_from_base_table(24, 5);
 			pikachu.move3 = 0x13;
@@ -2936,30 +2936,30 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 27:
 		case 28:
 		{
-			display_message("Suicune WEEK");
+			show_message("Suicune WEEK");
 
 			int len = 1;
 			int dex_no[] = { 240};
 			int levels[] = { 40};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("Scary Face Pokemon Week");
+			show_message("Scary Face Pokemon Week");
 
 			int len = 3;
 			int dex_no[] = { 173,174,183,172, 194 };
 			int levels[] = { 5,5,5,5,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 			DATA_BLOCK_gen2.pokemons[0].move4 = 0xB8; // Scary Face
@@ -2968,7 +2968,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[3].move3 = 0xB8;
 			DATA_BLOCK_gen2.pokemons[4].move3 = 0xB8;
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		default:
@@ -2988,13 +2988,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 6:
 		case 7:
 		{
-			display_message("Silver Cave Week");
+			show_message("Silver Cave Week");
 
 			int len = 5;
 			int dex_no[] = { 114,77,84,200,246 };
 			int levels[] = { 5,5,5,5,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 			DATA_BLOCK_gen2.pokemons[0].move3 = 0xEB; //Synthesis
@@ -3003,7 +3003,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[3].move3 = 0x5F; //Hypnosis
 			DATA_BLOCK_gen2.pokemons[4].move3 = 0x63; //Rage
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -3014,13 +3014,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("Union Cave Pokmon");
+			show_message("Union Cave Pokmon");
 
 			int len = 5;
 			int dex_no[] = { 120,98,95,118,131 };
 			int levels[] = { 5,5,5,5,5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 			DATA_BLOCK_gen2.pokemons[0].move3 = 0xEF; //Twister
@@ -3029,7 +3029,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[3].move3 = 0x0E; //Swords Dance
 			DATA_BLOCK_gen2.pokemons[3].move4 = 0xF8; //Future Sight
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -3040,13 +3040,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 20:
 		case 21:
 		{
-			display_message("Johto Legendary Week");
+			show_message("Johto Legendary Week");
 
 			int len = 5;
 			int dex_no[] = { 243,244,245,250,249 };
 			int levels[] = { 40, 40, 40,40,40 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -3056,7 +3056,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				make_pkm_in_slot_shiny(i);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -3067,33 +3067,33 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 27:
 		case 28:
 		{
-			display_message("Celebi Present SP");
+			show_message("Celebi Present SP");
 
 			int len = 2;
 			int dex_no[] = { 251, 151 };
 			int levels[] = { 5, 5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 			make_pkm_in_slot_shiny(1);
 		
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		{
-			display_message("DRAGON DAYS");
+			show_message("DRAGON DAYS");
 
 			int len = 3;
 			int dex_no[] = { 146,147,149 };
 			int levels[] = { 5,30,55 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 31:
@@ -3114,13 +3114,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 6:
 		case 7:
 		{
-			display_message("Psychic Type Pokmon Week");
+			show_message("Psychic Type Pokmon Week");
 
 			int len = 3;
 			int dex_no[] = { 63, 96, 102, 177, 122 };
 			int levels[] = { 5, 5, 5, 5, 5};
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 			DATA_BLOCK_gen2.pokemons[0].move2 = 0xC1; //Foresight
@@ -3129,7 +3129,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[3].move3 = 0xDB; //Safeguard
 			DATA_BLOCK_gen2.pokemons[4].move4 = 0xAA; //Mind Reader
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 8:
@@ -3140,13 +3140,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 13:
 		case 14:
 		{
-			display_message("The Johto Initial Three Pokmon Week");
+			show_message("The Johto Initial Three Pokmon Week");
 
 			int len = 5;
 			int dex_no[] = { 154,157,160,250,249 };
 			int levels[] = { 40,40,40,40,40 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 
@@ -3156,7 +3156,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 				make_pkm_in_slot_shiny(i);
 			}
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 15:
@@ -3167,13 +3167,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 20:
 		case 21:
 		{
-			display_message("Rock Tunnel Pokmon");
+			show_message("Rock Tunnel Pokmon");
 
 			int len = 6;
 			int dex_no[] = { 74,41,66,95,104,115 };
 			int levels[] = { 5,5,5,5,5,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 			DATA_BLOCK_gen2.pokemons[0].move2 = 0xE5; //Rapid Spin
@@ -3184,7 +3184,7 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[5].move4 = 0xB9; //Faint Attack
 			
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 22:
@@ -3195,13 +3195,13 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 		case 27:
 		case 28:
 		{
-			display_message("Ice Type Pokmon");
+			show_message("Ice Type Pokmon");
 
 			int len = 4;
 			int dex_no[] = { 225,86,131,220 };
 			int levels[] = { 5,5,5,5 };
 
-			event_pokemon_msg_str = "";
+			event_pokemon_msg[0] = '\0';
 
 			generate_pk_event_party_gen2(dex_no, levels, len);
 			DATA_BLOCK_gen2.pokemons[0].move2 = 0xBF; //Rapid Spin
@@ -3210,14 +3210,14 @@ void pokebuddy_gen1::add_event_pokemon_to_datablock_gen2() {
 			DATA_BLOCK_gen2.pokemons[3].move2 = 0x12; //Whirlwind
 		
 
-			display_message("Get your " + event_pokemon_msg_str + "!");
+			show_message("Get your %s!", event_pokemon_msg);
 			return;
 		}
 		case 29:
 		case 30:
 		case 31:
 		{
-			display_message("Pokmon that Appear at Night only Week");
+			show_message("Pokmon that Appear at Night only Week");
 
 			int len = 5;
 			int dex_no[] = { 163,198,200,215,120 };
@@ -3259,8 +3259,8 @@ void event_pokemon_stamp_august_1998_japan() {
 	//This Pokmon was available in Japan in August 1998.
 	
 
-	display_message("Pokemon Stamp Distribution Event August 1998 - JAPAN");
-	display_message("Get your PAY DAY FEAROW and PAY DAY RAPIDASH!");
+	show_message("Pokemon Stamp Distribution Event August 1998 - JAPAN");
+	show_message("Get your PAY DAY FEAROW and PAY DAY RAPIDASH!");
 
 	pokemon fearow = generate_pk_from_base_table(21, 25);
 	fearow.move4 = 0x06;
@@ -3283,8 +3283,8 @@ void event_pokemon_summer_1998_pokemon_battle_tour_pikachu(){
 	// from July 19 to August 23, 1998.
 	
 
-	display_message("Summer 1998 Pokmon Battle Tour Pikachu from July 19 to August 23");
-	display_message("Get your SURFING PIKACHU!");
+	show_message("Summer 1998 Pokmon Battle Tour Pikachu from July 19 to August 23");
+	show_message("Get your SURFING PIKACHU!");
 
 	pokemon pikachu = generate_pk_from_base_table(24, 5);
 	pikachu.move3 = 0x39;
@@ -3298,8 +3298,8 @@ void event_pokemon_n64_surfing_pikachu() {
 	//from September 21 to October 31, 1997.
 	
 
-	display_message("Nintendo 64 Surfing Pikachu 1997 - September 21 to October 31");
-	display_message("Get your SURFING PIKACHU!");
+	show_message("Nintendo 64 Surfing Pikachu 1997 - September 21 to October 31");
+	show_message("Get your SURFING PIKACHU!");
 
 	pokemon pikachu = generate_pk_from_base_table(24, 5);
 	pikachu.move3 = 0x39;
@@ -3312,8 +3312,8 @@ void event_pokemon_university_magikarp_july_1998_japan() {
 	//University Magikarp
 	//This Pokmon was available in Japan on July 1998.
 	
-	display_message("University Magikarp July 1998");
-	display_message("Get your DRAGON RAGE MAGIKARP!");
+	show_message("University Magikarp July 1998");
+	show_message("Get your DRAGON RAGE MAGIKARP!");
 
 	pokemon pkm = generate_pk_from_base_table(128, 15);
 	pkm.move2 = 0x52;
@@ -12,13 +12,7 @@ void pokebuddy_gen1::generate_pk_event_party(int* dex_no, int* levels, int len)
 		insert_pokemon_into_next_slot(pkm, pokemon_table[dex_no[i]].name);
 
 		//format event msg_string
-		if (len == 1) event_pokemon_msg_str = std::string(pokemon_table[dex_no[i]].name);
-		else {
-			if ((i < (len - 1))) {
-				event_pokemon_msg_str += std::string(pokemon_table[dex_no[i]].name) + ", ";
-			}
-			else event_pokemon_msg_str += " and " + std::string(pokemon_table[dex_no[i]].name);
-		}
+		append_event_name(pokemon_table[dex_no[i]].name, i, len);
 	}
 
 
@@ -175,13 +169,7 @@ void pokebuddy_gen1::generate_pk_event_party_gen2(int* dex_no, int* levels, int
 		insert_pokemon_into_next_slot_gen2(pkm, pokemon_table[dex_no[i]-1].name);
 
 		//format event msg_string
-		if (len == 1) event_pokemon_msg_str = std::string(pokemon_table[dex_no[i]-1].name);
-		else {
-			if ((i < (len - 1))) {
-				event_pokemon_msg_str += std::string(pokemon_table[dex_no[i]-1].name) + ", ";
-			}
-			else event_pokemon_msg_str += " and " + std::string(pokemon_table[dex_no[i]-1].name);
-		}
+		append_event_name(pokemon_table[dex_no[i]-1].name, i, len);
 	}
 
 
@@ -1,6 +1,10 @@
 #include <cmath>
 #include <string>
 #include <ctime>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+#include "../../../alloc_guard/include/alloc_guard.hpp"
 
 extern void display_message(std::string msg_str);
 
@@ -114,6 +118,40 @@ unsigned char pokebuddy_gen1::convert_TABLE2ASCII(unsigned char c) {
 	return 0xFF;
 }
 
+// out gets up to 10 characters and the terminator
+void pokebuddy_gen1::convert_name_to_chars(const unsigned char* name, char* out) {
+
+	int i = 0;
+	for (; i < 10 && name[i] != 0x50; i++)
+	{
+		out[i] = convert_TABLE2ASCII(name[i]);
+	}
+	out[i] = '\0';
+}
+
+// "A, B and C" for the event's party, built without allocating
+void pokebuddy_gen1::append_event_name(const char* name, int i, int len) {
+
+	if (i == 0) event_pokemon_msg[0] = '\0';
+	size_t used = strlen(event_pokemon_msg);
+	const char* separator = (i == 0) ? "" : (i < (len - 1) ? ", " : " and ");
+	snprintf(event_pokemon_msg + used, sizeof(event_pokemon_msg) - used, "%s%s", separator, name);
+}
+
+// display_message() takes a std::string: the text is formatted in a fixed
+// buffer and only the frontend call itself may allocate
+void pokebuddy_gen1::show_message(const char* fmt, ...) {
+
+	char msg[160];
+	va_list args;
+	va_start(args, fmt);
+	vsnprintf(msg, sizeof(msg), fmt, args);
+	va_end(args);
+
+	alloc_guard_exempt exempt;
+	display_message(msg);
+}
+
 std::string pokebuddy_gen1::convert_name_to_string(std::string str) {
 
 	int length = str.length() <= 10 ? str.length() : 10;
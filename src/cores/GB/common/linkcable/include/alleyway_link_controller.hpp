@@ -19,6 +19,7 @@ class alleyway_link_controller : public I_linkcable_target //, public I_dcgb_hot
 public:
 	alleyway_link_controller() {};
 	byte receive_from_linkcable(byte data) override;
+	bool calls_frontend() const override { return true; } // analog input
 	//void handle_special_hotkey(int key) override;
 
 private:
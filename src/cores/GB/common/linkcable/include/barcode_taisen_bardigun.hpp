@@ -39,6 +39,7 @@ class barcode_taisen_bardigun : public I_linkcable_target //, public I_dcgb_hotk
 public:
 	barcode_taisen_bardigun();
 	byte receive_from_linkcable(byte data) override;
+	bool calls_frontend() const override { return true; } // OSD messages from set_barcode()
 	void set_barcode();
 
 	//void handle_special_hotkey(int key) override;
@@ -4,17 +4,17 @@
 #include <string>
 
 
-//#include "../../../libretro/dcgb_hotkey_target.hpp"
+#include "../../../libretro/dcgb_hotkey_target.hpp"
 
 class barcodeboy :  public I_linkcable_target,
-					public link_master_device 
-					//public I_dcgb_hotkey_target
+					public link_master_device,
+					public I_dcgb_hotkey_target
 
 {
 	
 
 public:
-	barcodeboy(std::vector<gb*> g_gb, char cart_name[18]);
+	barcodeboy(const std::vector<gb*>& g_gb, char cart_name[18]);
 	bool is_in_mastermode; 
 	void init_barcodes(char cart_name[18]);
 	void process() override;
@@ -28,7 +28,7 @@ public:
 	
 	byte receive_from_linkcable(byte) override;
 
-	//void handle_special_hotkey(int key) override;
+	void handle_special_hotkey(int key) override;
 
 private:
 	int in_byte_counter; 
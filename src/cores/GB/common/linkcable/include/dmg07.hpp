@@ -41,7 +41,7 @@ class dmg07 : public link_master_device {
 	friend class cpu;
 public:
 
-	dmg07(std::vector<gb*> g_gb);
+	dmg07(const std::vector<gb*>& g_gb);
 
 	void process() override;
 	void reset() override;
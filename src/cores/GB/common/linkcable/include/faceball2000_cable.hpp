@@ -3,7 +3,7 @@
 class faceball2000_cable : public I_linkcable_target {
 
 public:
-	faceball2000_cable(std::vector<gb*> g_gb);
+	faceball2000_cable(const std::vector<gb*>& g_gb);
 	byte receive_from_linkcable(byte data) override;
 
 private:
@@ -3,7 +3,7 @@
 class game_and_watch_gallery_unlocker : public I_linkcable_target {
 
 public:
-	game_and_watch_gallery_unlocker(std::vector<gb*> g_gb);
+	game_and_watch_gallery_unlocker(const std::vector<gb*>& g_gb);
 	byte receive_from_linkcable(byte data) override;
 
 private:
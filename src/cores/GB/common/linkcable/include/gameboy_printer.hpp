@@ -1,5 +1,11 @@
 ﻿#pragma once
 #include <cores/GB/TGBDual/gb.h>
+#include "../../alloc_guard/include/alloc_guard.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
 #include <DoubleCherryEngine/Services/printer/include/printer_registry.hpp>
 
 
@@ -23,8 +29,10 @@ class gameboy_printer : public I_linkcable_target
 
 public:
 	gameboy_printer();
+	~gameboy_printer();
 
 	byte receive_from_linkcable(byte data) override;
+	bool calls_frontend() const override { return true; } // OSD messages
 
 
 private:
@@ -34,12 +42,30 @@ private:
 	void print_image();
 	void reset();
 
+	//Finished prints go to a worker thread: palette, exposure, scaling and encoding happen there
+	enum { PRINT_QUEUE_SIZE = 4 };
+
+	struct print_job {
+		std::vector<byte> pixels;	//2-bit indices, 160 per row
+		unsigned int height;
+		byte palette;
+		byte exposure;
+		bool new_image;
+	};
+
+	void decode_strip(const byte* tiles);
+	void queue_print(unsigned int height, byte palette, byte exposure, bool new_image);
+	void print_worker();
+	bool write_job(const print_job& job);
+	void report_prints();
 
 
 
-	std::vector <unsigned int> scanline_buffer, full_buffer, out_pixel_data;
+
+	std::vector <byte> strip_pixels;	//2-bit indices of the received strips
+	std::vector <unsigned int> full_buffer, out_pixel_data;	//full_buffer belongs to the worker
 	std::vector<RGB> rgb_buffer; 
-	std::vector <byte> packet_buffer;
+	std::vector <byte> packet_buffer, dot_data;
 	unsigned int packet_size;
 	printer_state current_state;
 
@@ -49,10 +75,18 @@ private:
 	word data_length;
 	word checksum;
 	byte status;
-	byte pal[4];
 
 	byte last_transfer; 
 
+	print_job jobs[PRINT_QUEUE_SIZE];
+	unsigned int job_head, job_count;
+	std::mutex job_lock;
+	std::condition_variable job_ready, job_space;
+	std::thread worker;
+	bool worker_quit;
+	std::atomic<unsigned int> prints_done, prints_failed;
+	unsigned int prints_reported, failures_reported;
+
 	//Default Gameboy BG palettes
 	unsigned int DMG_BG_PAL[4] = { 0xFFFFFFFF, 0xFFC0C0C0, 0xFF606060, 0xFF000000 };
 };
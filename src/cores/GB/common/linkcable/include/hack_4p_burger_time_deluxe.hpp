@@ -15,7 +15,7 @@ class hack_4p_burger_time_deluxe : public link_master_device {
 	friend class cpu;
 public:
 
-	hack_4p_burger_time_deluxe(std::vector<gb*> g_gb);
+	hack_4p_burger_time_deluxe(const std::vector<gb*>& g_gb);
 
 	void process();
 	bool is_ready_to_process();
@@ -33,7 +33,6 @@ private:
 	void init_send_data_queue();
 	void clear_data_for_next_round();
 
-	void get_all_SC_reg_data();
 	void get_all_SB_reg_data();
 	bool is_expected_data(byte data);
 	bool all_IE_are_handled();
@@ -29,7 +29,7 @@ extern bool logging_allowed;
 class hack_4p_kwirk : public I_linkcable_target {
 
 public:
-	hack_4p_kwirk(std::vector<gb*> g_gb);
+	hack_4p_kwirk(const std::vector<gb*>& g_gb);
 
 	//I_link_target
 	byte receive_from_linkcable(byte data) override;
@@ -50,7 +50,6 @@ public:
 
 private:
 	void get_all_SB_reg_data() ;
-	void get_all_SC_reg_data();
 	void redirect_data(byte data);
 
 
@@ -67,6 +66,7 @@ private:
 	void log_traffic(byte id, byte b);
 
 	std::vector<gb*> v_gb;
+	link_readiness ready;
 	byte in_data_buffer[16] = { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 };
 	int master_id; 
 	ingame_state current_state; 
@@ -90,10 +90,11 @@ class hack_4p_tetris : public link_master_device {
 	friend class cpu;
 public:
 
-	hack_4p_tetris(std::vector<gb*> g_gb);
+	hack_4p_tetris(const std::vector<gb*>& g_gb);
 
 	void process() override;
 	void reset() override;
+	bool calls_frontend() const override { return true; } // OSD messages
 	
 	void save_state_mem(void* buf) override;
 	void restore_state_mem(void* buf) override;
@@ -113,11 +114,6 @@ private:
 	void generate_falling_blocks();
 	void hard_reset();
 	/*
-	void get_all_SC_reg_data();
-	void get_all_SB_reg_data();
-	bool is_expected_data(byte data);
-	bool all_IE_are_handled();
-
 	void broadcast_byte(byte data);
 	void send_byte(byte which, byte data);
 	*/
@@ -16,7 +16,10 @@ public:
 		byte tmp[16] = { 0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0 };
 		memcpy(in_data_buffer, tmp, sizeof in_data_buffer);
 		use_v_gb_size = false;
+		ready_ports = 0;
+		ready_count = 0;
 	}
+	virtual ~link_master_device();
 	virtual void process() = 0;
 	virtual void reset() = 0;
 
@@ -28,6 +31,15 @@ public:
 	*/
 
 	size_t get_state_size() override;
+
+	// the instances this device drives, see link_topology::add_master
+	const std::vector<gb*>& get_gbs() const { return v_gb; }
+	// a device made of independent masters (dmg07x4) hands out the parts,
+	// so link_scheduler can process each in its own component
+	virtual void get_parts(std::vector<link_master_device*>& parts) { parts.push_back(this); }
+	// true when process() calls the frontend (messages, input), so
+	// link_scheduler keeps the component on the calling thread
+	virtual bool calls_frontend() const { return false; }
 	
 	int transfer_speed;
 	int seri_occer;
@@ -47,11 +59,17 @@ protected:
 
 	
 	//helper functions
-	void get_all_SC_reg_data();
 	void get_all_SB_reg_data();
 	bool is_expected_data(byte data);
 	bool all_IE_are_handled();
 
+	// the connected gbs publish SC/IF/IE here (see link_readiness), so
+	// gbs_are_ready_to_process() and all_IE_are_handled() are a mask test
+	uint32_t connected_ports();
+	link_readiness ready;
+	uint32_t ready_ports;
+	int ready_count;
+
 	
 	std::vector<gb*> v_gb;
 	
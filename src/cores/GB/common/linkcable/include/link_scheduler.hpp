@@ -0,0 +1,98 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Per component frame scheduler
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#pragma once
+#include "link_topology.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// Runs a frame the way TGBDualCore::run() does (every instance one line, then
+// the link masters, 154 times) but separately for every connected component
+// of the link topology. Components share no emulated state, so they run on
+// worker threads without any synchronisation inside the frame, and the result
+// is the same as running them one after another. Only instances in the same
+// component pay for the per line lockstep.
+//
+// The frontend is only called from the calling thread: dmy_renderer keeps each
+// instance's audio and frame until TGBDualCore::run() flushes them after
+// run_frame(), and gb_movie latches the pads before it. Devices that call the
+// frontend themselves (messages, analog input; see calls_frontend()) and IR
+// master devices keep their components on the calling thread, which runs them
+// before it helps with the rest. Pure link masters such as dmg07 do not.
+//
+// configure() also adds the wiring it can see (link_topology::add_wiring and
+// every master's instances), so a missing edge can never split instances
+// that actually talk to each other.
+//
+// The two ends of an ir_async_link stay in separate components and are only
+// held within the link's skew of each other. That needs a thread per
+// component; with fewer threads both ends run in one component instead,
+// which gives the same result.
+class ir_async_link;
+
+class link_scheduler
+{
+public:
+	link_scheduler();
+	~link_scheduler();
+
+	// threads <= 0: one per component, up to the hardware thread count
+	// ir_links: every ir_async_link between the gbs, configure() again before deleting one
+	void configure(const link_topology& topology, const std::vector<gb*>& gbs, link_master_device* master, int threads = 0,
+		const std::vector<ir_async_link*>& ir_links = std::vector<ir_async_link*>());
+	void run_frame(int lines = 154);
+
+	int get_component_count() const { return (int)components.size(); }
+	int get_thread_count() const { return (int)workers.size() + 1; }
+
+private:
+	struct ir_end {
+		ir_async_link* link;
+		int side;
+	};
+
+	struct component {
+		std::vector<gb*> gbs;
+		std::vector<link_master_device*> masters;
+		std::vector<ir_end> ir_ends;
+	};
+
+	void run_component(component& c, int lines);
+	void run_pending();
+	void worker_main(unsigned seen);
+	void stop_workers();
+
+	std::vector<component> components;
+	std::vector<ir_async_link*> ir_links;
+	bool one_each; // 各スレッドが成分をひとつだけ走らせる // every thread runs a single component
+	size_t caller_components; // 先頭から、呼び出し側だけが走らせる成分 // leading components only the calling thread runs
+	std::vector<std::thread> workers;
+
+	std::mutex lock;
+	std::condition_variable wake, done;
+	unsigned generation;
+	bool quit;
+	int frame_lines;
+	std::atomic<size_t> next_component;
+	size_t finished;
+};
@@ -0,0 +1,82 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Link topology
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#pragma once
+#include <cores/GB/TGBDual/gb.h>
+#include <vector>
+
+class link_master_device;
+
+enum link_kind
+{
+	LINK_CABLE,    // two instances, serial port to serial port
+	LINK_DMG07,    // up to four instances on one four player adapter
+	LINK_IR,       // two instances facing each other
+	LINK_PRINTER,  // one instance and a printer
+	LINK_BRIDGE,   // one instance and a network peer
+	LINK_DEVICE,   // instances sharing any other link device (4p hacks, ...)
+};
+
+struct link_edge {
+	link_kind kind;
+	std::vector<int> ports;  // instance indices, in port order
+};
+
+// Which instance is wired to which, as a list of edges over instance indices.
+// Edges may connect any number of ports (a DMG-07 has four); a printer or a
+// network bridge is an edge with a single port, its peer is outside the session.
+// Instances in different connected components never talk to each other, so
+// link_scheduler runs every component on its own thread.
+class link_topology
+{
+public:
+	link_topology(int instances = 0) { this->instances = instances; }
+
+	void set_instances(int instances) { this->instances = instances; }
+	int get_instances() const { return instances; }
+	void clear() { edges.clear(); }
+
+	// return the edge index, or -1 if a port is out of range
+	int add(link_kind kind, const std::vector<int>& ports);
+	int add_cable(int a, int b) { return add(LINK_CABLE, { a, b }); }
+	int add_ir(int a, int b) { return add(LINK_IR, { a, b }); }
+	int add_dmg07(const std::vector<int>& ports) { return add(LINK_DMG07, ports); }
+	int add_printer(int port) { return add(LINK_PRINTER, { port }); }
+	int add_bridge(int port) { return add(LINK_BRIDGE, { port }); }
+
+	// edges implied by what is actually wired: gb::set_target pairs, a device
+	// that several gbs point at, and every instance a master device drives
+	void add_wiring(const std::vector<gb*>& gbs);
+	void add_master(const std::vector<gb*>& gbs, link_master_device* master);
+
+	const std::vector<link_edge>& get_edges() const { return edges; }
+
+	// connected components, each sorted, ordered by their lowest instance
+	std::vector<std::vector<int>> components() const;
+
+	// instances on each adapter of the 4x DMG-07 setup for 'players'
+	static std::vector<std::vector<int>> dmg07_groups(int players);
+
+private:
+	int index_of(const std::vector<gb*>& gbs, const gb* g) const;
+
+	int instances;
+	std::vector<link_edge> edges;
+};
@@ -26,7 +26,7 @@
 #include "PKBuddy/poke_data.h"
 
 
-//#include "../../../libretro/dcgb_hotkey_target.hpp"
+#include "../../../libretro/dcgb_hotkey_target.hpp"
 
 
 extern bool logging_allowed;
@@ -39,16 +39,17 @@ enum pkm_generation {
 
 
 class pokebuddy_gen1 : public I_linkcable_target
-	//, public I_dcgb_hotkey_target
+	, public I_dcgb_hotkey_target
 	, public I_savestate {
 
 public:
-	pokebuddy_gen1(std::vector<gb*> gbs);
+	pokebuddy_gen1(const std::vector<gb*>& gbs);
 
 	byte receive_from_linkcable(byte data) override;
+	bool calls_frontend() const override { return true; } // OSD messages
 	void reset();
 
-	//void handle_special_hotkey(int key) override;
+	void handle_special_hotkey(int key) override;
 
 	enum ingame_state
 	{
@@ -98,6 +99,9 @@ private:
 	std::string convert_string_to_name(std::string str, bool toUpper);
 	unsigned char convert_TABLE2ASCII(unsigned char c);
 	std::string convert_name_to_string(std::string str);
+	void convert_name_to_chars(const unsigned char* name, char* out);
+	void append_event_name(const char* name, int i, int len);
+	void show_message(const char* fmt, ...);
 	void set_unint32_to_bytes3(int input, unsigned char* output_array);
 	void set_unint16_to_bytes2(int input, unsigned char* output_array);
 	unsigned int bytes3_to_uint32(unsigned char* output_array);
@@ -124,7 +128,7 @@ private:
 
 
 	std::vector<gb*> v_gb;
-	std::string event_pokemon_msg_str; 
+	char event_pokemon_msg[128]; // "A, B and C" of the current event
 	pkm_generation generation = GEN_1;
 
 	bool gen2_trade_confirmed = false; 
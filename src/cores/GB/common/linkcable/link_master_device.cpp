@@ -84,28 +84,38 @@ size_t link_master_device::get_state_size(void)
 //but helpful to get a hack working 
 
 
-bool link_master_device::all_IE_are_handled()
+// 'ready' detaches the gbs that are still attached, so the gbs may already be gone here
+link_master_device::~link_master_device()
 {
-	int connected_gbs = use_v_gb_size ? v_gb.size() : emulated_gbs; 
-
-	for (int i = 0; i < connected_gbs; i++)
-	{
-		if ((v_gb[i]->get_regs()->IF & v_gb[i]->get_regs()->IE & INT_SERIAL)) return false;
-	}
-	return true;
-
 }
 
-void link_master_device::get_all_SC_reg_data()
+// 初めて使う時に gb をポートとしてつなぐ (派生クラスのコンストラクタで v_gb が決まった後)
+// attaches the gbs on first use, once the derived constructor has filled v_gb
+uint32_t link_master_device::connected_ports()
 {
 	int connected_gbs = use_v_gb_size ? v_gb.size() : emulated_gbs;
-
+	if (connected_gbs > (int)v_gb.size())
+		connected_gbs = (int)v_gb.size();
+	if (connected_gbs > 32)
+		connected_gbs = 32;
+	if (connected_gbs == ready_count)
+		return ready_count >= 32 ? 0xFFFFFFFFu : (1u << ready_count) - 1;
+
+	uint32_t ports = connected_gbs >= 32 ? 0xFFFFFFFFu : (1u << connected_gbs) - 1;
 	for (int i = 0; i < connected_gbs; i++)
 	{
-		byte data = v_gb[i]->get_regs()->SC;
-		in_data_buffer[i] = data;
+		if (!(ready_ports & (1u << i)))
+			v_gb[i]->set_link_readiness(&ready, i);
 	}
-};
+	ready_ports |= ports;
+	ready_count = connected_gbs;
+	return ports;
+}
+
+bool link_master_device::all_IE_are_handled()
+{
+	return !(ready.get_pending() & connected_ports());
+}
 
 void link_master_device::get_all_SB_reg_data()
 {
@@ -131,6 +141,5 @@ bool link_master_device::is_expected_data(byte data)
 
 bool link_master_device::gbs_are_ready_to_process() {
 
-	get_all_SC_reg_data();
-	return is_expected_data(0x80) && all_IE_are_handled();
+	return ready.all_ready(connected_ports());
 }
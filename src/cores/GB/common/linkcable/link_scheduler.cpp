@@ -0,0 +1,315 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Per component frame scheduler
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "./include/link_scheduler.hpp"
+#include "./include/link_master_device.hpp"
+#include "../infrared/include/ir_async_link.hpp"
+#include "../alloc_guard/include/alloc_guard.hpp"
+
+#include <algorithm>
+
+link_scheduler::link_scheduler()
+{
+	generation = 0;
+	quit = false;
+	frame_lines = 0;
+	one_each = false;
+	caller_components = 0;
+	next_component = 0;
+	finished = 0;
+}
+
+link_scheduler::~link_scheduler()
+{
+	stop_workers();
+}
+
+void link_scheduler::stop_workers()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		quit = true;
+	}
+	wake.notify_all();
+	for (size_t i = 0; i < workers.size(); i++)
+		workers[i].join();
+	workers.clear();
+	quit = false;
+}
+
+void link_scheduler::configure(const link_topology& topology, const std::vector<gb*>& gbs, link_master_device* master, int threads,
+	const std::vector<ir_async_link*>& ir_links)
+{
+	stop_workers();
+	components.clear();
+	this->ir_links = ir_links;
+
+	link_topology wired = topology;
+	wired.set_instances((int)gbs.size());
+	wired.add_wiring(gbs);
+
+	std::vector<link_master_device*> parts;
+	if (master)
+		master->get_parts(parts);
+	for (size_t i = 0; i < parts.size(); i++)
+		wired.add_master(gbs, parts[i]);
+
+	if (threads <= 0)
+	{
+		threads = (int)std::thread::hardware_concurrency();
+		if (threads <= 0)
+			threads = 1;
+	}
+
+	// フロントエンドを呼ぶ機器 (メッセージ、入力) を持つ成分は呼び出し側のスレッドで走らせる
+	// a component holding a device that calls the frontend (messages, input) runs on the calling thread:
+	// link masters and link cable targets that say so, and IR master devices other than the ports of an
+	// ir_async_link. Pure link masters such as dmg07 leave their component to the workers
+	std::vector<bool> calls_frontend(gbs.size(), false);
+	for (size_t g = 0; g < gbs.size(); g++)
+	{
+		I_linkcable_target* target = gbs[g]->get_linked_target();
+		if (target && target->calls_frontend())
+			calls_frontend[g] = true;
+	}
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		if (!parts[i]->calls_frontend())
+			continue;
+		const std::vector<gb*>& driven = parts[i]->get_gbs();
+		for (size_t g = 0; g < gbs.size(); g++)
+		{
+			if (std::find(driven.begin(), driven.end(), gbs[g]) != driven.end())
+				calls_frontend[g] = true;
+		}
+	}
+	for (size_t g = 0; g < gbs.size(); g++)
+	{
+		bool async_end = false;
+		for (size_t l = 0; l < ir_links.size(); l++)
+			async_end |= ir_links[l]->get_gb(0) == gbs[g] || ir_links[l]->get_gb(1) == gbs[g];
+		if (gbs[g]->get_ir_master_device() && !async_end)
+			calls_frontend[g] = true;
+	}
+
+	std::vector<std::vector<int>> groups = wired.components();
+	std::vector<bool> group_on_caller(groups.size(), false);
+	std::vector<int> group_of(gbs.size(), 0);
+	int on_caller = 0;
+	for (size_t c = 0; c < groups.size(); c++)
+	{
+		for (size_t i = 0; i < groups[c].size(); i++)
+		{
+			group_of[groups[c][i]] = (int)c;
+			if (calls_frontend[groups[c][i]])
+				group_on_caller[c] = true;
+		}
+		on_caller += group_on_caller[c];
+	}
+
+	// 非同期 IR の両端が同時に動けないなら、ひとつの成分にまとめてライン毎に交互に動かす。
+	// 呼び出し側は自分の成分を順番に走らせるので、両端ともそこにあるときもまとめる
+	// when both ends of an async IR link cannot run at the same time, put them in one component.
+	// That is the case without a thread for every other component, and when both ends
+	// sit on the calling thread, which runs its components one after another.
+	int needed = (int)groups.size() - (on_caller > 1 ? on_caller - 1 : 0);
+	if (!ir_links.empty())
+	{
+		for (size_t l = 0; l < ir_links.size(); l++)
+		{
+			int ends[2] = { -1, -1 };
+			for (size_t g = 0; g < gbs.size(); g++)
+			{
+				for (int side = 0; side < 2; side++)
+				{
+					if (gbs[g] == ir_links[l]->get_gb(side))
+						ends[side] = (int)g;
+				}
+			}
+			if (ends[0] >= 0 && ends[1] >= 0 &&
+				(needed > threads || (group_on_caller[group_of[ends[0]]] && group_on_caller[group_of[ends[1]]])))
+				wired.add_ir(ends[0], ends[1]);
+		}
+		groups = wired.components();
+	}
+
+	// 呼び出し側の成分を先頭に並べる // the calling thread's components go first
+	caller_components = std::stable_partition(groups.begin(), groups.end(), [&](const std::vector<int>& group) {
+		for (size_t i = 0; i < group.size(); i++)
+		{
+			if (calls_frontend[group[i]])
+				return true;
+		}
+		return false;
+	}) - groups.begin();
+
+	std::vector<int> component_of(gbs.size(), 0);
+	for (size_t c = 0; c < groups.size(); c++)
+	{
+		component comp;
+		for (size_t i = 0; i < groups[c].size(); i++)
+		{
+			comp.gbs.push_back(gbs[groups[c][i]]);
+			component_of[groups[c][i]] = (int)c;
+		}
+		components.push_back(comp);
+	}
+
+	// マスターは最初につないだインスタンスの成分で動かす (add_master で全部同じ成分になっている)
+	// a master runs in the component of its first instance, add_master put all of them there
+	for (size_t i = 0; i < parts.size(); i++)
+	{
+		int c = 0;
+		const std::vector<gb*>& driven = parts[i]->get_gbs();
+		for (size_t g = 0; g < gbs.size(); g++)
+		{
+			if (!driven.empty() && gbs[g] == driven[0])
+				c = component_of[g];
+		}
+		if (!components.empty())
+			components[c].masters.push_back(parts[i]);
+	}
+
+	one_each = false;
+	for (size_t l = 0; l < ir_links.size(); l++)
+	{
+		ir_links[l]->set_paced(true);
+		int ends[2] = { -1, -1 };
+		for (int side = 0; side < 2; side++)
+		{
+			for (size_t g = 0; g < gbs.size(); g++)
+			{
+				if (gbs[g] == ir_links[l]->get_gb(side))
+				{
+					components[component_of[g]].ir_ends.push_back({ ir_links[l], side });
+					ends[side] = component_of[g];
+				}
+			}
+		}
+		// 両端が別々の成分: 一方を走らせ切ってからもう一方、とはできない
+		// ends in different components: one cannot run to the end of the frame before the other starts
+		if (ends[0] >= 0 && ends[1] >= 0 && ends[0] != ends[1])
+			one_each = true;
+	}
+
+	// 呼び出し側のスレッドも 1 本として数える。自分の成分があれば、ワーカーは残りの成分の数まで
+	// the calling thread counts as one of them; when it has components of its own, it
+	// takes the others only after those, so workers go up to the number of the others
+	size_t others = components.size() - caller_components;
+	int worker_count = threads - 1;
+	if (worker_count > (int)others - (caller_components ? 0 : 1))
+		worker_count = (int)others - (caller_components ? 0 : 1);
+
+	// 世代はここで渡す、起動が遅れても最初のフレームを見逃さない // pass the generation here so a late start cannot miss the first frame
+	for (int i = 0; i < worker_count; i++)
+		workers.emplace_back(&link_scheduler::worker_main, this, generation);
+}
+
+void link_scheduler::run_component(component& c, int lines)
+{
+	for (int line = 0; line < lines; line++)
+	{
+		for (size_t i = 0; i < c.gbs.size(); i++)
+			c.gbs[i]->run();
+
+		if (!c.masters.empty())
+		{
+			// the link time is booked on the component's first instance
+			STAT_TIMER(c.gbs[0], STAT_TIME_LINK_PROCESS);
+			for (size_t i = 0; i < c.masters.size(); i++)
+				c.masters[i]->process();
+		}
+
+		for (size_t i = 0; i < c.ir_ends.size(); i++)
+			c.ir_ends[i].link->line_done(c.ir_ends[i].side);
+	}
+}
+
+void link_scheduler::run_pending()
+{
+	size_t count = 0;
+	for (size_t i; (i = next_component.fetch_add(1)) < components.size();)
+	{
+		run_component(components[i], frame_lines);
+		count++;
+		if (one_each)
+			break;
+	}
+
+	if (count)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		finished += count;
+		if (finished == components.size())
+			done.notify_one();
+	}
+}
+
+void link_scheduler::worker_main(unsigned seen)
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> guard(lock);
+			wake.wait(guard, [&]() { return quit || generation != seen; });
+			if (quit)
+				return;
+			seen = generation;
+		}
+		// retro_run の guard は呼び出し側のスレッドしか数えない // the retro_run guard only counts the calling thread
+		alloc_guard guard("link_scheduler worker");
+		run_pending();
+	}
+}
+
+void link_scheduler::run_frame(int lines)
+{
+	for (size_t i = 0; i < ir_links.size(); i++)
+		ir_links[i]->begin_frame();
+
+	if (workers.empty())
+	{
+		for (size_t i = 0; i < components.size(); i++)
+			run_component(components[i], lines);
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		frame_lines = lines;
+		finished = 0;
+		next_component = caller_components;
+		generation++;
+	}
+	wake.notify_all();
+
+	for (size_t i = 0; i < caller_components; i++)
+		run_component(components[i], lines);
+	if (caller_components)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+		finished += caller_components;
+	}
+
+	run_pending();
+
+	std::unique_lock<std::mutex> guard(lock);
+	done.wait(guard, [&]() { return finished == components.size(); });
+}
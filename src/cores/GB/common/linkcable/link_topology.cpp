@@ -0,0 +1,152 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   Link topology
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "./include/link_topology.hpp"
+#include "./include/link_master_device.hpp"
+
+int link_topology::add(link_kind kind, const std::vector<int>& ports)
+{
+	for (size_t i = 0; i < ports.size(); i++)
+	{
+		if (ports[i] < 0 || ports[i] >= instances)
+			return -1;
+	}
+	link_edge e;
+	e.kind = kind;
+	e.ports = ports;
+	edges.push_back(e);
+	return (int)edges.size() - 1;
+}
+
+int link_topology::index_of(const std::vector<gb*>& gbs, const gb* g) const
+{
+	for (size_t i = 0; i < gbs.size() && (int)i < instances; i++)
+	{
+		if (gbs[i] == g)
+			return (int)i;
+	}
+	return -1;
+}
+
+void link_topology::add_wiring(const std::vector<gb*>& gbs)
+{
+	int count = (int)gbs.size() < instances ? (int)gbs.size() : instances;
+
+	for (int i = 0; i < count; i++)
+	{
+		I_linkcable_target* cable = gbs[i]->get_linked_target();
+		I_ir_target* ir = gbs[i]->get_ir_target();
+
+		for (int j = 0; j < count; j++)
+		{
+			if (j == i)
+				continue;
+			if (cable && cable == static_cast<I_linkcable_target*>(gbs[j]))
+				add_cable(i, j);
+			if (ir && ir == static_cast<I_ir_target*>(gbs[j]))
+				add_ir(i, j);
+			// 同じデバイスにつながっている // both talk to the same device
+			if (j > i && cable && cable == gbs[j]->get_linked_target())
+				add(LINK_DEVICE, { i, j });
+			if (j > i && ir && ir == gbs[j]->get_ir_target())
+				add(LINK_DEVICE, { i, j });
+		}
+	}
+}
+
+void link_topology::add_master(const std::vector<gb*>& gbs, link_master_device* master)
+{
+	std::vector<int> ports;
+	const std::vector<gb*>& driven = master->get_gbs();
+	for (size_t i = 0; i < driven.size(); i++)
+	{
+		int port = index_of(gbs, driven[i]);
+		if (port >= 0)
+			ports.push_back(port);
+	}
+	if (!ports.empty())
+		add(LINK_DEVICE, ports);
+}
+
+std::vector<std::vector<int>> link_topology::components() const
+{
+	std::vector<int> parent(instances);
+	for (int i = 0; i < instances; i++)
+		parent[i] = i;
+
+	auto find = [&parent](int x) {
+		while (parent[x] != x)
+			x = parent[x] = parent[parent[x]];
+		return x;
+	};
+
+	// 小さい番号を根にするので、成分は先頭のインスタンス順に並ぶ
+	// the lower index becomes the root, so components come out ordered by their first instance
+	for (size_t e = 0; e < edges.size(); e++)
+	{
+		const std::vector<int>& ports = edges[e].ports;
+		for (size_t p = 1; p < ports.size(); p++)
+		{
+			int a = find(ports[0]), b = find(ports[p]);
+			if (a < b)
+				parent[b] = a;
+			else if (b < a)
+				parent[a] = b;
+		}
+	}
+
+	std::vector<std::vector<int>> result;
+	std::vector<int> slot(instances, -1);
+	for (int i = 0; i < instances; i++)
+	{
+		int root = find(i);
+		if (slot[root] < 0)
+		{
+			slot[root] = (int)result.size();
+			result.push_back(std::vector<int>());
+		}
+		result[slot[root]].push_back(i);
+	}
+	return result;
+}
+
+std::vector<std::vector<int>> link_topology::dmg07_groups(int players)
+{
+	// 1 台に最大 4 人、台数は最低 2。5 人未満でも 3/2 で組む (従来どおり)
+	// at most four per adapter and at least two adapters; fewer than five players still wire up 3/2
+	if (players < 5)
+		players = 5;
+	if (players > 16)
+		players = 16;
+
+	int hubs = (players + 3) / 4;
+	if (hubs < 2)
+		hubs = 2;
+
+	std::vector<std::vector<int>> groups(hubs);
+	int next = 0;
+	for (int h = 0; h < hubs; h++)
+	{
+		int size = players / hubs + (h < players % hubs ? 1 : 0);
+		for (int i = 0; i < size; i++)
+			groups[h].push_back(next++);
+	}
+	return groups;
+}
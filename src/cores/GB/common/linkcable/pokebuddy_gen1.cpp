@@ -26,9 +26,10 @@
 
 
 
-pokebuddy_gen1::pokebuddy_gen1(std::vector<gb*> gbs) {
+pokebuddy_gen1::pokebuddy_gen1(const std::vector<gb*>& gbs) {
   
 	v_gb.insert(v_gb.begin(), std::begin(gbs), std::end(gbs));
+	event_pokemon_msg[0] = '\0';
 
 	reset();
 }
@@ -67,9 +68,9 @@ void pokebuddy_gen1::handle_special_hotkey(int key) {
 		case 0x10:
 		{
 			pkbuddy_selected_index = (++pkbuddy_selected_index % DATA_BLOCK.species_list_size);
-			std::string nick_name = convert_name_to_string(std::string((const char*)DATA_BLOCK.nicknames[pkbuddy_selected_index]));
-			std::string msg_str = "PKBuddy will trade " + nick_name;
-			display_message(msg_str);
+			char nick_name[11];
+			convert_name_to_chars(DATA_BLOCK.nicknames[pkbuddy_selected_index], nick_name);
+			show_message("PKBuddy will trade %s", nick_name);
 			return;
 		}
 		//START BUTTON
@@ -86,9 +87,9 @@ void pokebuddy_gen1::handle_special_hotkey(int key) {
 		if (key < 10)
 		{
 			pkbuddy_selected_index = (key - 1);
-			std::string nick_name = convert_name_to_string(std::string((const char*)DATA_BLOCK.nicknames[key - 1]));
-			std::string msg_str = "PKBuddy will trade " + nick_name;
-			display_message(msg_str);
+			char nick_name[11];
+			convert_name_to_chars(DATA_BLOCK.nicknames[key - 1], nick_name);
+			show_message("PKBuddy will trade %s", nick_name);
 			return;
 		}
 	}
@@ -100,9 +101,9 @@ void pokebuddy_gen1::handle_special_hotkey(int key) {
 		case 0x10:
 		{
 			pkbuddy_selected_index = (++pkbuddy_selected_index % DATA_BLOCK_gen2.species_list_size);
-			std::string nick_name = convert_name_to_string(std::string((const char*)DATA_BLOCK_gen2.nicknames[pkbuddy_selected_index]));
-			std::string msg_str = "PKBuddy will trade " + nick_name;
-			display_message(msg_str);
+			char nick_name[11];
+			convert_name_to_chars(DATA_BLOCK_gen2.nicknames[pkbuddy_selected_index], nick_name);
+			show_message("PKBuddy will trade %s", nick_name);
 			return;
 		}
 		//START BUTTON
@@ -119,9 +120,9 @@ void pokebuddy_gen1::handle_special_hotkey(int key) {
 		if (key < 10)
 		{
 			pkbuddy_selected_index = (key - 1);
-			std::string nick_name = convert_name_to_string(std::string((const char*)DATA_BLOCK_gen2.nicknames[key - 1]));
-			std::string msg_str = "PKBuddy will trade " + nick_name;
-			display_message(msg_str);
+			char nick_name[11];
+			convert_name_to_chars(DATA_BLOCK_gen2.nicknames[key - 1], nick_name);
+			show_message("PKBuddy will trade %s", nick_name);
 			return;
 		}
 
@@ -163,7 +164,7 @@ byte pokebuddy_gen1::handle_gen1(byte data) {
 		{
 			if (!has_owned_mew()) {
 
-				display_message("Get your Welcome Mew!");
+				show_message("Get your Welcome Mew!");
 
 				pokemon mew = generate_pk_from_base_table(150, 5);
 				mew.iv[0] = 0x5A;
@@ -340,7 +341,7 @@ byte pokebuddy_gen1::handle_gen2(byte data) {
 				
 				if (!has_owned_celebi())
 				{
-					display_message("Get your Welcome Celebi!");
+					show_message("Get your Welcome Celebi!");
 
 					pokemon_gen2 celebi = generate_pk_from_base_table_gen2(251, 5);
 					celebi.move1 = 0x49;
@@ -355,7 +356,7 @@ byte pokebuddy_gen1::handle_gen2(byte data) {
 
 				if (!has_owned_mew_gen2()) 
 				{
-					display_message("Get your Welcome Mew!");
+					show_message("Get your Welcome Mew!");
 					pokemon_gen2 mew = generate_pk_from_base_table_gen2(151, 5);
 					insert_pokemon_into_slot_gen2(mew, 1, "Mew");
 					DATA_BLOCK_gen2.species_list_size = 2;
@@ -123,6 +123,15 @@ public:
    void loadState(const void *data);
    size_t stateSize() const;
 
+   /** Fast in-memory snapshot for rewind, run-ahead and rollback. Copies each state region
+     * into data (rawStateSize() bytes, allocated by the caller) with a single memcpy.
+     * Only valid for the same build with the same ROM loaded; use saveState for anything
+     * stored on disk. loadRawState returns false if the snapshot does not fit this ROM.
+     */
+   void saveRawState(void *data);
+   bool loadRawState(const void *data);
+   size_t rawStateSize() const;
+
    void setColorCorrection(bool enable);
    void setColorCorrectionMode(unsigned colorCorrectionMode);
    void setColorCorrectionBrightness(float colorCorrectionBrightness);
@@ -19,178 +19,547 @@ enum frame_blend_method
     FRAME_BLEND_LCD_GHOSTING_FAST
 };
 
+/* Pixel channel layout. Every channel is handled
+ * as a 5 bit value, matching what the original
+ * float implementation did (the RGB565 green LSB
+ * is dropped, as before) */
+#ifdef VIDEO_RGB565
+#define FRAME_BLEND_SHIFT_R 11
+#define FRAME_BLEND_SHIFT_G 6
+#define FRAME_BLEND_SHIFT_B 0
+/* Channel bits that remain after clearing the LSB
+ * of each channel, used by the packed 50:50 mix */
+#define FRAME_BLEND_MIX_MASK 0xF7DE
+#elif defined(VIDEO_ABGR1555)
+#define FRAME_BLEND_SHIFT_R 0
+#define FRAME_BLEND_SHIFT_G 5
+#define FRAME_BLEND_SHIFT_B 10
+#define FRAME_BLEND_MIX_MASK 0x7BDE
+#else
+#define FRAME_BLEND_SHIFT_R 16
+#define FRAME_BLEND_SHIFT_G 8
+#define FRAME_BLEND_SHIFT_B 0
+#define FRAME_BLEND_MIX_MASK 0xFEFEFE
+#endif
+
+/* LCD ghosting weights are Q10 fixed point.
+ * 31 * 1024 + 512 still fits in 16 bits, so the
+ * vector kernels can work on 16 bit lanes */
+#define FRAME_BLEND_WEIGHT_BITS 10
+#define FRAME_BLEND_WEIGHT_ONE  (1 << FRAME_BLEND_WEIGHT_BITS)
+
+/* 'Fast' ghosting accumulators are Q8 fixed point */
+#define FRAME_BLEND_ACC_BITS 8
+
+/* With a response of exactly 0.5, the 'fast' method
+ * reduces to a rounding average of the accumulator
+ * and the current frame */
+static_assert(LCD_RESPONSE_TIME_FAKE == 0.5f,
+      "blend_frames_lcd_ghost_fast() assumes a response time of 0.5");
+
+#if defined(VIDEO_RGB565) || defined(VIDEO_ABGR1555)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define FRAME_BLEND_SSE2
+#include <emmintrin.h>
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#define FRAME_BLEND_AVX2
+#include <immintrin.h>
+#endif
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#define FRAME_BLEND_NEON
+#include <arm_neon.h>
+#endif
+#endif
+
 static enum frame_blend_method frame_blend_type = FRAME_BLEND_NONE;
 static gambatte::video_pixel_t* video_buf_prev_1 = NULL;
 static gambatte::video_pixel_t* video_buf_prev_2 = NULL;
 static gambatte::video_pixel_t* video_buf_prev_3 = NULL;
 static gambatte::video_pixel_t* video_buf_prev_4 = NULL;
-static float* video_buf_acc_r = NULL;
-static float* video_buf_acc_g = NULL;
-static float* video_buf_acc_b = NULL;
-static float frame_blend_response[4] = { 0.0f };
+static uint16_t* video_buf_acc_r = NULL;
+static uint16_t* video_buf_acc_g = NULL;
+static uint16_t* video_buf_acc_b = NULL;
+/* [0] weights the current frame, [1..4] the history */
+static uint16_t frame_blend_weight[5] = { FRAME_BLEND_WEIGHT_ONE, 0, 0, 0, 0 };
 static bool frame_blend_response_set = false;
 static void (*blend_frames)(void) = NULL;
 
-/* > Note: The individual frame blending functions
- *   are somewhat WET (Write Everything Twice), in that
- *   we duplicate the entire nested for loop.
- *   This code is performance-critical, so we want to
- *   minimise logic in the inner loops where possible  */
-static void blend_frames_mix(void)
+/* Row kernels, selected once in init_frame_blending() */
+static void (*blend_row_mix)(gambatte::video_pixel_t* curr,
+      gambatte::video_pixel_t* prev, size_t count) = NULL;
+static void (*blend_row_lcd_ghost)(gambatte::video_pixel_t* curr,
+      const gambatte::video_pixel_t* prev_1, const gambatte::video_pixel_t* prev_2,
+      const gambatte::video_pixel_t* prev_3, gambatte::video_pixel_t* prev_4,
+      size_t count) = NULL;
+static void (*blend_row_lcd_ghost_fast)(gambatte::video_pixel_t* curr,
+      uint16_t* acc_r, uint16_t* acc_g, uint16_t* acc_b, size_t count) = NULL;
+
+/* Scalar kernels. These define the reference result:
+ * every vector kernel below must produce identical
+ * output, so switching dispatch targets never
+ * changes the picture */
+static void blend_row_mix_c(gambatte::video_pixel_t* curr,
+      gambatte::video_pixel_t* prev, size_t count)
 {
-    gambatte::video_pixel_t* curr = video_buf;
-    gambatte::video_pixel_t* prev = video_buf_prev_1;
-    size_t x, y;
+    size_t x;
 
-    for (y = 0; y < VIDEO_HEIGHT; y++)
+    for (x = 0; x < count; x++)
+    {
+        gambatte::video_pixel_t rgb_curr = curr[x];
+        gambatte::video_pixel_t rgb_prev = prev[x];
+
+        prev[x] = rgb_curr;
+
+        /* Per channel rounding average, written so that
+         * it cannot overflow a 16 bit lane
+         * > "Mixing Packed RGB Pixels Efficiently"
+         *   http://blargg.8bitalley.com/info/rgb_mixing.html */
+        curr[x] = (rgb_curr | rgb_prev) - (((rgb_curr ^ rgb_prev) & FRAME_BLEND_MIX_MASK) >> 1);
+    }
+}
+
+static void blend_row_lcd_ghost_c(gambatte::video_pixel_t* curr,
+      const gambatte::video_pixel_t* prev_1, const gambatte::video_pixel_t* prev_2,
+      const gambatte::video_pixel_t* prev_3, gambatte::video_pixel_t* prev_4,
+      size_t count)
+{
+    const unsigned w0 = frame_blend_weight[0];
+    const unsigned w1 = frame_blend_weight[1];
+    const unsigned w2 = frame_blend_weight[2];
+    const unsigned w3 = frame_blend_weight[3];
+    const unsigned w4 = frame_blend_weight[4];
+    const unsigned round = FRAME_BLEND_WEIGHT_ONE >> 1;
+    size_t x;
+
+    for (x = 0; x < count; x++)
     {
-        for (x = 0; x < VIDEO_WIDTH; x++)
+        gambatte::video_pixel_t c  = curr[x];
+        gambatte::video_pixel_t p1 = prev_1[x];
+        gambatte::video_pixel_t p2 = prev_2[x];
+        gambatte::video_pixel_t p3 = prev_3[x];
+        gambatte::video_pixel_t p4 = prev_4[x];
+        gambatte::video_pixel_t out = 0;
+        unsigned shift;
+
+        /* The oldest buffer becomes the newest once
+         * the history pointers are rotated */
+        prev_4[x] = c;
+
+        for (shift = 0; shift < 3; shift++)
         {
-            /* Get colours from current + previous frames */
-            gambatte::video_pixel_t rgb_curr = *(curr + x);
-            gambatte::video_pixel_t rgb_prev = *(prev + x);
+            unsigned s = shift == 0 ? FRAME_BLEND_SHIFT_R :
+                  shift == 1 ? FRAME_BLEND_SHIFT_G : FRAME_BLEND_SHIFT_B;
+            unsigned mix = (c  >> s & 0x1F) * w0
+                  + (p1 >> s & 0x1F) * w1
+                  + (p2 >> s & 0x1F) * w2
+                  + (p3 >> s & 0x1F) * w3
+                  + (p4 >> s & 0x1F) * w4;
+            out |= static_cast<gambatte::video_pixel_t>(((mix + round) >> FRAME_BLEND_WEIGHT_BITS) & 0x1F) << s;
+        }
 
-            /* Store colours for next frame */
-            *(prev + x) = rgb_curr;
+        curr[x] = out;
+    }
+}
 
-            /* Mix colours
-             * > "Mixing Packed RGB Pixels Efficiently"
-             *   http://blargg.8bitalley.com/info/rgb_mixing.html */
-#ifdef VIDEO_RGB565
-            * (curr + x) = (rgb_curr + rgb_prev + ((rgb_curr ^ rgb_prev) & 0x821)) >> 1;
-#elif defined(VIDEO_ABGR1555)
-            * (curr + x) = (rgb_curr + rgb_prev + ((rgb_curr ^ rgb_prev) & 0x521)) >> 1;
-#else
-            * (curr + x) = (rgb_curr + rgb_prev + ((rgb_curr ^ rgb_prev) & 0x10101)) >> 1;
+static void blend_row_lcd_ghost_fast_c(gambatte::video_pixel_t* curr,
+      uint16_t* acc_r, uint16_t* acc_g, uint16_t* acc_b, size_t count)
+{
+    const unsigned round = 1 << (FRAME_BLEND_ACC_BITS - 1);
+    size_t x;
+
+    for (x = 0; x < count; x++)
+    {
+        gambatte::video_pixel_t c = curr[x];
+        unsigned r = (acc_r[x] + ((c >> FRAME_BLEND_SHIFT_R & 0x1F) << FRAME_BLEND_ACC_BITS) + 1) >> 1;
+        unsigned g = (acc_g[x] + ((c >> FRAME_BLEND_SHIFT_G & 0x1F) << FRAME_BLEND_ACC_BITS) + 1) >> 1;
+        unsigned b = (acc_b[x] + ((c >> FRAME_BLEND_SHIFT_B & 0x1F) << FRAME_BLEND_ACC_BITS) + 1) >> 1;
+
+        acc_r[x] = r;
+        acc_g[x] = g;
+        acc_b[x] = b;
+
+        curr[x] = static_cast<gambatte::video_pixel_t>(((r + round) >> FRAME_BLEND_ACC_BITS) & 0x1F) << FRAME_BLEND_SHIFT_R
+              | static_cast<gambatte::video_pixel_t>(((g + round) >> FRAME_BLEND_ACC_BITS) & 0x1F) << FRAME_BLEND_SHIFT_G
+              | static_cast<gambatte::video_pixel_t>(((b + round) >> FRAME_BLEND_ACC_BITS) & 0x1F) << FRAME_BLEND_SHIFT_B;
+    }
+}
+
+#ifdef FRAME_BLEND_SSE2
+/* 8 pixels per step */
+static void blend_row_mix_sse2(gambatte::video_pixel_t* curr,
+      gambatte::video_pixel_t* prev, size_t count)
+{
+    const __m128i mask = _mm_set1_epi16((short)FRAME_BLEND_MIX_MASK);
+    size_t x = 0;
+
+    for (; x + 8 <= count; x += 8)
+    {
+        __m128i c = _mm_loadu_si128((const __m128i*)(curr + x));
+        __m128i p = _mm_loadu_si128((const __m128i*)(prev + x));
+        __m128i d = _mm_srli_epi16(_mm_and_si128(_mm_xor_si128(c, p), mask), 1);
+
+        _mm_storeu_si128((__m128i*)(prev + x), c);
+        _mm_storeu_si128((__m128i*)(curr + x), _mm_sub_epi16(_mm_or_si128(c, p), d));
+    }
+
+    blend_row_mix_c(curr + x, prev + x, count - x);
+}
+
+static inline __m128i blend_channel_sse2(__m128i c, __m128i p1, __m128i p2,
+      __m128i p3, __m128i p4, int shift, const __m128i* w)
+{
+    const __m128i lo5 = _mm_set1_epi16(0x1F);
+    const __m128i s   = _mm_cvtsi32_si128(shift);
+    __m128i sum;
+
+    sum = _mm_mullo_epi16(_mm_and_si128(_mm_srl_epi16(c, s), lo5), w[0]);
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(_mm_and_si128(_mm_srl_epi16(p1, s), lo5), w[1]));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(_mm_and_si128(_mm_srl_epi16(p2, s), lo5), w[2]));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(_mm_and_si128(_mm_srl_epi16(p3, s), lo5), w[3]));
+    sum = _mm_add_epi16(sum, _mm_mullo_epi16(_mm_and_si128(_mm_srl_epi16(p4, s), lo5), w[4]));
+    sum = _mm_add_epi16(sum, _mm_set1_epi16(FRAME_BLEND_WEIGHT_ONE >> 1));
+
+    return _mm_sll_epi16(_mm_and_si128(_mm_srli_epi16(sum, FRAME_BLEND_WEIGHT_BITS), lo5), s);
+}
+
+static void blend_row_lcd_ghost_sse2(gambatte::video_pixel_t* curr,
+      const gambatte::video_pixel_t* prev_1, const gambatte::video_pixel_t* prev_2,
+      const gambatte::video_pixel_t* prev_3, gambatte::video_pixel_t* prev_4,
+      size_t count)
+{
+    __m128i w[5];
+    size_t x = 0;
+    int i;
+
+    for (i = 0; i < 5; i++)
+        w[i] = _mm_set1_epi16((short)frame_blend_weight[i]);
+
+    for (; x + 8 <= count; x += 8)
+    {
+        __m128i c  = _mm_loadu_si128((const __m128i*)(curr + x));
+        __m128i p1 = _mm_loadu_si128((const __m128i*)(prev_1 + x));
+        __m128i p2 = _mm_loadu_si128((const __m128i*)(prev_2 + x));
+        __m128i p3 = _mm_loadu_si128((const __m128i*)(prev_3 + x));
+        __m128i p4 = _mm_loadu_si128((const __m128i*)(prev_4 + x));
+        __m128i out;
+
+        _mm_storeu_si128((__m128i*)(prev_4 + x), c);
+
+        out = blend_channel_sse2(c, p1, p2, p3, p4, FRAME_BLEND_SHIFT_R, w);
+        out = _mm_or_si128(out, blend_channel_sse2(c, p1, p2, p3, p4, FRAME_BLEND_SHIFT_G, w));
+        out = _mm_or_si128(out, blend_channel_sse2(c, p1, p2, p3, p4, FRAME_BLEND_SHIFT_B, w));
+        _mm_storeu_si128((__m128i*)(curr + x), out);
+    }
+
+    blend_row_lcd_ghost_c(curr + x, prev_1 + x, prev_2 + x, prev_3 + x, prev_4 + x, count - x);
+}
+
+static inline __m128i blend_acc_sse2(__m128i c, uint16_t* acc, int shift)
+{
+    const __m128i lo5   = _mm_set1_epi16(0x1F);
+    const __m128i round = _mm_set1_epi16(1 << (FRAME_BLEND_ACC_BITS - 1));
+    const __m128i s     = _mm_cvtsi32_si128(shift);
+    __m128i a = _mm_loadu_si128((const __m128i*)acc);
+
+    a = _mm_avg_epu16(a, _mm_slli_epi16(_mm_and_si128(_mm_srl_epi16(c, s), lo5), FRAME_BLEND_ACC_BITS));
+    _mm_storeu_si128((__m128i*)acc, a);
+
+    return _mm_sll_epi16(_mm_and_si128(_mm_srli_epi16(_mm_add_epi16(a, round), FRAME_BLEND_ACC_BITS), lo5), s);
+}
+
+static void blend_row_lcd_ghost_fast_sse2(gambatte::video_pixel_t* curr,
+      uint16_t* acc_r, uint16_t* acc_g, uint16_t* acc_b, size_t count)
+{
+    size_t x = 0;
+
+    for (; x + 8 <= count; x += 8)
+    {
+        __m128i c = _mm_loadu_si128((const __m128i*)(curr + x));
+        __m128i out;
+
+        out = blend_acc_sse2(c, acc_r + x, FRAME_BLEND_SHIFT_R);
+        out = _mm_or_si128(out, blend_acc_sse2(c, acc_g + x, FRAME_BLEND_SHIFT_G));
+        out = _mm_or_si128(out, blend_acc_sse2(c, acc_b + x, FRAME_BLEND_SHIFT_B));
+        _mm_storeu_si128((__m128i*)(curr + x), out);
+    }
+
+    blend_row_lcd_ghost_fast_c(curr + x, acc_r + x, acc_g + x, acc_b + x, count - x);
+}
 #endif
-        }
 
-        curr += VIDEO_PITCH;
-        prev += VIDEO_PITCH;
+#ifdef FRAME_BLEND_AVX2
+/* 16 pixels per step. Only used when the
+ * host CPU reports AVX2 at runtime */
+__attribute__((target("avx2")))
+static void blend_row_mix_avx2(gambatte::video_pixel_t* curr,
+      gambatte::video_pixel_t* prev, size_t count)
+{
+    const __m256i mask = _mm256_set1_epi16((short)FRAME_BLEND_MIX_MASK);
+    size_t x = 0;
+
+    for (; x + 16 <= count; x += 16)
+    {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(curr + x));
+        __m256i p = _mm256_loadu_si256((const __m256i*)(prev + x));
+        __m256i d = _mm256_srli_epi16(_mm256_and_si256(_mm256_xor_si256(c, p), mask), 1);
+
+        _mm256_storeu_si256((__m256i*)(prev + x), c);
+        _mm256_storeu_si256((__m256i*)(curr + x), _mm256_sub_epi16(_mm256_or_si256(c, p), d));
     }
+
+    blend_row_mix_c(curr + x, prev + x, count - x);
 }
 
-static void blend_frames_lcd_ghost(void)
+__attribute__((target("avx2")))
+static inline __m256i blend_channel_avx2(__m256i c, __m256i p1, __m256i p2,
+      __m256i p3, __m256i p4, int shift, const __m256i* w)
 {
-    gambatte::video_pixel_t* curr = video_buf;
-    gambatte::video_pixel_t* prev_1 = video_buf_prev_1;
-    gambatte::video_pixel_t* prev_2 = video_buf_prev_2;
-    gambatte::video_pixel_t* prev_3 = video_buf_prev_3;
-    gambatte::video_pixel_t* prev_4 = video_buf_prev_4;
-    float* response = frame_blend_response;
-    size_t x, y;
+    const __m256i lo5 = _mm256_set1_epi16(0x1F);
+    const __m128i s   = _mm_cvtsi32_si128(shift);
+    __m256i sum;
+
+    sum = _mm256_mullo_epi16(_mm256_and_si256(_mm256_srl_epi16(c, s), lo5), w[0]);
+    sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(_mm256_and_si256(_mm256_srl_epi16(p1, s), lo5), w[1]));
+    sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(_mm256_and_si256(_mm256_srl_epi16(p2, s), lo5), w[2]));
+    sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(_mm256_and_si256(_mm256_srl_epi16(p3, s), lo5), w[3]));
+    sum = _mm256_add_epi16(sum, _mm256_mullo_epi16(_mm256_and_si256(_mm256_srl_epi16(p4, s), lo5), w[4]));
+    sum = _mm256_add_epi16(sum, _mm256_set1_epi16(FRAME_BLEND_WEIGHT_ONE >> 1));
+
+    return _mm256_sll_epi16(_mm256_and_si256(_mm256_srli_epi16(sum, FRAME_BLEND_WEIGHT_BITS), lo5), s);
+}
 
-    for (y = 0; y < VIDEO_HEIGHT; y++)
+__attribute__((target("avx2")))
+static void blend_row_lcd_ghost_avx2(gambatte::video_pixel_t* curr,
+      const gambatte::video_pixel_t* prev_1, const gambatte::video_pixel_t* prev_2,
+      const gambatte::video_pixel_t* prev_3, gambatte::video_pixel_t* prev_4,
+      size_t count)
+{
+    __m256i w[5];
+    size_t x = 0;
+    int i;
+
+    for (i = 0; i < 5; i++)
+        w[i] = _mm256_set1_epi16((short)frame_blend_weight[i]);
+
+    for (; x + 16 <= count; x += 16)
     {
-        for (x = 0; x < VIDEO_WIDTH; x++)
-        {
-            /* Get colours from current + previous frames */
-            gambatte::video_pixel_t rgb_curr = *(curr + x);
-            gambatte::video_pixel_t rgb_prev_1 = *(prev_1 + x);
-            gambatte::video_pixel_t rgb_prev_2 = *(prev_2 + x);
-            gambatte::video_pixel_t rgb_prev_3 = *(prev_3 + x);
-            gambatte::video_pixel_t rgb_prev_4 = *(prev_4 + x);
-
-            /* Store colours for next frame */
-            *(prev_1 + x) = rgb_curr;
-            *(prev_2 + x) = rgb_prev_1;
-            *(prev_3 + x) = rgb_prev_2;
-            *(prev_4 + x) = rgb_prev_3;
-
-            /* Unpack colours and convert to float */
-#ifdef VIDEO_RGB565
-            float r_curr = static_cast<float>(rgb_curr >> 11 & 0x1F);
-            float g_curr = static_cast<float>(rgb_curr >> 6 & 0x1F);
-            float b_curr = static_cast<float>(rgb_curr & 0x1F);
+        __m256i c  = _mm256_loadu_si256((const __m256i*)(curr + x));
+        __m256i p1 = _mm256_loadu_si256((const __m256i*)(prev_1 + x));
+        __m256i p2 = _mm256_loadu_si256((const __m256i*)(prev_2 + x));
+        __m256i p3 = _mm256_loadu_si256((const __m256i*)(prev_3 + x));
+        __m256i p4 = _mm256_loadu_si256((const __m256i*)(prev_4 + x));
+        __m256i out;
+
+        _mm256_storeu_si256((__m256i*)(prev_4 + x), c);
+
+        out = blend_channel_avx2(c, p1, p2, p3, p4, FRAME_BLEND_SHIFT_R, w);
+        out = _mm256_or_si256(out, blend_channel_avx2(c, p1, p2, p3, p4, FRAME_BLEND_SHIFT_G, w));
+        out = _mm256_or_si256(out, blend_channel_avx2(c, p1, p2, p3, p4, FRAME_BLEND_SHIFT_B, w));
+        _mm256_storeu_si256((__m256i*)(curr + x), out);
+    }
 
-            float r_prev_1 = static_cast<float>(rgb_prev_1 >> 11 & 0x1F);
-            float g_prev_1 = static_cast<float>(rgb_prev_1 >> 6 & 0x1F);
-            float b_prev_1 = static_cast<float>(rgb_prev_1 & 0x1F);
+    blend_row_lcd_ghost_sse2(curr + x, prev_1 + x, prev_2 + x, prev_3 + x, prev_4 + x, count - x);
+}
 
-            float r_prev_2 = static_cast<float>(rgb_prev_2 >> 11 & 0x1F);
-            float g_prev_2 = static_cast<float>(rgb_prev_2 >> 6 & 0x1F);
-            float b_prev_2 = static_cast<float>(rgb_prev_2 & 0x1F);
+__attribute__((target("avx2")))
+static inline __m256i blend_acc_avx2(__m256i c, uint16_t* acc, int shift)
+{
+    const __m256i lo5   = _mm256_set1_epi16(0x1F);
+    const __m256i round = _mm256_set1_epi16(1 << (FRAME_BLEND_ACC_BITS - 1));
+    const __m128i s     = _mm_cvtsi32_si128(shift);
+    __m256i a = _mm256_loadu_si256((const __m256i*)acc);
 
-            float r_prev_3 = static_cast<float>(rgb_prev_3 >> 11 & 0x1F);
-            float g_prev_3 = static_cast<float>(rgb_prev_3 >> 6 & 0x1F);
-            float b_prev_3 = static_cast<float>(rgb_prev_3 & 0x1F);
+    a = _mm256_avg_epu16(a, _mm256_slli_epi16(_mm256_and_si256(_mm256_srl_epi16(c, s), lo5), FRAME_BLEND_ACC_BITS));
+    _mm256_storeu_si256((__m256i*)acc, a);
 
-            float r_prev_4 = static_cast<float>(rgb_prev_4 >> 11 & 0x1F);
-            float g_prev_4 = static_cast<float>(rgb_prev_4 >> 6 & 0x1F);
-            float b_prev_4 = static_cast<float>(rgb_prev_4 & 0x1F);
-#elif defined(VIDEO_ABGR1555)
-            float r_curr = static_cast<float>(rgb_curr & 0x1F);
-            float g_curr = static_cast<float>(rgb_curr >> 5 & 0x1F);
-            float b_curr = static_cast<float>(rgb_curr >> 10 & 0x1F);
+    return _mm256_sll_epi16(_mm256_and_si256(_mm256_srli_epi16(_mm256_add_epi16(a, round), FRAME_BLEND_ACC_BITS), lo5), s);
+}
 
-            float r_prev_1 = static_cast<float>(rgb_prev_1 & 0x1F);
-            float g_prev_1 = static_cast<float>(rgb_prev_1 >> 5 & 0x1F);
-            float b_prev_1 = static_cast<float>(rgb_prev_1 >> 10 & 0x1F);
+__attribute__((target("avx2")))
+static void blend_row_lcd_ghost_fast_avx2(gambatte::video_pixel_t* curr,
+      uint16_t* acc_r, uint16_t* acc_g, uint16_t* acc_b, size_t count)
+{
+    size_t x = 0;
 
-            float r_prev_2 = static_cast<float>(rgb_prev_2 & 0x1F);
-            float g_prev_2 = static_cast<float>(rgb_prev_2 >> 5 & 0x1F);
-            float b_prev_2 = static_cast<float>(rgb_prev_2 >> 10 & 0x1F);
+    for (; x + 16 <= count; x += 16)
+    {
+        __m256i c = _mm256_loadu_si256((const __m256i*)(curr + x));
+        __m256i out;
 
-            float r_prev_3 = static_cast<float>(rgb_prev_3 & 0x1F);
-            float g_prev_3 = static_cast<float>(rgb_prev_3 >> 5 & 0x1F);
-            float b_prev_3 = static_cast<float>(rgb_prev_3 >> 10 & 0x1F);
+        out = blend_acc_avx2(c, acc_r + x, FRAME_BLEND_SHIFT_R);
+        out = _mm256_or_si256(out, blend_acc_avx2(c, acc_g + x, FRAME_BLEND_SHIFT_G));
+        out = _mm256_or_si256(out, blend_acc_avx2(c, acc_b + x, FRAME_BLEND_SHIFT_B));
+        _mm256_storeu_si256((__m256i*)(curr + x), out);
+    }
 
-            float r_prev_4 = static_cast<float>(rgb_prev_4 & 0x1F);
-            float g_prev_4 = static_cast<float>(rgb_prev_4 >> 5 & 0x1F);
-            float b_prev_4 = static_cast<float>(rgb_prev_4 >> 10 & 0x1F);
-#else
-            float r_curr = static_cast<float>(rgb_curr >> 16 & 0x1F);
-            float g_curr = static_cast<float>(rgb_curr >> 8 & 0x1F);
-            float b_curr = static_cast<float>(rgb_curr & 0x1F);
+    blend_row_lcd_ghost_fast_sse2(curr + x, acc_r + x, acc_g + x, acc_b + x, count - x);
+}
+#endif
 
-            float r_prev_1 = static_cast<float>(rgb_prev_1 >> 16 & 0x1F);
-            float g_prev_1 = static_cast<float>(rgb_prev_1 >> 8 & 0x1F);
-            float b_prev_1 = static_cast<float>(rgb_prev_1 & 0x1F);
+#ifdef FRAME_BLEND_NEON
+/* 8 pixels per step */
+static void blend_row_mix_neon(gambatte::video_pixel_t* curr,
+      gambatte::video_pixel_t* prev, size_t count)
+{
+    const uint16x8_t mask = vdupq_n_u16(FRAME_BLEND_MIX_MASK);
+    size_t x = 0;
+
+    for (; x + 8 <= count; x += 8)
+    {
+        uint16x8_t c = vld1q_u16(curr + x);
+        uint16x8_t p = vld1q_u16(prev + x);
+        uint16x8_t d = vshrq_n_u16(vandq_u16(veorq_u16(c, p), mask), 1);
+
+        vst1q_u16(prev + x, c);
+        vst1q_u16(curr + x, vsubq_u16(vorrq_u16(c, p), d));
+    }
+
+    blend_row_mix_c(curr + x, prev + x, count - x);
+}
+
+static inline uint16x8_t blend_channel_neon(uint16x8_t c, uint16x8_t p1, uint16x8_t p2,
+      uint16x8_t p3, uint16x8_t p4, int shift, const uint16x8_t* w)
+{
+    const uint16x8_t lo5 = vdupq_n_u16(0x1F);
+    const int16x8_t  s   = vdupq_n_s16(-shift);
+    uint16x8_t sum;
+
+    sum = vmulq_u16(vandq_u16(vshlq_u16(c, s), lo5), w[0]);
+    sum = vmlaq_u16(sum, vandq_u16(vshlq_u16(p1, s), lo5), w[1]);
+    sum = vmlaq_u16(sum, vandq_u16(vshlq_u16(p2, s), lo5), w[2]);
+    sum = vmlaq_u16(sum, vandq_u16(vshlq_u16(p3, s), lo5), w[3]);
+    sum = vmlaq_u16(sum, vandq_u16(vshlq_u16(p4, s), lo5), w[4]);
+    sum = vaddq_u16(sum, vdupq_n_u16(FRAME_BLEND_WEIGHT_ONE >> 1));
+
+    return vshlq_u16(vandq_u16(vshrq_n_u16(sum, FRAME_BLEND_WEIGHT_BITS), lo5), vdupq_n_s16(shift));
+}
+
+static void blend_row_lcd_ghost_neon(gambatte::video_pixel_t* curr,
+      const gambatte::video_pixel_t* prev_1, const gambatte::video_pixel_t* prev_2,
+      const gambatte::video_pixel_t* prev_3, gambatte::video_pixel_t* prev_4,
+      size_t count)
+{
+    uint16x8_t w[5];
+    size_t x = 0;
+    int i;
+
+    for (i = 0; i < 5; i++)
+        w[i] = vdupq_n_u16(frame_blend_weight[i]);
+
+    for (; x + 8 <= count; x += 8)
+    {
+        uint16x8_t c  = vld1q_u16(curr + x);
+        uint16x8_t p1 = vld1q_u16(prev_1 + x);
+        uint16x8_t p2 = vld1q_u16(prev_2 + x);
+        uint16x8_t p3 = vld1q_u16(prev_3 + x);
+        uint16x8_t p4 = vld1q_u16(prev_4 + x);
+        uint16x8_t out;
+
+        vst1q_u16(prev_4 + x, c);
+
+        out = blend_channel_neon(c, p1, p2, p3, p4, FRAME_BLEND_SHIFT_R, w);
+        out = vorrq_u16(out, blend_channel_neon(c, p1, p2, p3, p4, FRAME_BLEND_SHIFT_G, w));
+        out = vorrq_u16(out, blend_channel_neon(c, p1, p2, p3, p4, FRAME_BLEND_SHIFT_B, w));
+        vst1q_u16(curr + x, out);
+    }
+
+    blend_row_lcd_ghost_c(curr + x, prev_1 + x, prev_2 + x, prev_3 + x, prev_4 + x, count - x);
+}
+
+static inline uint16x8_t blend_acc_neon(uint16x8_t c, uint16_t* acc, int shift)
+{
+    const uint16x8_t lo5 = vdupq_n_u16(0x1F);
+    uint16x8_t a = vld1q_u16(acc);
+
+    /* vrhaddq_u16() is (a + b + 1) >> 1, like _mm_avg_epu16() */
+    a = vrhaddq_u16(a, vshlq_n_u16(vandq_u16(vshlq_u16(c, vdupq_n_s16(-shift)), lo5), FRAME_BLEND_ACC_BITS));
+    vst1q_u16(acc, a);
+
+    return vshlq_u16(vandq_u16(vrshrq_n_u16(a, FRAME_BLEND_ACC_BITS), lo5), vdupq_n_s16(shift));
+}
+
+static void blend_row_lcd_ghost_fast_neon(gambatte::video_pixel_t* curr,
+      uint16_t* acc_r, uint16_t* acc_g, uint16_t* acc_b, size_t count)
+{
+    size_t x = 0;
 
-            float r_prev_2 = static_cast<float>(rgb_prev_2 >> 16 & 0x1F);
-            float g_prev_2 = static_cast<float>(rgb_prev_2 >> 8 & 0x1F);
-            float b_prev_2 = static_cast<float>(rgb_prev_2 & 0x1F);
+    for (; x + 8 <= count; x += 8)
+    {
+        uint16x8_t c = vld1q_u16(curr + x);
+        uint16x8_t out;
 
-            float r_prev_3 = static_cast<float>(rgb_prev_3 >> 16 & 0x1F);
-            float g_prev_3 = static_cast<float>(rgb_prev_3 >> 8 & 0x1F);
-            float b_prev_3 = static_cast<float>(rgb_prev_3 & 0x1F);
+        out = blend_acc_neon(c, acc_r + x, FRAME_BLEND_SHIFT_R);
+        out = vorrq_u16(out, blend_acc_neon(c, acc_g + x, FRAME_BLEND_SHIFT_G));
+        out = vorrq_u16(out, blend_acc_neon(c, acc_b + x, FRAME_BLEND_SHIFT_B));
+        vst1q_u16(curr + x, out);
+    }
 
-            float r_prev_4 = static_cast<float>(rgb_prev_4 >> 16 & 0x1F);
-            float g_prev_4 = static_cast<float>(rgb_prev_4 >> 8 & 0x1F);
-            float b_prev_4 = static_cast<float>(rgb_prev_4 & 0x1F);
+    blend_row_lcd_ghost_fast_c(curr + x, acc_r + x, acc_g + x, acc_b + x, count - x);
+}
 #endif
-            /* Mix colours for current frame and convert back to video_pixel_t
-             * > Response time effect implemented via an exponential
-             *   drop-off algorithm, taken from the 'Gameboy Classic Shader'
-             *   by Harlequin:
-             *      https://github.com/libretro/glsl-shaders/blob/master/handheld/shaders/gameboy/shader-files/gb-pass0.glsl */
-            r_curr += (r_prev_1 - r_curr) * *response;
-            r_curr += (r_prev_2 - r_curr) * *(response + 1);
-            r_curr += (r_prev_3 - r_curr) * *(response + 2);
-            r_curr += (r_prev_4 - r_curr) * *(response + 3);
-            gambatte::video_pixel_t r_mix = static_cast<gambatte::video_pixel_t>(r_curr + 0.5f) & 0x1F;
-
-            g_curr += (g_prev_1 - g_curr) * *response;
-            g_curr += (g_prev_2 - g_curr) * *(response + 1);
-            g_curr += (g_prev_3 - g_curr) * *(response + 2);
-            g_curr += (g_prev_4 - g_curr) * *(response + 3);
-            gambatte::video_pixel_t g_mix = static_cast<gambatte::video_pixel_t>(g_curr + 0.5f) & 0x1F;
-
-            b_curr += (b_prev_1 - b_curr) * *response;
-            b_curr += (b_prev_2 - b_curr) * *(response + 1);
-            b_curr += (b_prev_3 - b_curr) * *(response + 2);
-            b_curr += (b_prev_4 - b_curr) * *(response + 3);
-            gambatte::video_pixel_t b_mix = static_cast<gambatte::video_pixel_t>(b_curr + 0.5f) & 0x1F;
-
-            /* Repack colours for current frame */
-#ifdef VIDEO_RGB565
-            * (curr + x) = r_mix << 11 | g_mix << 6 | b_mix;
-#elif defined(VIDEO_ABGR1555)
-            * (curr + x) = b_mix << 10 | g_mix << 5 | b_mix;
-#else
-            * (curr + x) = r_mix << 16 | g_mix << 8 | b_mix;
+
+static void select_blend_row_kernels(void)
+{
+    blend_row_mix            = blend_row_mix_c;
+    blend_row_lcd_ghost      = blend_row_lcd_ghost_c;
+    blend_row_lcd_ghost_fast = blend_row_lcd_ghost_fast_c;
+
+#if defined(FRAME_BLEND_SSE2)
+    blend_row_mix            = blend_row_mix_sse2;
+    blend_row_lcd_ghost      = blend_row_lcd_ghost_sse2;
+    blend_row_lcd_ghost_fast = blend_row_lcd_ghost_fast_sse2;
+#if defined(FRAME_BLEND_AVX2)
+    if (__builtin_cpu_supports("avx2"))
+    {
+        blend_row_mix            = blend_row_mix_avx2;
+        blend_row_lcd_ghost      = blend_row_lcd_ghost_avx2;
+        blend_row_lcd_ghost_fast = blend_row_lcd_ghost_fast_avx2;
+    }
 #endif
-        }
+#elif defined(FRAME_BLEND_NEON)
+    blend_row_mix            = blend_row_mix_neon;
+    blend_row_lcd_ghost      = blend_row_lcd_ghost_neon;
+    blend_row_lcd_ghost_fast = blend_row_lcd_ghost_fast_neon;
+#endif
+}
+
+static void blend_frames_mix(void)
+{
+    gambatte::video_pixel_t* curr = video_buf;
+    gambatte::video_pixel_t* prev = video_buf_prev_1;
+    size_t y;
+
+    for (y = 0; y < VIDEO_HEIGHT; y++)
+    {
+        blend_row_mix(curr, prev, VIDEO_WIDTH);
+
+        curr += VIDEO_PITCH;
+        prev += VIDEO_PITCH;
+    }
+}
+
+static void blend_frames_lcd_ghost(void)
+{
+    gambatte::video_pixel_t* curr = video_buf;
+    gambatte::video_pixel_t* prev_1 = video_buf_prev_1;
+    gambatte::video_pixel_t* prev_2 = video_buf_prev_2;
+    gambatte::video_pixel_t* prev_3 = video_buf_prev_3;
+    gambatte::video_pixel_t* prev_4 = video_buf_prev_4;
+    gambatte::video_pixel_t* oldest = video_buf_prev_4;
+    size_t y;
+
+    /* Mix colours for current frame
+     * > Response time effect implemented via an exponential
+     *   drop-off algorithm, taken from the 'Gameboy Classic Shader'
+     *   by Harlequin:
+     *      https://github.com/libretro/glsl-shaders/blob/master/handheld/shaders/gameboy/shader-files/gb-pass0.glsl
+     * > The drop-off is folded into the fixed point weights
+     *   computed in init_frame_blending(). The current frame
+     *   is stored over the oldest one, so history only has
+     *   to be rotated, not copied */
+    for (y = 0; y < VIDEO_HEIGHT; y++)
+    {
+        blend_row_lcd_ghost(curr, prev_1, prev_2, prev_3, prev_4, VIDEO_WIDTH);
 
         curr += VIDEO_PITCH;
         prev_1 += VIDEO_PITCH;
@@ -198,65 +567,24 @@ static void blend_frames_lcd_ghost(void)
         prev_3 += VIDEO_PITCH;
         prev_4 += VIDEO_PITCH;
     }
+
+    video_buf_prev_4 = video_buf_prev_3;
+    video_buf_prev_3 = video_buf_prev_2;
+    video_buf_prev_2 = video_buf_prev_1;
+    video_buf_prev_1 = oldest;
 }
 
 static void blend_frames_lcd_ghost_fast(void)
 {
     gambatte::video_pixel_t* curr = video_buf;
-    float* prev_r = video_buf_acc_r;
-    float* prev_g = video_buf_acc_g;
-    float* prev_b = video_buf_acc_b;
-    size_t x, y;
+    uint16_t* prev_r = video_buf_acc_r;
+    uint16_t* prev_g = video_buf_acc_g;
+    uint16_t* prev_b = video_buf_acc_b;
+    size_t y;
 
     for (y = 0; y < VIDEO_HEIGHT; y++)
     {
-        for (x = 0; x < VIDEO_WIDTH; x++)
-        {
-            /* Get colours from current + previous frames */
-            gambatte::video_pixel_t rgb_curr = *(curr + x);
-            float r_prev = *(prev_r + x);
-            float g_prev = *(prev_g + x);
-            float b_prev = *(prev_b + x);
-
-            /* Unpack current colours and convert to float */
-#ifdef VIDEO_RGB565
-            float r_curr = static_cast<float>(rgb_curr >> 11 & 0x1F);
-            float g_curr = static_cast<float>(rgb_curr >> 6 & 0x1F);
-            float b_curr = static_cast<float>(rgb_curr & 0x1F);
-#elif defined(VIDEO_ABGR1555)
-            float r_curr = static_cast<float>(rgb_curr & 0x1F);
-            float g_curr = static_cast<float>(rgb_curr >> 5 & 0x1F);
-            float b_curr = static_cast<float>(rgb_curr >> 10 & 0x1F);
-#else
-            float r_curr = static_cast<float>(rgb_curr >> 16 & 0x1F);
-            float g_curr = static_cast<float>(rgb_curr >> 8 & 0x1F);
-            float b_curr = static_cast<float>(rgb_curr & 0x1F);
-#endif
-            /* Mix colours for current frame */
-            float r_mix = (r_curr * (1.0f - LCD_RESPONSE_TIME_FAKE)) + (LCD_RESPONSE_TIME_FAKE * r_prev);
-            float g_mix = (g_curr * (1.0f - LCD_RESPONSE_TIME_FAKE)) + (LCD_RESPONSE_TIME_FAKE * g_prev);
-            float b_mix = (b_curr * (1.0f - LCD_RESPONSE_TIME_FAKE)) + (LCD_RESPONSE_TIME_FAKE * b_prev);
-
-            /* Store colours for next frame */
-            *(prev_r + x) = r_mix;
-            *(prev_g + x) = g_mix;
-            *(prev_b + x) = b_mix;
-
-            /* Convert, repack and assign colours for current frame */
-#ifdef VIDEO_RGB565
-            * (curr + x) = (static_cast<gambatte::video_pixel_t>(r_mix + 0.5f) & 0x1F) << 11
-                | (static_cast<gambatte::video_pixel_t>(g_mix + 0.5f) & 0x1F) << 6
-                | (static_cast<gambatte::video_pixel_t>(b_mix + 0.5f) & 0x1F);
-#elif defined(ABGR1555)
-            * (curr + x) = (static_cast<gambatte::video_pixel_t>(r_mix + 0.5f) & 0x1F)
-                | (static_cast<gambatte::video_pixel_t>(g_mix + 0.5f) & 0x1F) << 5
-                | (static_cast<gambatte::video_pixel_t>(b_mix + 0.5f) & 0x1F) << 10;
-#else
-            * (curr + x) = (static_cast<gambatte::video_pixel_t>(r_mix + 0.5f) & 0x1F) << 16
-                | (static_cast<gambatte::video_pixel_t>(g_mix + 0.5f) & 0x1F) << 8
-                | (static_cast<gambatte::video_pixel_t>(b_mix + 0.5f) & 0x1F);
-#endif
-        }
+        blend_row_lcd_ghost_fast(curr, prev_r, prev_g, prev_b, VIDEO_WIDTH);
 
         curr += VIDEO_PITCH;
         prev_r += VIDEO_PITCH;
@@ -277,39 +605,17 @@ static bool allocate_video_buf_prev(gambatte::video_pixel_t** buf)
     return true;
 }
 
-static bool allocate_video_buf_acc(void)
+static bool allocate_video_buf_acc(uint16_t** buf)
 {
-    size_t i;
-    size_t buf_size = 256 * NUM_GAMEBOYS * VIDEO_HEIGHT * sizeof(float);
-
-    if (!video_buf_acc_r)
-    {
-        video_buf_acc_r = (float*)malloc(buf_size);
-        if (!video_buf_acc_r)
-            return false;
-    }
+    size_t buf_size = 256 * NUM_GAMEBOYS * VIDEO_HEIGHT * sizeof(uint16_t);
 
-    if (!video_buf_acc_g)
-    {
-        video_buf_acc_g = (float*)malloc(buf_size);
-        if (!video_buf_acc_g)
-            return false;
-    }
-
-    if (!video_buf_acc_b)
+    if (!*buf)
     {
-        video_buf_acc_b = (float*)malloc(buf_size);
-        if (!video_buf_acc_b)
+        *buf = (uint16_t*)malloc(buf_size);
+        if (!*buf)
             return false;
     }
-
-    /* Cannot use memset() on arrays of floats... */
-    for (i = 0; i < (256 * NUM_GAMEBOYS * VIDEO_HEIGHT); i++)
-    {
-        video_buf_acc_r[i] = 0.0f;
-        video_buf_acc_g[i] = 0.0f;
-        video_buf_acc_b[i] = 0.0f;
-    }
+    memset(*buf, 0, buf_size);
     return true;
 }
 
@@ -341,7 +647,11 @@ static void init_frame_blending(void)
     case FRAME_BLEND_LCD_GHOSTING_FAST:
         /* 'Fast' LCD ghosting requires three (RGB)
          * 'accumulator' buffers */
-        if (!allocate_video_buf_acc())
+        if (!allocate_video_buf_acc(&video_buf_acc_r))
+            return;
+        if (!allocate_video_buf_acc(&video_buf_acc_g))
+            return;
+        if (!allocate_video_buf_acc(&video_buf_acc_b))
             return;
         break;
     case FRAME_BLEND_NONE:
@@ -367,15 +677,42 @@ static void init_frame_blending(void)
          * increased, we may need to rethink this
          * (but more samples == greater performance
          * overheads) */
-        frame_blend_response[0] = LCD_RESPONSE_TIME;
-        frame_blend_response[1] = std::pow(LCD_RESPONSE_TIME, 2.0f);
-        frame_blend_response[2] = std::pow(LCD_RESPONSE_TIME, 3.0f);
-        frame_blend_response[3] = std::pow(LCD_RESPONSE_TIME, 4.0f);
+        float response[4];
+        float weight[5];
+        unsigned sum = 0;
+        int i, j;
+
+        response[0] = LCD_RESPONSE_TIME;
+        response[1] = std::pow(LCD_RESPONSE_TIME, 2.0f);
+        response[2] = std::pow(LCD_RESPONSE_TIME, 3.0f);
+        response[3] = std::pow(LCD_RESPONSE_TIME, 4.0f);
+
+        /* Unroll the four drop-off steps
+         *    c += (prev_n - c) * response[n - 1]
+         * into one weight per frame, then convert
+         * to fixed point. The current frame takes up
+         * the rounding error so the weights always
+         * sum to exactly one */
+        for (i = 0; i < 4; i++)
+        {
+            weight[i + 1] = response[i];
+            for (j = i + 1; j < 4; j++)
+                weight[i + 1] *= 1.0f - response[j];
+        }
+
+        for (i = 1; i < 5; i++)
+        {
+            frame_blend_weight[i] = static_cast<uint16_t>(weight[i] * FRAME_BLEND_WEIGHT_ONE + 0.5f);
+            sum += frame_blend_weight[i];
+        }
+        frame_blend_weight[0] = static_cast<uint16_t>(FRAME_BLEND_WEIGHT_ONE - sum);
 
         frame_blend_response_set = true;
     }
 
     /* Assign frame blending function */
+    select_blend_row_kernels();
+
     switch (frame_blend_type)
     {
     case FRAME_BLEND_MIX:
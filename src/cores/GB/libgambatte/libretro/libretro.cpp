@@ -9,6 +9,7 @@
 #include "gbcpalettes.h"
 #include "bootloader.h"
 #include "local_serial.h"
+#include "multi_state.h"
 
 #ifdef HAVE_NETWORK
 #include "net_serial.h"
@@ -455,6 +456,10 @@ class SNESInput : public gambatte::InputGetter
 
 static SNESInput* gb_input[NUM_GAMEBOYS];
 
+// one end of the local link per instance, kept here so savestates can reach them
+static LocalSerial gb_local_serial[NUM_GAMEBOYS];
+static MultiState gb_state;
+
 
 
 
@@ -721,34 +726,23 @@ void retro_reset()
   
 }
 
-static size_t serialize_size = 0;
 size_t retro_serialize_size(void)
 {
-   return v_gb[0]->stateSize();
+   return gb_state.size();
 }
 
 bool retro_serialize(void *data, size_t size)
 {
-   serialize_size = retro_serialize_size();
-
-   if (size != serialize_size)
-      return false;
-
-   v_gb[0]->saveState(data);
-   return true;
+   return gb_state.save(data, size);
 }
 
 bool retro_unserialize(const void *data, size_t size)
 {
-   serialize_size = retro_serialize_size();
-
-   if (size != serialize_size)
+   if (!gb_state.load(data, size))
    {
-       printf("savestate size doesn't match %d : %d\n ", size, serialize_size);
+       printf("savestate does not match this session (%d bytes, expected %d)\n", (int)size, (int)gb_state.size());
        return false;
    }
-
-   v_gb[0]->loadState(data);
    return true;
 }
 
@@ -1262,8 +1256,8 @@ static void check_variables(bool startup)
          break;
       case SERIAL_LOCAL:
       {
-          LocalSerial* sio_a = new LocalSerial();
-          LocalSerial* sio_b = new LocalSerial();
+          LocalSerial* sio_a = &gb_local_serial[0];
+          LocalSerial* sio_b = &gb_local_serial[1];
 
           sio_a->setConnectedSerialIO(sio_b);
           sio_b->setConnectedSerialIO(sio_a);
@@ -1795,6 +1789,12 @@ bool retro_load_game(const struct retro_game_info *info)
    bool yes = true;
    environ_cb(RETRO_ENVIRONMENT_SET_SUPPORT_ACHIEVEMENTS, &yes);
 
+   // every instance and both link ends, the sizes are fixed from here on
+   std::vector<LocalSerial*> serials;
+   for (int i = 0; i < NUM_GAMEBOYS; i++)
+      serials.push_back(&gb_local_serial[i]);
+   gb_state.setup(v_gb, serials);
+
    rom_loaded = true;
    return true;
 }
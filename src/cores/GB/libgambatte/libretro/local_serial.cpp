@@ -32,6 +32,22 @@ bool LocalSerial::check(unsigned char out, unsigned char& in, bool& fastCgb)
 }
 
 
+void LocalSerial::saveState(unsigned char* data) const
+{
+	data[0] = has_received_data;
+	data[1] = fastCgb;
+	data[2] = received_data;
+	data[3] = out_data;
+}
+
+void LocalSerial::loadState(const unsigned char* data)
+{
+	has_received_data = data[0] != 0;
+	fastCgb = data[1] != 0;
+	received_data = data[2];
+	out_data = data[3];
+}
+
 void LocalSerial::log_link_traffic(unsigned char a, unsigned char b)
 {
 
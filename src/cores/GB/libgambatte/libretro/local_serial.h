@@ -8,7 +8,7 @@
 class LocalSerial : public gambatte::SerialIO
 {
 public:
-	LocalSerial() {};
+	LocalSerial() : link_target(0), connected_SerialIO(0), has_received_data(false), fastCgb(false), received_data(0), out_data(0) {};
 	~LocalSerial() {};
 
 	void setLinkTarget(I_linkcable_target* link_target) { this->link_target = link_target; };
@@ -19,6 +19,11 @@ public:
 	bool is_ready() { return link_target->is_ready(); };
 	virtual unsigned char receive(unsigned char data, bool fastCgb);
 
+	// the byte waiting for check(), part of a linked savestate
+	enum { STATE_SIZE = 4 };
+	void saveState(unsigned char* data) const;
+	void loadState(const unsigned char* data);
+
 private:
 
 	void log_link_traffic(unsigned char a, unsigned char b);
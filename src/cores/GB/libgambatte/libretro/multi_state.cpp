@@ -0,0 +1,183 @@
+#include "multi_state.h"
+#include "local_serial.h"
+#include <string.h>
+
+static const unsigned char state_magic[4] = { 'D', 'C', 'G', 'S' };
+static const unsigned state_version = 1;
+static const size_t header_size = 16;
+static const size_t frame_size = 8;
+
+static void put32(unsigned char* p, unsigned long v)
+{
+	p[0] = v & 0xFF;
+	p[1] = (v >> 8) & 0xFF;
+	p[2] = (v >> 16) & 0xFF;
+	p[3] = (v >> 24) & 0xFF;
+}
+
+static unsigned long get32(const unsigned char* p)
+{
+	return p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned long)p[3] << 24);
+}
+
+MultiState::MultiState()
+: serial_offset_(0), total_(0), sized_(false), loading_(false), data_(0), generation_(0), pending_(0), quit_(false)
+{
+}
+
+MultiState::~MultiState()
+{
+	stopWorkers();
+}
+
+void MultiState::stopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		quit_ = true;
+	}
+	wake_.notify_all();
+	for (size_t i = 0; i < workers_.size(); i++)
+		workers_[i].join();
+	workers_.clear();
+	quit_ = false;
+}
+
+void MultiState::setup(const std::vector<gambatte::GB*>& gbs, const std::vector<LocalSerial*>& serials)
+{
+	stopWorkers();
+	gbs_ = gbs;
+	serials_ = serials;
+	sized_ = false;
+
+	// worker i - 1 owns instance i. The generation is passed here: a worker that
+	// starts late must not take a runAll() that already began as its baseline
+	for (size_t i = 1; i < gbs_.size(); i++)
+		workers_.push_back(std::thread(&MultiState::workerMain, this, i, generation_));
+}
+
+void MultiState::layout()
+{
+	if (sized_)
+		return;
+
+	sizes_.resize(gbs_.size());
+	offsets_.resize(gbs_.size());
+	size_t at = header_size;
+	for (size_t i = 0; i < gbs_.size(); i++)
+	{
+		sizes_[i] = gbs_[i]->stateSize();
+		offsets_[i] = at + frame_size;
+		at = offsets_[i] + ((sizes_[i] + 7) & ~(size_t)7);
+	}
+	serial_offset_ = at;
+	total_ = at + serials_.size() * LocalSerial::STATE_SIZE;
+	sized_ = true;
+}
+
+size_t MultiState::size()
+{
+	layout();
+	return total_;
+}
+
+void MultiState::process(size_t i)
+{
+	if (loading_)
+		gbs_[i]->loadState(data_ + offsets_[i]);
+	else
+	{
+		unsigned char* frame = data_ + offsets_[i] - frame_size;
+		put32(frame, sizes_[i]);
+		put32(frame + 4, 0);
+		gbs_[i]->saveState(data_ + offsets_[i]);
+		memset(data_ + offsets_[i] + sizes_[i], 0, ((sizes_[i] + 7) & ~(size_t)7) - sizes_[i]);
+	}
+}
+
+void MultiState::workerMain(size_t i, unsigned seen)
+{
+	for (;;)
+	{
+		{
+			std::unique_lock<std::mutex> guard(lock_);
+			wake_.wait(guard, [&]() { return quit_ || generation_ != seen; });
+			if (quit_)
+				return;
+			seen = generation_;
+		}
+
+		process(i);
+
+		std::lock_guard<std::mutex> guard(lock_);
+		if (--pending_ == 0)
+			done_.notify_one();
+	}
+}
+
+void MultiState::runAll(bool loading, unsigned char* data)
+{
+	{
+		std::lock_guard<std::mutex> guard(lock_);
+		loading_ = loading;
+		data_ = data;
+		pending_ = workers_.size();
+		generation_++;
+	}
+	if (!workers_.empty())
+		wake_.notify_all();
+
+	if (!gbs_.empty())
+		process(0);
+
+	std::unique_lock<std::mutex> guard(lock_);
+	done_.wait(guard, [&]() { return pending_ == 0; });
+}
+
+bool MultiState::save(void* data, size_t size)
+{
+	layout();
+	if (size != total_)
+		return false;
+
+	unsigned char* p = static_cast<unsigned char*>(data);
+	memcpy(p, state_magic, 4);
+	put32(p + 4, state_version);
+	put32(p + 8, gbs_.size());
+	put32(p + 12, serials_.size());
+
+	runAll(false, p);
+
+	for (size_t i = 0; i < serials_.size(); i++)
+		serials_[i]->saveState(p + serial_offset_ + i * LocalSerial::STATE_SIZE);
+	return true;
+}
+
+bool MultiState::load(const void* data, size_t size)
+{
+	layout();
+	const unsigned char* p = static_cast<const unsigned char*>(data);
+
+	if (size < header_size || memcmp(p, state_magic, 4) != 0)
+	{
+		if (gbs_.empty() || size != sizes_[0])
+			return false;
+		gbs_[0]->loadState(data);
+		return true;
+	}
+
+	if (size != total_ || get32(p + 4) != state_version || get32(p + 8) != gbs_.size() || get32(p + 12) != serials_.size())
+		return false;
+	for (size_t i = 0; i < gbs_.size(); i++)
+	{
+		if (get32(p + offsets_[i] - frame_size) != sizes_[i])
+			return false;
+	}
+
+	// gambatte only reads from the buffer
+	runAll(true, const_cast<unsigned char*>(p));
+
+	for (size_t i = 0; i < serials_.size(); i++)
+		serials_[i]->loadState(p + serial_offset_ + i * LocalSerial::STATE_SIZE);
+	return true;
+}
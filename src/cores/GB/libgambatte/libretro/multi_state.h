@@ -0,0 +1,60 @@
+#ifndef _MULTI_STATE_H
+#define _MULTI_STATE_H
+
+#include <gambatte.h>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class LocalSerial;
+
+// Savestate of every gambatte::GB instance and the local link in one framed
+// buffer, little endian:
+//   header    "DCGS", version, instance count, serial count (4 x u32)
+//   instance  u32 size, u32 reserved, gambatte state padded to 8 bytes; repeated
+//   serial    LocalSerial::STATE_SIZE bytes per link end
+// Every instance is saved and loaded on its own thread (the caller takes the
+// first one), so a linked session costs about as much as a single one.
+class MultiState
+{
+	public:
+		MultiState();
+		~MultiState();
+
+		// instance sizes are cached until the next setup(), call it after loading a ROM
+		void setup(const std::vector<gambatte::GB*>& gbs, const std::vector<LocalSerial*>& serials);
+		size_t size();
+		bool save(void* data, size_t size);
+		// also takes a plain single instance state (the format before linked states) for the first instance
+		bool load(const void* data, size_t size);
+
+	private:
+		void layout();
+		void runAll(bool loading, unsigned char* data);
+		void process(size_t i);
+		void workerMain(size_t i, unsigned seen);
+		void stopWorkers();
+
+		std::vector<gambatte::GB*> gbs_;
+		std::vector<LocalSerial*> serials_;
+		std::vector<size_t> sizes_;
+		std::vector<size_t> offsets_;
+		size_t serial_offset_;
+		size_t total_;
+		bool sized_;
+
+		// current job, valid while a generation runs
+		bool loading_;
+		unsigned char* data_;
+
+		std::vector<std::thread> workers_;
+		std::mutex lock_;
+		std::condition_variable wake_, done_;
+		unsigned generation_;
+		size_t pending_;
+		bool quit_;
+};
+
+#endif
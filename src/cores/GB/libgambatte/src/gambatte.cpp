@@ -165,6 +165,31 @@ size_t GB::stateSize() const {
    return StateSaver::stateSize(state);
 }
 
+void GB::saveRawState(void *data) {
+   SaveState state;
+   p_->cpu.setStatePtrs(state);
+   p_->cpu.saveState(state);
+   StateSaver::saveRawState(state, data);
+}
+
+bool GB::loadRawState(const void *data) {
+   SaveState state;
+   p_->cpu.setStatePtrs(state);
+
+   if (!StateSaver::loadRawState(state, data))
+      return false;
+
+   p_->cpu.loadState(state);
+   p_->cpu.mem_.bootloader.choosebank(state.mem.ioamhram.get()[0x150] != 0xFF);
+   return true;
+}
+
+size_t GB::rawStateSize() const {
+   SaveState state;
+   p_->cpu.setStatePtrs(state);
+   return StateSaver::rawStateSize(state);
+}
+
 void GB::setColorCorrection(bool enable) {
    p_->cpu.mem_.display_setColorCorrection(enable);
 }
@@ -539,5 +539,70 @@ size_t StateSaver::stateSize(const SaveState &state) {
    return file.size();
 }
 
+// Raw layout: the SaveState struct itself followed by each region its Ptr members
+// point at, one memcpy per region. Only meaningful within the same build with the
+// same ROM loaded; anything that leaves the process uses the labelled format above.
+#define RAW_STATE_REGIONS(X) \
+   X(mem.vram) X(mem.sram) X(mem.wram) X(mem.ioamhram) \
+   X(ppu.bgpData) X(ppu.objpData) X(ppu.oamReaderBuf) X(ppu.oamReaderSzbuf) \
+   X(spu.ch3.waveRam)
+
+#define RAW_REGION_BYTES(arg) (state.arg.size() * sizeof *state.arg.get())
+
+size_t StateSaver::rawStateSize(const SaveState &state) {
+   size_t size = sizeof state;
+
+#define X(arg) size += RAW_REGION_BYTES(arg);
+   RAW_STATE_REGIONS(X)
+#undef X
+
+   return size;
+}
+
+void StateSaver::saveRawState(const SaveState &state, void *data) {
+   uint8_t *dst = static_cast<uint8_t*>(data);
+
+   std::memcpy(dst, &state, sizeof state);
+   dst += sizeof state;
+
+#define X(arg) { \
+   const size_t n = RAW_REGION_BYTES(arg); \
+   if (n) \
+      std::memcpy(dst, state.arg.get(), n); \
+   dst += n; \
+}
+   RAW_STATE_REGIONS(X)
+#undef X
+}
+
+bool StateSaver::loadRawState(SaveState &state, const void *data) {
+   const uint8_t *src = static_cast<const uint8_t*>(data);
+   SaveState saved;
+
+   std::memcpy(&saved, src, sizeof saved);
+   src += sizeof saved;
+
+   // regions are restored in place, so their sizes must match the current machine
+#define X(arg) if (saved.arg.size() != state.arg.size()) return false;
+   RAW_STATE_REGIONS(X)
+#undef X
+
+#define X(arg) { \
+   const size_t n = RAW_REGION_BYTES(arg); \
+   if (n) \
+      std::memcpy(state.arg.get(), src, n); \
+   src += n; \
+   saved.arg = state.arg; \
+}
+   RAW_STATE_REGIONS(X)
+#undef X
+
+   state = saved;
+   return true;
+}
+
+#undef RAW_REGION_BYTES
+#undef RAW_STATE_REGIONS
+
 }
 
@@ -39,6 +39,10 @@ public:
    static void saveState(const SaveState &state, void *data);
    static bool loadState(SaveState &state, const void *data);
    static size_t stateSize(const SaveState &state);
+
+   static void saveRawState(const SaveState &state, void *data);
+   static bool loadRawState(SaveState &state, const void *data);
+   static size_t rawStateSize(const SaveState &state);
 };
 
 }
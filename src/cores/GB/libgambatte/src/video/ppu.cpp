@@ -167,6 +167,37 @@ static int loadTileDataByte1(PPUPriv const &p) {
 }
 
 namespace M3Start {
+	// The first 8 - (scx & 7) pixels of a scrolled line fall outside the visible area.
+	// When no sprite or window can start within them and the cycles to get past them are
+	// already available, do their fetches in one go rather than pixel by pixel through
+	// the M3Loop::Tile states. Returns false to leave the line to the state machine.
+	static bool skipPartialTile(PPUPriv &p) {
+		int const scxAnd7 = p.scx & 7;
+		int const endx = 8 - scxAnd7;
+
+		if (p.cycles < 1 - p.cgb + endx
+				|| int(p.spriteList[0].spx) < endx
+				|| int(p.wx) < endx
+				|| (p.winDrawState & win_draw_start)) {
+			return false;
+		}
+
+		if (scxAnd7 <= 2)
+			p.reg0 = loadTileDataByte0(p);
+
+		if (scxAnd7 <= 4) {
+			int const r1 = loadTileDataByte1(p);
+			p.ntileword = (expand_lut + (p.nattrib << 3 & 0x100))[p.reg0]
+			            + (expand_lut + (p.nattrib << 3 & 0x100))[r1    ] * 2;
+		}
+
+		p.tileword >>= endx * 2;
+		p.xpos = endx;
+		p.endx = endx;
+		nextCall(1 - p.cgb + endx, M3Loop::Tile::f0_, p);
+		return true;
+	}
+
 	static void f0(PPUPriv &p) {
 		p.xpos = 0;
 
@@ -254,7 +285,8 @@ namespace M3Start {
 			&M3Loop::Tile::f5_
 		};
 
-		nextCall(1-p.cgb, *flut[p.scx & 7], p);
+		if (!(p.scx & 7) || !skipPartialTile(p))
+			nextCall(1-p.cgb, *flut[p.scx & 7], p);
 	}
 }
 
@@ -1017,6 +1049,47 @@ namespace LoadSprites {
 }
 
 namespace Tile {
+	// Plots the pixels left between the last full tile and xpos 168 in one go, for the
+	// common case where no sprite or window can start there and the cycles to finish the
+	// line are already available. Returns false to leave them to f1..f5.
+	static bool plotLastTile(PPUPriv &p) {
+		int const xpos = p.xpos;
+		int const n = 168 - xpos;
+		int const i = p.nextSprite;
+
+		if (p.cycles < n - 1
+				|| p.spriteList[i].spx < 168
+				|| (i > 0 && int(p.spriteList[i-1].spx) > xpos - 8)
+				|| (static_cast<int>(p.wx) >= xpos && p.wx < 167)) {
+			return false;
+		}
+
+		if (n >= 3)
+			p.reg0 = loadTileDataByte0(p);
+
+		if (n >= 5) {
+			int const r1 = loadTileDataByte1(p);
+			p.ntileword = (expand_lut + (p.nattrib << 3 & 0x100))[p.reg0]
+			            + (expand_lut + (p.nattrib << 3 & 0x100))[r1    ] * 2;
+		}
+
+		video_pixel_t *const dst = p.framebuf.fbline() + (xpos - 8);
+		video_pixel_t const *const bgPalette = p.bgPalette + (p.attrib & 7) * 4;
+		unsigned const twmask = ((p.lcdc & 1) | p.cgb) * 3;
+		unsigned tileword = p.tileword;
+
+		for (int x = 0; x < n; ++x) {
+			dst[x] = bgPalette[tileword & twmask];
+			tileword >>= 2;
+		}
+
+		p.tileword = tileword;
+		p.xpos = 168;
+		p.cycles -= n - 1;
+		xpos168(p);
+		return true;
+	}
+
 	static void inc(PPUState const &nextf, PPUPriv &p) {
 		plotPixelIfNoSprite(p);
 
@@ -1055,6 +1128,9 @@ namespace Tile {
 			                 + ((p.scy + p.lyCounter.ly()) & 0xF8) * 4 + 0x3800];
 		}
 
+		if (p.endx == 168 && plotLastTile(p))
+			return;
+
 		inc(f1_, p);
 	}
 
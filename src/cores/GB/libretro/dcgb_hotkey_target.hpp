@@ -0,0 +1,11 @@
+#pragma once
+
+// A link or IR device that reacts to the special hotkeys: 0x10 (SELECT)
+// steps to the device's next item, other keys pick one directly.
+// TGBDualCore::pressHotkey() hands the keys to gb_movie, which delivers them
+// at the next frame start and records them, so a movie replays them too.
+class I_dcgb_hotkey_target {
+public:
+	virtual ~I_dcgb_hotkey_target() {}
+	virtual void handle_special_hotkey(int key) = 0;
+};
@@ -4,6 +4,7 @@
 
 #include "libretro/callbacks.h"
 #include "libretro/cheats.h"
+#include "cores/GB/common/alloc_guard/include/alloc_guard.hpp"
 
 IMultiCore* CoreConfigurator::getCore(const struct retro_game_info* info) {
 	if (core_) return core_;
@@ -41,6 +42,7 @@ void retro_reset(void)
 
 void retro_run(void)
 {
+	alloc_guard guard("retro_run");
 	DoubleCherryEngine::run();
 }
 
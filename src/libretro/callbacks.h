@@ -1,5 +1,7 @@
 ﻿// start boilerplate
 
+#include "core_options.h"
+
 void retro_get_system_av_info(struct retro_system_av_info* info)
 {
     //videoLayoutManager.getAvInfo(info);
@@ -46,9 +48,21 @@ void retro_set_environment(retro_environment_t cb)
     cb(RETRO_ENVIRONMENT_SET_CONTENT_INFO_OVERRIDE,
         (void*)content_overrides);
 
+    // the engine's definitions followed by the TGBDual ones (core_options.h),
+    // built once: retro_set_environment() may be called several times
+    static std::vector<retro_core_option_v2_definition> option_defs;
+    if (option_defs.empty()) {
+        for (const retro_core_option_v2_definition* def = core_options_us; def->key; def++)
+            option_defs.push_back(*def);
+        const retro_core_option_v2_definition* def = tgbdual_options_us;
+        for (; def->key; def++)
+            option_defs.push_back(*def);
+        option_defs.push_back(*def);
+    }
+
     struct retro_core_options_v2 options = {
        option_cats_us,
-     core_options_us // <-- v2 definitions
+     option_defs.data() // <-- v2 definitions
 
     };
 
@@ -0,0 +1,53 @@
+// TGBDual core options, appended to the engine's core_options_us in
+// retro_set_environment(). TGBDualCore::checkOptions() reads them.
+
+static struct retro_core_option_v2_definition tgbdual_options_us[] = {
+    {
+        "dcgb_rtc_mode",
+        "Cartridge Real-Time Clock",
+        NULL,
+        "Time source of MBC3 and HuC3 clocks. 'Host' follows the system clock. 'Emulated' advances with the emulated CPU so fast-forward, run-ahead and replays keep game time consistent, starting from the system time on load; 'Emulated (start at zero)' starts it at 0. Emulated clocks add a block to savestates. Takes effect when content is loaded.",
+        NULL,
+        NULL,
+        {
+            { "host",          "Host" },
+            { "emulated",      "Emulated" },
+            { "emulated_zero", "Emulated (start at zero)" },
+            { NULL, NULL },
+        },
+        "host"
+    },
+    {
+        "dcgb_movie_record",
+        "Record Input Movie",
+        NULL,
+        "Records every player's input and the link-device hotkeys (L on port 1 steps the device to its next item). Switching it off or unloading the content writes '<cartridge title>.dcgbmov' to the save directory; batch_run replays and verifies it. Carts with a clock only replay exactly with 'Emulated (start at zero)'.",
+        NULL,
+        NULL,
+        {
+            { "disabled", NULL },
+            { "enabled",  NULL },
+            { NULL, NULL },
+        },
+        "disabled"
+    },
+#ifdef TGB_STATS
+    {
+        "dcgb_stats_log",
+        "Log Instrumentation Counters",
+        NULL,
+        "Writes each instance's hot path counters for the last frame (see stats.h) to the frontend log every N frames.",
+        NULL,
+        NULL,
+        {
+            { "disabled", NULL },
+            { "60",       "Every 60 frames" },
+            { "600",      "Every 600 frames" },
+            { "3600",     "Every 3600 frames" },
+            { NULL, NULL },
+        },
+        "disabled"
+    },
+#endif
+    { NULL, NULL, NULL, NULL, NULL, NULL, {{0}}, NULL },
+};
@@ -0,0 +1,176 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   batch_run: headless batch runs from a job list
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "../../src/cores/GB/common/batch/include/batch_runner.hpp"
+#include <cores/GB/TGBDual/gb.h>
+
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sstream>
+
+// job list: one job per line, blank lines and lines starting with # are skipped
+//   <tgb|gambatte> <rom> [frames=N] [shot=out.ppm] [movie=file] [link=cable]
+//                        [capture=file.dcap] [every=N] [profile=file] [sym=file] [period=N]
+// paths must not contain spaces; movie, link and profile are TGBDual only
+struct job_line {
+	batch_job job;
+	std::string shot_path;
+};
+
+// two player movies recorded on a plain link cable: the gbs are wired to each
+// other, there is no master device to process
+static link_master_device* link_cable(std::vector<gb*>& gbs)
+{
+	if (gbs.size() == 2)
+	{
+		gbs[0]->set_target(gbs[1]);
+		gbs[1]->set_target(gbs[0]);
+	}
+	return NULL;
+}
+
+static bool parse_line(const std::string& line, int line_no, job_line& out)
+{
+	std::istringstream in(line);
+	std::string core, word;
+	if (!(in >> core >> out.job.rom_path))
+	{
+		fprintf(stderr, "line %d: expected <core> <rom>\n", line_no);
+		return false;
+	}
+	if (core == "tgb")
+		out.job.core = BATCH_TGBDUAL;
+	else if (core == "gambatte")
+		out.job.core = BATCH_GAMBATTE;
+	else
+	{
+		fprintf(stderr, "line %d: unknown core %s\n", line_no, core.c_str());
+		return false;
+	}
+
+	while (in >> word)
+	{
+		size_t eq = word.find('=');
+		std::string key = word.substr(0, eq);
+		std::string value = eq == std::string::npos ? std::string() : word.substr(eq + 1);
+		if (value.empty())
+		{
+			fprintf(stderr, "line %d: expected key=value, got %s\n", line_no, word.c_str());
+			return false;
+		}
+
+		if (key == "frames")
+			out.job.frames = atoi(value.c_str());
+		else if (key == "shot")
+			out.shot_path = value;
+		else if (key == "movie")
+			out.job.movie_path = value;
+		else if (key == "link" && value == "cable")
+			out.job.make_link = link_cable;
+		else if (key == "capture")
+			out.job.capture_path = value;
+		else if (key == "every")
+			out.job.capture_every = atoi(value.c_str());
+		else if (key == "profile")
+			out.job.profile_path = value;
+		else if (key == "sym")
+			out.job.sym_path = value;
+		else if (key == "period")
+			out.job.profile_period = atoi(value.c_str());
+		else
+		{
+			fprintf(stderr, "line %d: unknown option %s\n", line_no, word.c_str());
+			return false;
+		}
+	}
+
+	if (out.job.core != BATCH_TGBDUAL && (!out.job.movie_path.empty() || out.job.make_link || !out.job.profile_path.empty()))
+	{
+		fprintf(stderr, "line %d: movie, link and profile need the tgb core\n", line_no);
+		return false;
+	}
+	return true;
+}
+
+// usage: batch_run <jobs.txt> [--threads N]
+//   prints one line per job and a summary, exits with 1 if any job failed
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		fprintf(stderr, "usage: %s <jobs.txt> [--threads N]\n", argv[0]);
+		return 2;
+	}
+
+	int threads = 0;
+	for (int i = 2; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--threads") && i + 1 < argc)
+			threads = atoi(argv[++i]);
+		else
+		{
+			fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	std::ifstream list(argv[1]);
+	if (!list)
+	{
+		fprintf(stderr, "cannot read %s\n", argv[1]);
+		return 1;
+	}
+
+	std::vector<job_line> lines;
+	std::string line;
+	int line_no = 0;
+	while (std::getline(list, line))
+	{
+		line_no++;
+		size_t first = line.find_first_not_of(" \t\r");
+		if (first == std::string::npos || line[first] == '#')
+			continue;
+		job_line parsed;
+		if (!parse_line(line, line_no, parsed))
+			return 2;
+		lines.push_back(parsed);
+	}
+
+	std::vector<batch_job> jobs;
+	for (size_t i = 0; i < lines.size(); i++)
+		jobs.push_back(lines[i].job);
+
+	std::vector<batch_result> results = batch_runner(threads).run(jobs);
+
+	bool failed = false;
+	for (size_t i = 0; i < results.size(); i++)
+	{
+		if (!results[i].ok)
+			failed = true;
+		if (!lines[i].shot_path.empty() && results[i].ok && !batch_runner::write_ppm(results[i], lines[i].shot_path))
+		{
+			fprintf(stderr, "cannot write %s\n", lines[i].shot_path.c_str());
+			failed = true;
+		}
+	}
+	batch_runner::print_report(stdout, jobs, results);
+	return failed ? 1 : 0;
+}
@@ -0,0 +1,107 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   capture_convert: .dcap capture files to PNG or Y4M
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "../../src/cores/GB/common/capture/include/frame_capture.hpp"
+
+#include <cstdlib>
+#include <cstring>
+#include <map>
+
+// usage: capture_convert <file.dcap> <out_prefix> [--png|--y4m] [--instance N]
+//   --png (default)  <out_prefix>_<instance>_<frame>.png for every record
+//   --y4m            <out_prefix>_<instance>.y4m, one stream per instance
+int main(int argc, char** argv)
+{
+	if (argc < 3)
+	{
+		fprintf(stderr, "usage: %s <file.dcap> <out_prefix> [--png|--y4m] [--instance N]\n", argv[0]);
+		return 2;
+	}
+
+	bool y4m = false;
+	int only = -1;
+	for (int i = 3; i < argc; i++)
+	{
+		if (!strcmp(argv[i], "--y4m"))
+			y4m = true;
+		else if (!strcmp(argv[i], "--png"))
+			y4m = false;
+		else if (!strcmp(argv[i], "--instance") && i + 1 < argc)
+			only = atoi(argv[++i]);
+		else
+		{
+			fprintf(stderr, "unknown option %s\n", argv[i]);
+			return 2;
+		}
+	}
+
+	capture_reader reader;
+	if (!reader.open(argv[1]))
+	{
+		fprintf(stderr, "%s: not a capture file\n", argv[1]);
+		return 1;
+	}
+
+	std::map<int, FILE*> streams;
+	capture_record record;
+	std::vector<uint8_t> pixels;
+	int converted = 0;
+	char path[1024];
+	while (reader.next(record, pixels))
+	{
+		if (only >= 0 && record.instance != only)
+			continue;
+
+		if (y4m)
+		{
+			FILE*& out = streams[record.instance];
+			bool first = !out;
+			if (first)
+			{
+				snprintf(path, sizeof(path), "%s_%d.y4m", argv[2], record.instance);
+				if (!(out = fopen(path, "wb")))
+				{
+					fprintf(stderr, "cannot create %s\n", path);
+					return 1;
+				}
+			}
+			if (!capture_write_y4m(out, record, pixels, first))
+			{
+				fprintf(stderr, "write failed at instance %d frame %u\n", record.instance, record.frame);
+				return 1;
+			}
+		}
+		else
+		{
+			snprintf(path, sizeof(path), "%s_%d_%06u.png", argv[2], record.instance, record.frame);
+			if (!capture_write_png(path, record, pixels))
+			{
+				fprintf(stderr, "cannot write %s\n", path);
+				return 1;
+			}
+		}
+		converted++;
+	}
+
+	for (std::map<int, FILE*>::iterator it = streams.begin(); it != streams.end(); ++it)
+		fclose(it->second);
+	printf("%d frames converted\n", converted);
+	return 0;
+}
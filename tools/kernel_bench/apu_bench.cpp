@@ -0,0 +1,47 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   kernel_bench: apu_snd::render
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "bench.hpp"
+#include "fixtures.hpp"
+
+#include <cores/GB/TGBDual/audio_mixer.h>
+
+// one frame of stereo samples per operation, as dmy_renderer::refresh() asks for
+// arg: bit 0 lowpass, bit 1 echo
+static void bench_apu_render(bench_state& st)
+{
+	static const byte idle[] = { 0xF3, 0x18, 0xFE }; // di; jr $
+	static short stream[MIXER_SAMPLES_PER_FRAME * 2];
+
+	fixture_gb f(FIXTURE_CGB, idle, sizeof(idle), false, true);
+	fixture_sound(f);
+	apu_snd* snd = f->get_apu()->get_renderer();
+	snd->set_lowpass((st.get_arg() & 1) != 0);
+	snd->set_echo((st.get_arg() & 2) != 0);
+
+	while (st.keep_running())
+		snd->render(stream, MIXER_SAMPLES_PER_FRAME);
+	bench_keep((word)stream[100]);
+	st.set_items(MIXER_SAMPLES_PER_FRAME, "smp");
+}
+
+BENCH(bench_apu_render, "apu/render", 0);
+BENCH(bench_apu_render, "apu/render_lowpass", 1);
+BENCH(bench_apu_render, "apu/render_echo", 2);
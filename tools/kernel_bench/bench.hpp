@@ -0,0 +1,96 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   kernel_bench: timing loop and registry
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#pragma once
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// One run of a kernel, used like a Google Benchmark state:
+//
+//   static void bench_foo(bench_state& st)
+//   {
+//       ...build the fixture, not timed...
+//       while (st.keep_running())
+//           ...one operation...
+//       st.set_items(items_per_operation, "px");
+//   }
+//   BENCH(bench_foo, "area/foo", 0);
+//
+// The runner picks the iteration count. pause()/resume() keep per-operation
+// setup out of the time; each pair costs two clock reads.
+class bench_state
+{
+public:
+	bench_state(uint64_t iterations, int arg) : iterations(iterations), left(iterations), elapsed(0), arg(arg), items(0), unit(NULL) {}
+
+	bool keep_running()
+	{
+		if (left == iterations)
+			resume();
+		if (left-- > 0)
+			return true;
+		pause();
+		return false;
+	}
+
+	void pause() { elapsed += std::chrono::steady_clock::now() - start; }
+	void resume() { start = std::chrono::steady_clock::now(); }
+
+	int get_arg() const { return arg; }
+	uint64_t get_iterations() const { return iterations; }
+	double get_seconds() const { return std::chrono::duration<double>(elapsed).count(); }
+
+	// work per operation for the throughput column, e.g. 144 "lines"
+	void set_items(uint64_t per_operation, const char* unit) { items = per_operation; this->unit = unit; }
+	uint64_t get_items() const { return items; }
+	const char* get_unit() const { return unit; }
+
+private:
+	uint64_t iterations;
+	uint64_t left;
+	std::chrono::steady_clock::duration elapsed;
+	std::chrono::steady_clock::time_point start;
+	int arg;
+	uint64_t items;
+	const char* unit;
+};
+
+typedef void (*bench_fn)(bench_state& st);
+
+struct bench_entry {
+	std::string name;
+	bench_fn fn;
+	int arg;
+};
+
+std::vector<bench_entry>& bench_registry();
+
+struct bench_register {
+	bench_register(const char* name, bench_fn fn, int arg) { bench_registry().push_back({ name, fn, arg }); }
+};
+
+// keeps a result alive so the compiler cannot drop the kernel
+void bench_keep(uint64_t value);
+
+#define BENCH_CAT2(a, b) a##b
+#define BENCH_CAT(a, b) BENCH_CAT2(a, b)
+#define BENCH(fn, name, arg) static bench_register BENCH_CAT(fn##_reg_, __LINE__)(name, fn, arg)
@@ -0,0 +1,198 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   kernel_bench: cpu::exec opcode mixes and cpu::read_direct
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "bench.hpp"
+#include "fixtures.hpp"
+
+// Every program is an endless loop at 0x0150 that only uses its own kind of
+// instructions plus the closing jump; exec() runs ten lines per operation.
+static const int EXEC_CLOCKS = 456 * 10;
+
+static const byte prog_alu[] = {
+	0xF3,             // di
+	0x21, 0x00, 0xC0, // ld hl,0xC000
+	0x01, 0x34, 0x12, // ld bc,0x1234
+	0x11, 0x78, 0x56, // ld de,0x5678
+	0x80,             // loop: add a,b
+	0x89,             // adc a,c
+	0x92,             // sub d
+	0x9B,             // sbc a,e
+	0xA4,             // and h
+	0xB5,             // or l
+	0xAA,             // xor d
+	0xB9,             // cp c
+	0x3C,             // inc a
+	0x0D,             // dec c
+	0x04,             // inc b
+	0x13,             // inc de
+	0x09,             // add hl,bc
+	0x26, 0xC0,       // ld h,0xC0
+	0x86,             // add a,(hl)
+	0xC6, 0x11,       // add a,0x11
+	0xE6, 0x7F,       // and 0x7F
+	0x27,             // daa
+	0x2F,             // cpl
+	0x37,             // scf
+	0x3F,             // ccf
+	0x18, 0xE6,       // jr loop
+};
+
+static const byte prog_load[] = {
+	0xF3,             // di
+	0x21, 0x00, 0xC0, // ld hl,0xC000
+	0x31, 0xF0, 0xDF, // ld sp,0xDFF0
+	0x78,             // loop: ld a,b
+	0x41,             // ld b,c
+	0x4A,             // ld c,d
+	0x53,             // ld d,e
+	0x5F,             // ld e,a
+	0x7E,             // ld a,(hl)
+	0x77,             // ld (hl),a
+	0x2A,             // ld a,(hl+)
+	0x32,             // ld (hl-),a
+	0x36, 0x5A,       // ld (hl),0x5A
+	0x46,             // ld b,(hl)
+	0xFA, 0x10, 0xC0, // ld a,(0xC010)
+	0xEA, 0x11, 0xC0, // ld (0xC011),a
+	0xF0, 0x80,       // ldh a,(0xFF80)
+	0xE0, 0x81,       // ldh (0xFF81),a
+	0x0E, 0x82,       // ld c,0x82
+	0xE2,             // ld (0xFF00+c),a
+	0xF2,             // ld a,(0xFF00+c)
+	0xC5,             // push bc
+	0xD1,             // pop de
+	0x08, 0x00, 0xC1, // ld (0xC100),sp
+	0x18, 0xDF,       // jr loop
+};
+
+static const byte prog_cb[] = {
+	0xF3,             // di
+	0x21, 0x00, 0xC0, // ld hl,0xC000
+	0xCB, 0x00,       // loop: rlc b
+	0xCB, 0x09,       // rrc c
+	0xCB, 0x12,       // rl d
+	0xCB, 0x1B,       // rr e
+	0xCB, 0x27,       // sla a
+	0xCB, 0x2F,       // sra a
+	0xCB, 0x37,       // swap a
+	0xCB, 0x3F,       // srl a
+	0xCB, 0x06,       // rlc (hl)
+	0xCB, 0x36,       // swap (hl)
+	0xCB, 0x47,       // bit 0,a
+	0xCB, 0x7E,       // bit 7,(hl)
+	0xCB, 0xC7,       // set 0,a
+	0xCB, 0x87,       // res 0,a
+	0xCB, 0xFE,       // set 7,(hl)
+	0xCB, 0xBE,       // res 7,(hl)
+	0x18, 0xDE,       // jr loop
+};
+
+static const byte prog_jump[] = {
+	0xF3,             // 0150 di
+	0x31, 0xF0, 0xDF, // 0151 ld sp,0xDFF0
+	0xCD, 0x80, 0x01, // 0154 loop: call sub
+	0xAF,             // 0157 xor a
+	0x20, 0x02,       // 0158 jr nz,+2      not taken
+	0x28, 0x00,       // 015A jr z,+0       taken
+	0xC2, 0x54, 0x01, // 015C jp nz,loop    not taken
+	0xCA, 0x62, 0x01, // 015F jp z,0x0162   taken
+	0x3C,             // 0162 inc a
+	0xC4, 0x80, 0x01, // 0163 call nz,sub   taken
+	0xCC, 0x80, 0x01, // 0166 call z,sub    not taken
+	0xC7,             // 0169 rst 00
+	0x21, 0x54, 0x01, // 016A ld hl,loop
+	0xE9,             // 016D jp (hl)
+	0x00, 0x00,       // 016E
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0170
+	0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, // 0178
+	0xC0,             // 0180 sub: ret nz
+	0xC9,             // 0181 ret
+};
+
+static void bench_exec(bench_state& st, const byte* prog, size_t size)
+{
+	fixture_gb f(FIXTURE_CGB, prog, size, false, false);
+	cpu* c = f->get_cpu();
+	while (st.keep_running())
+		c->exec(EXEC_CLOCKS);
+	bench_keep(c->get_regs()->AF.w + c->get_regs()->PC);
+	st.set_items(EXEC_CLOCKS, "clk");
+}
+
+static void bench_exec_alu(bench_state& st) { bench_exec(st, prog_alu, sizeof(prog_alu)); }
+static void bench_exec_load(bench_state& st) { bench_exec(st, prog_load, sizeof(prog_load)); }
+static void bench_exec_cb(bench_state& st) { bench_exec(st, prog_cb, sizeof(prog_cb)); }
+static void bench_exec_jump(bench_state& st) { bench_exec(st, prog_jump, sizeof(prog_jump)); }
+
+BENCH(bench_exec_alu, "cpu/exec/alu", 0);
+BENCH(bench_exec_load, "cpu/exec/load", 0);
+BENCH(bench_exec_cb, "cpu/exec/cb", 0);
+BENCH(bench_exec_jump, "cpu/exec/jump", 0);
+
+// 256 reads spread over one region per operation
+static const word read_regions[] = {
+	0x0000, // ROM bank 0
+	0x4000, // switchable ROM
+	0x8000, // VRAM
+	0xA000, // cartridge RAM (MBC5, enabled)
+	0xC000, // WRAM bank 0
+	0xD000, // switchable WRAM
+	0xE000, // echo RAM
+	0xFE00, // OAM
+	0xFF00, // I/O registers
+	0xFF80, // HRAM
+};
+
+static void bench_read_direct(bench_state& st)
+{
+	static const byte idle[] = { 0xF3, 0x18, 0xFE }; // di; jr $
+	fixture_gb f(FIXTURE_CGB_MBC5, idle, sizeof(idle), false, false);
+	cpu* c = f->get_cpu();
+	f.write(0x0000, 0x0A); // RAM enable
+	f.write(0xFF70, 0x03); // WRAM bank 3
+
+	word base = read_regions[st.get_arg()];
+	// OAM・I/O・HRAM は狭い // OAM, I/O and HRAM are small
+	int span = base == 0xFE00 ? 0xA0 : base == 0xFF80 ? 0x7F : base == 0xFF00 ? 0x80 : 0x1000;
+
+	word adr[256];
+	for (int i = 0; i < 256; i++)
+		adr[i] = (word)(base + (i * 97) % span);
+
+	dword sum = 0;
+	while (st.keep_running())
+	{
+		for (int i = 0; i < 256; i++)
+			sum += c->read_direct(adr[i]);
+	}
+	bench_keep(sum);
+	st.set_items(256, "rd");
+}
+
+BENCH(bench_read_direct, "cpu/read_direct/0_rom0", 0);
+BENCH(bench_read_direct, "cpu/read_direct/1_romx", 1);
+BENCH(bench_read_direct, "cpu/read_direct/2_vram", 2);
+BENCH(bench_read_direct, "cpu/read_direct/3_sram", 3);
+BENCH(bench_read_direct, "cpu/read_direct/4_wram0", 4);
+BENCH(bench_read_direct, "cpu/read_direct/5_wramx", 5);
+BENCH(bench_read_direct, "cpu/read_direct/6_echo", 6);
+BENCH(bench_read_direct, "cpu/read_direct/7_oam", 7);
+BENCH(bench_read_direct, "cpu/read_direct/8_io", 8);
+BENCH(bench_read_direct, "cpu/read_direct/9_hram", 9);
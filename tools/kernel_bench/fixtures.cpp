@@ -0,0 +1,181 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   kernel_bench: synthetic fixtures
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "fixtures.hpp"
+
+#include <cstring>
+
+std::vector<byte> fixture_rom(const fixture_cart& cart, const byte* prog, size_t prog_size)
+{
+	std::vector<byte> rom(0x8000, 0x00);
+	static const byte entry[] = { 0x00, 0xC3, 0x50, 0x01 }; // nop; jp 0x0150
+	memcpy(&rom[0x100], entry, sizeof(entry));
+	memcpy(&rom[0x134], "KERNELBENCH", 11);
+	rom[0x143] = cart.gbc ? 0x80 : 0x00;
+	rom[0x147] = cart.cart_type;
+	rom[0x148] = 0x00;
+	rom[0x149] = cart.ram_size;
+
+	byte sum = 0;
+	for (int i = 0x134; i < 0x14D; i++)
+		sum = sum - rom[i] - 1;
+	rom[0x14D] = sum;
+
+	rom[0x0000] = 0xC9; // RST 00: ret
+	if (prog_size > 0x8000 - 0x150)
+		prog_size = 0x8000 - 0x150;
+	memcpy(&rom[0x150], prog, prog_size);
+	return rom;
+}
+
+fixture_gb::fixture_gb(const fixture_cart& cart, const byte* prog, size_t prog_size, bool b_lcd, bool b_apu)
+{
+	rom = fixture_rom(cart, prog, prog_size);
+	g.reset(new gb(&render, b_lcd, b_apu));
+	g->load_rom(rom.data(), (int)rom.size(), NULL, 0, true);
+}
+
+fixture_gb::~fixture_gb()
+{
+	g.reset();
+}
+
+void fixture_gb::fill(word adr, const byte* src, int len)
+{
+	for (int i = 0; i < len; i++)
+		write((word)(adr + i), src[i]);
+}
+
+static void fill_random(fixture_gb& f, fixture_random& r, word adr, int len)
+{
+	for (int i = 0; i < len; i++)
+		f.write((word)(adr + i), r.next());
+}
+
+static void scene_sprites(fixture_gb& f, bool gbc, bool tall_sprites)
+{
+	// 4 段 x 10 個、1 ラインに 10 個並ぶ // four rows of ten, ten sprites on every covered line
+	for (int i = 0; i < 40; i++)
+	{
+		int row = i / 10, col = i % 10;
+		byte attr = (byte)(((col & 1) << 5) | ((row & 1) << 6) | ((i % 3 == 0) << 7));
+		if (gbc)
+			attr |= (byte)((i & 7) | ((i & 1) << 3));
+		else
+			attr |= (byte)((i & 2) << 3);
+		f.write((word)(0xFE00 + i * 4 + 0), (byte)(16 + row * 36 + col));
+		f.write((word)(0xFE00 + i * 4 + 1), (byte)(4 + col * 16));
+		f.write((word)(0xFE00 + i * 4 + 2), (byte)(i * 3));
+		f.write((word)(0xFE00 + i * 4 + 3), attr);
+	}
+
+	f.write(0xFF42, 5);  // SCY
+	f.write(0xFF43, 3);  // SCX
+	f.write(0xFF4A, 72); // WY
+	f.write(0xFF4B, 87); // WX
+	// LCD, window map 9C00, window, tiles 8000, BG map 9800, sprites, BG
+	f.write(0xFF40, (byte)(0x80 | 0x40 | 0x20 | 0x10 | (tall_sprites ? 0x04 : 0x00) | 0x02 | 0x01));
+}
+
+void fixture_cgb_scene(fixture_gb& f, bool tall_sprites)
+{
+	fixture_random r(0x6B7A);
+
+	for (int bank = 0; bank < 2; bank++)
+	{
+		f.write(0xFF4F, (byte)bank);
+		fill_random(f, r, 0x8000, 0x1800);
+	}
+
+	f.write(0xFF4F, 0);
+	for (int i = 0; i < 0x800; i++)
+	{
+		int x = i & 31, y = (i >> 5) & 31;
+		f.write((word)(0x9800 + i), (byte)(x * 7 + y * 13 + (i >> 10)));
+	}
+	f.write(0xFF4F, 1);
+	for (int i = 0; i < 0x800; i++)
+	{
+		int x = i & 31, y = (i >> 5) & 31;
+		byte attr = (byte)(((x + y) & 7) | ((x & 1) << 3) | ((y & 1) << 5) | (((x >> 1) & 1) << 6) | ((x % 5 == 0) << 7));
+		f.write((word)(0x9800 + i), attr);
+	}
+	f.write(0xFF4F, 0);
+
+	f.write(0xFF68, 0x80);
+	for (int i = 0; i < 64; i++)
+		f.write(0xFF69, r.next());
+	f.write(0xFF6A, 0x80);
+	for (int i = 0; i < 64; i++)
+		f.write(0xFF6B, r.next());
+
+	scene_sprites(f, true, tall_sprites);
+}
+
+void fixture_dmg_scene(fixture_gb& f)
+{
+	fixture_random r(0x6B7A);
+
+	fill_random(f, r, 0x8000, 0x1800);
+	for (int i = 0; i < 0x800; i++)
+	{
+		int x = i & 31, y = (i >> 5) & 31;
+		f.write((word)(0x9800 + i), (byte)(x * 7 + y * 13 + (i >> 10)));
+	}
+	f.write(0xFF47, 0xE4); // BGP
+	f.write(0xFF48, 0xD2); // OBP0
+	f.write(0xFF49, 0x1B); // OBP1
+
+	scene_sprites(f, false, false);
+}
+
+void fixture_sound(fixture_gb& f)
+{
+	static const byte regs[][2] = {
+		{ 0x26, 0x80 }, { 0x24, 0x77 }, { 0x25, 0xFF },
+		// square with sweep, square, both at full volume without envelope
+		{ 0x10, 0x15 }, { 0x11, 0x80 }, { 0x12, 0xF0 }, { 0x13, 0x00 }, { 0x14, 0x87 },
+		{ 0x16, 0x40 }, { 0x17, 0xF0 }, { 0x18, 0x80 }, { 0x19, 0x86 },
+		// wave, turned off while the pattern is written below
+		{ 0x1A, 0x00 },
+	};
+	static const byte regs2[][2] = {
+		{ 0x1A, 0x80 }, { 0x1B, 0x00 }, { 0x1C, 0x20 }, { 0x1D, 0x40 }, { 0x1E, 0x85 },
+		// noise, 7 bit LFSR
+		{ 0x20, 0x00 }, { 0x21, 0xF0 }, { 0x22, 0x5D }, { 0x23, 0x80 },
+	};
+
+	for (size_t i = 0; i < sizeof(regs) / sizeof(regs[0]); i++)
+		f.write((word)(0xFF00 | regs[i][0]), regs[i][1]);
+	fixture_random r(0x50DA);
+	fill_random(f, r, 0xFF30, 16);
+	for (size_t i = 0; i < sizeof(regs2) / sizeof(regs2[0]); i++)
+		f.write((word)(0xFF00 | regs2[i][0]), regs2[i][1]);
+}
+
+const byte fixture_serial_slave[] = {
+	0xF3,             // di
+	0x3E, 0x80,       // loop: ld a,0x80
+	0xE0, 0x02,       // ldh (SC),a
+	0xAF,             // xor a
+	0xE0, 0x0F,       // ldh (IF),a
+	0x18, 0xF7,       // jr loop
+};
+const size_t fixture_serial_slave_size = sizeof(fixture_serial_slave);
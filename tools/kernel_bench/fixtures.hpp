@@ -0,0 +1,88 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   kernel_bench: synthetic fixtures
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#pragma once
+#include <cores/GB/TGBDual/gb.h>
+#include <cores/GB/TGBDual/movie.h>
+
+#include <memory>
+#include <vector>
+
+// Everything a kernel runs on is built here from code, no ROM or state
+// files: the same binary always measures the same work.
+
+// fixed sequence for scene data, the same on every platform
+class fixture_random
+{
+public:
+	fixture_random(dword seed) { state = seed; }
+	byte next() { state = state * 1103515245 + 12345; return (byte)(state >> 16); }
+
+private:
+	dword state;
+};
+
+struct fixture_cart {
+	bool gbc;
+	byte cart_type;  // 0x147, 0x00 plain ROM, 0x1B MBC5+RAM+BATTERY
+	byte ram_size;   // 0x149, 0x03 = 32KB
+};
+
+static const fixture_cart FIXTURE_DMG = { false, 0x00, 0x00 };
+static const fixture_cart FIXTURE_CGB = { true, 0x00, 0x00 };
+static const fixture_cart FIXTURE_CGB_MBC5 = { true, 0x1B, 0x03 };
+
+// One instance without a frontend. The program is copied to 0x0150 and
+// entered with interrupts as the boot ROM leaves them; programs start with DI.
+class fixture_gb
+{
+public:
+	fixture_gb(const fixture_cart& cart, const byte* prog, size_t prog_size, bool b_lcd = true, bool b_apu = true);
+	~fixture_gb();
+
+	gb* get() { return g.get(); }
+	gb* operator->() { return g.get(); }
+
+	// through cpu::write, so every cache of the core sees the change
+	void write(word adr, byte dat) { g->get_cpu()->write(adr, dat); }
+	void fill(word adr, const byte* src, int len);
+
+private:
+	std::vector<byte> rom;
+	headless_renderer render;
+	std::unique_ptr<gb> g;
+};
+
+// 32KB header-valid image around 'prog'; rom[0] is RET so RST 00 returns
+std::vector<byte> fixture_rom(const fixture_cart& cart, const byte* prog, size_t prog_size);
+
+// a busy CGB screen: random tiles in both banks, maps with every attribute
+// bit in use, random palettes, 40 sprites ten to a line, window in the middle
+void fixture_cgb_scene(fixture_gb& f, bool tall_sprites);
+// the same layout with DMG palettes and no attributes
+void fixture_dmg_scene(fixture_gb& f);
+
+// all four sound channels playing with length counters off
+void fixture_sound(fixture_gb& f);
+
+// idle loop that keeps SC at 0x80 (external clock, transfer pending)
+// and clears IF, so a link master always finds the instance ready
+extern const byte fixture_serial_slave[];
+extern const size_t fixture_serial_slave_size;
@@ -0,0 +1,73 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   kernel_bench: lcd::render on canned VRAM/OAM scenes
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "bench.hpp"
+#include "fixtures.hpp"
+
+// arg: layers drawn, bit 0 BG, bit 1 window, bit 2 sprites, bit 3 8x16 sprites.
+// With one layer only, render() goes through the per layer path, so
+// bg_render_color and sprite_render_color are timed on their own.
+enum {
+	LAYER_BG = 1,
+	LAYER_WIN = 2,
+	LAYER_OBJ = 4,
+	TALL_OBJ = 8,
+};
+
+static void render_frames(bench_state& st, fixture_gb& f)
+{
+	static word frame[160 * 144];
+	lcd* l = f->get_lcd();
+	for (int i = 0; i < 3; i++)
+		l->set_enable(i, (st.get_arg() >> i) & 1);
+
+	while (st.keep_running())
+	{
+		l->clear_win_count();
+		for (int line = 0; line < 144; line++)
+			l->render(frame, line);
+	}
+	bench_keep(frame[160 * 72 + 80]);
+	st.set_items(144, "line");
+}
+
+static void bench_lcd_cgb(bench_state& st)
+{
+	static const byte idle[] = { 0xF3, 0x18, 0xFE }; // di; jr $
+	fixture_gb f(FIXTURE_CGB, idle, sizeof(idle), true, false);
+	fixture_cgb_scene(f, (st.get_arg() & TALL_OBJ) != 0);
+	render_frames(st, f);
+}
+
+static void bench_lcd_dmg(bench_state& st)
+{
+	static const byte idle[] = { 0xF3, 0x18, 0xFE };
+	fixture_gb f(FIXTURE_DMG, idle, sizeof(idle), true, false);
+	fixture_dmg_scene(f);
+	render_frames(st, f);
+}
+
+BENCH(bench_lcd_cgb, "lcd/cgb/bg", LAYER_BG);
+BENCH(bench_lcd_cgb, "lcd/cgb/window", LAYER_WIN);
+BENCH(bench_lcd_cgb, "lcd/cgb/sprites", LAYER_OBJ);
+BENCH(bench_lcd_cgb, "lcd/cgb/sprites_8x16", LAYER_OBJ | TALL_OBJ);
+BENCH(bench_lcd_cgb, "lcd/cgb/all", LAYER_BG | LAYER_WIN | LAYER_OBJ);
+BENCH(bench_lcd_dmg, "lcd/dmg/bg", LAYER_BG);
+BENCH(bench_lcd_dmg, "lcd/dmg/all", LAYER_BG | LAYER_WIN | LAYER_OBJ);
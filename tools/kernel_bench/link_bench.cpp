@@ -0,0 +1,116 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   kernel_bench: dmg07::process and the printer's data packets
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "bench.hpp"
+#include "fixtures.hpp"
+#include "../../src/cores/GB/common/linkcable/include/dmg07.hpp"
+#include "../../src/cores/GB/common/linkcable/include/gameboy_printer.hpp"
+
+extern int emulated_gbs;
+
+// Four instances on one adapter. arg 0: nobody has a transfer pending, so
+// every call is the readiness check. arg 1: all four idle as ready slaves;
+// the instances run one transfer slot with the timer paused, then one
+// process() call does a ping phase transfer.
+static void bench_dmg07(bench_state& st)
+{
+	static const byte idle[] = { 0xF3, 0x18, 0xFE }; // di; jr $
+	bool transfer = st.get_arg() != 0;
+
+	std::vector<std::unique_ptr<fixture_gb>> f;
+	std::vector<gb*> gbs;
+	for (int i = 0; i < 4; i++)
+	{
+		if (transfer)
+			f.emplace_back(new fixture_gb(FIXTURE_DMG, fixture_serial_slave, fixture_serial_slave_size, false, false));
+		else
+			f.emplace_back(new fixture_gb(FIXTURE_DMG, idle, sizeof(idle), false, false));
+		gbs.push_back(f[i]->get());
+	}
+
+	int saved_gbs = emulated_gbs;
+	emulated_gbs = 4;
+	{
+		dmg07 adapter(gbs);
+		while (st.keep_running())
+		{
+			if (transfer)
+			{
+				st.pause();
+				for (int i = 0; i < 4; i++)
+					gbs[i]->get_cpu()->exec(512 * 8);
+				st.resume();
+			}
+			adapter.process();
+		}
+	}
+	emulated_gbs = saved_gbs;
+	st.set_items(1, "call");
+}
+
+BENCH(bench_dmg07, "link/dmg07/idle", 0);
+BENCH(bench_dmg07, "link/dmg07/ping", 1);
+
+static void printer_packet(std::vector<byte>& out, byte command, const byte* data, int len)
+{
+	out.push_back(0x88);
+	out.push_back(0x33);
+	word sum = command;
+	out.push_back(command);
+	out.push_back(0x00); // not compressed
+	out.push_back((byte)(len & 0xFF));
+	out.push_back((byte)(len >> 8));
+	sum += (len & 0xFF) + (len >> 8);
+	for (int i = 0; i < len; i++)
+	{
+		out.push_back(data[i]);
+		sum += data[i];
+	}
+	out.push_back((byte)(sum & 0xFF));
+	out.push_back((byte)(sum >> 8));
+	out.push_back(0x00);
+	out.push_back(0x00);
+}
+
+// an init packet and one full data packet (two tile rows) per operation,
+// byte by byte as the link cable hands them over; data_process() decodes the strip
+static void bench_printer_data(bench_state& st)
+{
+	byte tiles[640];
+	fixture_random r(0x9B17);
+	for (int i = 0; i < 640; i++)
+		tiles[i] = r.next();
+
+	std::vector<byte> stream;
+	printer_packet(stream, 0x01, NULL, 0);
+	printer_packet(stream, 0x04, tiles, sizeof(tiles));
+
+	gameboy_printer printer;
+	dword sum = 0;
+	while (st.keep_running())
+	{
+		for (size_t i = 0; i < stream.size(); i++)
+			sum += printer.receive_from_linkcable(stream[i]);
+	}
+	bench_keep(sum);
+	st.set_items(stream.size(), "B");
+}
+
+BENCH(bench_printer_data, "link/printer/data", 0);
@@ -0,0 +1,135 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   kernel_bench: micro-benchmarks of the emulator's hot kernels
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "bench.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+std::vector<bench_entry>& bench_registry()
+{
+	static std::vector<bench_entry> entries;
+	return entries;
+}
+
+static volatile uint64_t kept;
+
+void bench_keep(uint64_t value)
+{
+	kept = kept + value;
+}
+
+struct bench_result {
+	uint64_t iterations;
+	double median_ns;
+	double min_ns;
+	uint64_t items;
+	const char* unit;
+};
+
+// iterations grow until one run takes min_time, then that count is repeated
+static bench_result measure(const bench_entry& e, double min_time, int repetitions)
+{
+	uint64_t iterations = 1;
+	for (;;)
+	{
+		bench_state st(iterations, e.arg);
+		e.fn(st);
+		double sec = st.get_seconds();
+		if (sec >= min_time || iterations >= (1ull << 40))
+			break;
+		// 10% 余分に、ただし一度に 10 倍まで // aim 10% past min_time, at most 10x per step
+		double grow = sec > 0 ? min_time * 1.1 / sec : 10.0;
+		uint64_t next = (uint64_t)(iterations * std::min(std::max(grow, 1.5), 10.0));
+		iterations = next > iterations ? next : iterations + 1;
+	}
+
+	std::vector<double> ns;
+	bench_result r = { iterations, 0, 0, 0, NULL };
+	for (int i = 0; i < repetitions; i++)
+	{
+		bench_state st(iterations, e.arg);
+		e.fn(st);
+		ns.push_back(st.get_seconds() * 1e9 / iterations);
+		r.items = st.get_items();
+		r.unit = st.get_unit();
+	}
+	std::sort(ns.begin(), ns.end());
+	r.median_ns = ns[ns.size() / 2];
+	r.min_ns = ns[0];
+	return r;
+}
+
+// usage: kernel_bench [--filter=<substring>] [--min-time=<seconds>] [--repetitions=<n>] [--list]
+int main(int argc, char** argv)
+{
+	const char* filter = "";
+	double min_time = 0.5;
+	int repetitions = 5;
+	bool list = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (!strncmp(argv[i], "--filter=", 9))
+			filter = argv[i] + 9;
+		else if (!strncmp(argv[i], "--min-time=", 11))
+			min_time = atof(argv[i] + 11);
+		else if (!strncmp(argv[i], "--repetitions=", 14))
+			repetitions = std::max(1, atoi(argv[i] + 14));
+		else if (!strcmp(argv[i], "--list"))
+			list = true;
+		else
+		{
+			fprintf(stderr, "usage: %s [--filter=<substring>] [--min-time=<seconds>] [--repetitions=<n>] [--list]\n", argv[0]);
+			return 2;
+		}
+	}
+
+	std::vector<bench_entry> entries = bench_registry();
+	std::sort(entries.begin(), entries.end(), [](const bench_entry& a, const bench_entry& b) { return a.name < b.name; });
+
+	if (!list)
+		printf("%-36s %12s %12s %12s %16s\n", "kernel", "iterations", "median ns", "min ns", "throughput");
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		if (!strstr(entries[i].name.c_str(), filter))
+			continue;
+		if (list)
+		{
+			printf("%s\n", entries[i].name.c_str());
+			continue;
+		}
+
+		bench_result r = measure(entries[i], min_time, repetitions);
+		char throughput[32] = "";
+		if (r.items && r.median_ns > 0)
+		{
+			double per_sec = r.items * 1e9 / r.median_ns;
+			if (per_sec >= 1e6)
+				snprintf(throughput, sizeof(throughput), "%.2f M%s/s", per_sec / 1e6, r.unit);
+			else
+				snprintf(throughput, sizeof(throughput), "%.2f k%s/s", per_sec / 1e3, r.unit);
+		}
+		printf("%-36s %12llu %12.1f %12.1f %16s\n", entries[i].name.c_str(), (unsigned long long)r.iterations, r.median_ns, r.min_ns, throughput);
+		fflush(stdout);
+	}
+	return 0;
+}
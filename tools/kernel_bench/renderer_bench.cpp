@@ -0,0 +1,71 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   kernel_bench: dmy_renderer::map_color
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "bench.hpp"
+
+#include <cores/GB/TGBDual/dmy_renderer.h>
+#include <cores/GB/TGBDual/gb.h>
+#include "libretro.h"
+
+// core options and callbacks of the libretro glue, see dmy_renderer.cpp
+extern bool gbc_color_correction_enabled;
+extern bool is_gbc_rom;
+extern enum color_correction_mode gbc_cc_mode;
+extern float light_temperature;
+extern retro_environment_t environ_cb;
+
+// a frontend that takes RGB565 and nothing else
+static bool bench_environment(unsigned cmd, void*)
+{
+	return cmd == RETRO_ENVIRONMENT_SET_PIXEL_FORMAT;
+}
+
+// every 15 bit colour once per operation
+// arg: color_correction_mode, +4 with a warm light temperature
+static void bench_map_color(bench_state& st)
+{
+	retro_environment_t saved_environ = environ_cb;
+	environ_cb = bench_environment;
+	dmy_renderer render(0);
+	environ_cb = saved_environ;
+
+	is_gbc_rom = true;
+	gbc_cc_mode = (color_correction_mode)(st.get_arg() & 3);
+	gbc_color_correction_enabled = gbc_cc_mode != OFF;
+	light_temperature = (st.get_arg() & 4) ? 0.25f : 0.0f;
+
+	dword sum = 0;
+	while (st.keep_running())
+	{
+		for (int col = 0; col < 0x8000; col++)
+			sum += render.map_color((word)col);
+	}
+	bench_keep(sum);
+	st.set_items(0x8000, "col");
+
+	gbc_color_correction_enabled = false;
+	light_temperature = 0.0f;
+}
+
+BENCH(bench_map_color, "renderer/map_color/off", OFF);
+BENCH(bench_map_color, "renderer/map_color/simple", GAMBATTE_SIMPLE);
+BENCH(bench_map_color, "renderer/map_color/accurate", GAMBATTE_ACCURATE);
+BENCH(bench_map_color, "renderer/map_color/simple_tinted", GAMBATTE_SIMPLE | 4);
+BENCH(bench_map_color, "renderer/map_color/accurate_tinted", GAMBATTE_ACCURATE | 4);
@@ -0,0 +1,58 @@
+/*--------------------------------------------------
+
+   DoubleCherryGB - Gameboy Emulator (based on TGBDual)
+   kernel_bench: savestate serializer
+
+   This program is free software; you can redistribute it and/or
+   modify it under the terms of the GNU General Public License
+   as published by the Free Software Foundation; either version 2
+   of the License, or (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program; if not, write to the Free Software
+   Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA  02111-1307, USA.
+*/
+
+#include "bench.hpp"
+#include "fixtures.hpp"
+
+// arg: bit 0 load instead of save, bit 1 CGB with MBC5 and 32KB SRAM
+static void bench_state_mem(bench_state& st)
+{
+	static const byte idle[] = { 0xF3, 0x18, 0xFE }; // di; jr $
+	bool load = (st.get_arg() & 1) != 0;
+	bool gbc = (st.get_arg() & 2) != 0;
+
+	fixture_gb f(gbc ? FIXTURE_CGB_MBC5 : FIXTURE_DMG, idle, sizeof(idle));
+	if (gbc)
+		fixture_cgb_scene(f, false);
+	else
+		fixture_dmg_scene(f);
+	fixture_sound(f);
+	// 一フレーム進めて全部の部品に中身を入れる // one frame so every part holds live state
+	for (int line = 0; line < 154; line++)
+		f->run();
+
+	std::vector<byte> buf(f->get_state_size());
+	f->save_state_mem(buf.data());
+
+	while (st.keep_running())
+	{
+		if (load)
+			f->restore_state_mem(buf.data());
+		else
+			f->save_state_mem(buf.data());
+	}
+	bench_keep(buf[buf.size() / 2]);
+	st.set_items(buf.size(), "B");
+}
+
+BENCH(bench_state_mem, "state/save/dmg", 0);
+BENCH(bench_state_mem, "state/load/dmg", 1);
+BENCH(bench_state_mem, "state/save/cgb", 2);
+BENCH(bench_state_mem, "state/load/cgb", 3);